@@ -0,0 +1,59 @@
+#include "../src/test_helper/test_helper.h"
+#include <mongory-core.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+void setUp(void) {}
+void tearDown(void) {}
+
+char *valid_statuses[] = {"active", "inactive"};
+
+static double mongory_benchmark_now(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main() {
+  srand(time(NULL));
+  mongory_init();
+
+  mongory_memory_pool *pool = mongory_memory_pool_new();
+  mongory_value *condition =
+      json_string_to_mongory_value(pool, "{\"$or\": [{\"age\": {\"$gte\": 18}}, {\"status\": \"active\"}]}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+
+  // Records are built natively: the parallel filter needs values that are safe
+  // to read from several threads, which shallow-converted records are not.
+  mongory_array *records = mongory_array_new(pool);
+  int times = 1000000;
+  for (int i = 0; i < times; i++) {
+    records->push(records, MG_TABLE_WRAP(pool, 2, "age", mongory_value_wrap_i(pool, rand() % 100 + 1), "status",
+                                         mongory_value_wrap_s(pool, valid_statuses[rand() % 2])));
+  }
+
+  printf("Starting benchmark...\n");
+  double time_start = mongory_benchmark_now();
+  size_t serial_matched = 0;
+  for (size_t i = 0; i < records->count; i++) {
+    serial_matched += matcher->match(matcher, records->get(records, i));
+  }
+  printf("Serial match: %f seconds (%zu matched)\n", mongory_benchmark_now() - time_start, serial_matched);
+
+  int thread_counts[] = {1, 2, 4, 8};
+  for (size_t i = 0; i < sizeof(thread_counts) / sizeof(thread_counts[0]); i++) {
+    mongory_memory_pool *out_pool = mongory_memory_pool_new();
+    mongory_array *out = mongory_array_new(out_pool);
+    time_start = mongory_benchmark_now();
+    mongory_matcher_filter_parallel(matcher, records, thread_counts[i], out);
+    printf("Parallel filter (%d threads): %f seconds (%zu matched)\n", thread_counts[i],
+           mongory_benchmark_now() - time_start, out->count);
+    out_pool->free(out_pool);
+  }
+  printf("Benchmark done.\n");
+
+  pool->free(pool);
+  mongory_cleanup();
+  return 0;
+}
@@ -5,8 +5,11 @@
 #include "mongory-core/foundations/config.h"
 #include "mongory-core/foundations/error.h"
 #include "mongory-core/foundations/memory_pool.h"
+#include "mongory-core/foundations/sink.h"
+#include "mongory-core/foundations/string_interner.h"
 #include "mongory-core/foundations/table.h"
 #include "mongory-core/foundations/value.h"
 #include "mongory-core/matchers/matcher.h"
+#include "mongory-core/matchers/program.h"
 
 #endif
@@ -14,6 +14,8 @@
 #include "mongory-core/foundations/memory_pool.h"
 #include "mongory-core/foundations/value.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
  * @brief Forward declaration for the mongory_array structure.
@@ -103,6 +105,82 @@ mongory_array *mongory_array_new(mongory_memory_pool *pool);
 mongory_array *mongory_array_nested_wrap(mongory_memory_pool *pool, int argc, ...);
 #define MG_ARRAY_WRAP(pool, n, ...) mongory_value_wrap_a(pool, mongory_array_nested_wrap(pool, n, __VA_ARGS__))
 
+/**
+ * @brief Ensures an array can hold `capacity` items without growing.
+ *
+ * Converters that know the length of what they build reserve it up front, so
+ * the array reaches its final size with at most one allocation instead of
+ * doubling its way there. Works on typed arrays too.
+ *
+ * @param array The array.
+ * @param capacity The number of items to make room for.
+ * @return bool True on success, false on allocation failure.
+ */
+bool mongory_array_reserve(mongory_array *array, size_t capacity);
+
+/**
+ * @brief Appends `count` values, reserving room for all of them first.
+ *
+ * Equivalent to pushing each value in turn, but grows the array at most once.
+ *
+ * @param array The array.
+ * @param values The values to append. May contain NULL.
+ * @param count The number of values.
+ * @return bool True on success, false on allocation failure.
+ */
+bool mongory_array_push_many(mongory_array *array, mongory_value **values, size_t count);
+
+/**
+ * @brief A borrowed run of string bytes: an item of a typed string array.
+ */
+typedef struct mongory_string_slice {
+  const char *s; /**< The bytes, '\0'-terminated. */
+  size_t len;    /**< Number of bytes, without the terminator. */
+} mongory_string_slice;
+
+/**
+ * @brief Creates a typed array, which stores its items unboxed.
+ *
+ * The items of a typed array of ints, doubles or strings sit in one
+ * contiguous vector of `int64_t`, `double` or `mongory_string_slice`, which
+ * the typed accessors below expose directly. `get` and `each` still return
+ * `mongory_value` pointers: an item is boxed into the array's pool the first
+ * time it is read that way, and the box is kept. Because of that, reading a
+ * typed array through `get` or `each` writes to it and is not thread-safe.
+ *
+ * Pushing or setting anything the vector cannot hold (another type, a NULL
+ * item, or a value with overridden behaviour) turns the array into an
+ * ordinary boxed array for good; the typed accessors then return NULL.
+ *
+ * @param pool The pool to allocate the array, its items and boxes from.
+ * @param item_type MONGORY_TYPE_INT, MONGORY_TYPE_DOUBLE or
+ * MONGORY_TYPE_STRING.
+ * @return The new array, or NULL on allocation failure or for another type.
+ */
+mongory_array *mongory_array_new_typed(mongory_memory_pool *pool, mongory_type item_type);
+
+/** @name Typed Push Functions
+ *  Append an item without boxing it when the array is typed for it, and
+ *  push a new value from the array's pool otherwise. `push_sn` copies the
+ *  bytes into the pool. They return false on allocation failure.
+ *  @{
+ */
+bool mongory_array_push_i(mongory_array *array, int64_t i);
+bool mongory_array_push_d(mongory_array *array, double d);
+bool mongory_array_push_sn(mongory_array *array, const char *s, size_t len);
+/** @} */
+
+/** @name Typed Accessors
+ *  Return the item vector of a typed array, `array->count` items long, or
+ *  NULL if the array is not typed for that item type. The vector moves when
+ *  the array grows.
+ *  @{
+ */
+const int64_t *mongory_array_ints(mongory_array *array);
+const double *mongory_array_doubles(mongory_array *array);
+const mongory_string_slice *mongory_array_strings(mongory_array *array);
+/** @} */
+
 /**
  * @struct mongory_array
  * @brief Represents a dynamic array of mongory_value pointers.
@@ -105,6 +105,17 @@ void mongory_init();
  */
 void mongory_cleanup();
 
+/**
+ * @brief Sets the allocator backing memory pools created without one, such as
+ * those of `mongory_memory_pool_new` and the library's own pools.
+ *
+ * Set it before creating pools, typically before `mongory_init`: every pool
+ * keeps the allocator it was created with, which must outlive it.
+ *
+ * @param allocator The allocator, or NULL to restore `malloc` and `free`.
+ */
+void mongory_allocator_set(const mongory_allocator *allocator);
+
 /**
  * @brief Sets the custom regex matching function.
  *
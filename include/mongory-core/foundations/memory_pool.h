@@ -10,6 +10,8 @@
  * library. It allows for allocating blocks of memory that can be freed
  * all at once when the pool itself is destroyed. This can reduce the overhead
  * of individual allocations and deallocations and help prevent memory leaks.
+ * Blocks that are replaced before then can be handed back with `release` and
+ * are reused for allocations of the same size class.
  */
 
 #include "mongory-core/foundations/error.h"
@@ -23,6 +25,15 @@ typedef struct mongory_memory_pool mongory_memory_pool;
 #define MG_ALLOC_PTR(p, t) ((t*)MG_ALLOC(p, sizeof(t)))
 #define MG_ALLOC_OBJ(p, t) ((t)MG_ALLOC(p, sizeof(t)))
 #define MG_ALLOC_ARY(p, t, n) ((t*)MG_ALLOC(p, sizeof(t) * (n)))
+
+/**
+ * @struct mongory_memory_pool_mark
+ * @brief An allocation position of a pool, returned by `pool->mark`. Opaque.
+ */
+typedef struct mongory_memory_pool_mark {
+  void *chunk;   /**< The chunk allocations were made from. */
+  size_t offset; /**< Bytes used in that chunk. */
+} mongory_memory_pool_mark;
 /**
  * @struct mongory_memory_pool
  * @brief Represents a memory pool for managing memory allocations.
@@ -43,6 +54,40 @@ struct mongory_memory_pool {
    */
   void *(*alloc)(mongory_memory_pool *pool, size_t size);
 
+  /**
+   * @brief Tries to grow the most recent allocation in place.
+   *
+   * Succeeds only when `ptr` is the last block handed out by `alloc` and the
+   * chunk it sits in has room for `new_size` bytes; the block then keeps its
+   * address and nothing is copied. Growable buffers try this before
+   * allocating a new block, so growing one at the tail of the pool does not
+   * abandon the old block.
+   *
+   * @param pool A pointer to the pool.
+   * @param ptr The block, as returned by `alloc`.
+   * @param old_size The size `ptr` was allocated (or last extended) with.
+   * @param new_size The requested size, larger than `old_size`.
+   * @return bool True if the block now holds `new_size` bytes, false if it is
+   * unchanged.
+   */
+  bool (*try_extend)(mongory_memory_pool *pool, void *ptr, size_t old_size, size_t new_size);
+
+  /**
+   * @brief Gives a block back to the pool before the pool is reset or freed.
+   *
+   * The block must no longer be used. The pool keeps it on a freelist for
+   * its size class and hands it out again to a later `alloc` of a size in
+   * that class, so long-lived mutable data (tables losing keys, arrays
+   * replacing their buffers) stops leaking memory into the pool. Reset and
+   * rewind drop the freelists. May be NULL in custom pools, in which case
+   * blocks are simply abandoned until the pool is reset.
+   *
+   * @param pool A pointer to the pool.
+   * @param ptr The block, as returned by `alloc`. NULL is ignored.
+   * @param size The size `ptr` was allocated (or last extended) with.
+   */
+  void (*release)(mongory_memory_pool *pool, void *ptr, size_t size);
+
   /**
    * @brief Traces an externally allocated memory block, associating it with the
    * pool.
@@ -64,6 +109,28 @@ struct mongory_memory_pool {
    */
   void (*reset)(mongory_memory_pool *pool);
 
+  /**
+   * @brief Records the current allocation position, to roll back to it later
+   * with `rewind`.
+   * @param pool A pointer to the pool.
+   * @return mongory_memory_pool_mark The position.
+   */
+  mongory_memory_pool_mark (*mark)(mongory_memory_pool *pool);
+
+  /**
+   * @brief Rolls the pool back to a position recorded by `mark`, in constant
+   * time.
+   *
+   * Everything allocated since the mark is given back to the pool and must
+   * no longer be used. Marks nest: rewinding to a mark invalidates the marks
+   * taken after it. Traced external memory is not affected.
+   *
+   * @param pool A pointer to the pool.
+   * @param mark A position returned by `mark` on this pool, since its last
+   * reset.
+   */
+  void (*rewind)(mongory_memory_pool *pool, mongory_memory_pool_mark mark);
+
   /**
    * @brief Frees the entire memory pool, including all memory blocks allocated
    * from it and any traced memory blocks (depending on implementation).
@@ -80,11 +147,34 @@ struct mongory_memory_pool {
                            is a static error object. */
 };
 
+/**
+ * @struct mongory_allocator
+ * @brief The memory a pool is built on: its chunks, its own structure and the
+ * nodes tracing external memory.
+ *
+ * Pools keep a pointer to the allocator they were created with, so it must
+ * outlive them. Only pools on the default system allocator share chunks
+ * through the per-thread cache or map large chunks directly.
+ */
+typedef struct mongory_allocator {
+  /**
+   * @brief Allocates `size` bytes, suitably aligned for any type.
+   * @return The memory, or NULL on failure.
+   */
+  void *(*alloc)(void *ctx, size_t size);
+  /**
+   * @brief Frees memory returned by `alloc`.
+   * @param size The size it was allocated with.
+   */
+  void (*free)(void *ctx, void *ptr, size_t size);
+  void *ctx; /**< Passed to `alloc` and `free`. */
+} mongory_allocator;
+
 /**
  * @brief Creates a new mongory_memory_pool instance.
  *
  * Initializes the pool structure and its internal context, preparing it for
- * allocations.
+ * allocations. The pool is backed by the default allocator.
  *
  * @return mongory_memory_pool* A pointer to the newly created memory pool, or
  * NULL if creation fails (e.g., initial memory allocation for the pool's
@@ -92,4 +182,41 @@ struct mongory_memory_pool {
  */
 mongory_memory_pool *mongory_memory_pool_new();
 
+/**
+ * @brief Creates a new memory pool on a given allocator.
+ *
+ * @param allocator The allocator backing the pool, or NULL for the default
+ * one (see `mongory_allocator_set`).
+ * @return mongory_memory_pool* The pool, or NULL if creation fails.
+ */
+mongory_memory_pool *mongory_memory_pool_new_with_allocator(const mongory_allocator *allocator);
+
+/**
+ * @brief Creates a memory pool inside a caller-provided buffer, typically on
+ * the stack or in a per-thread static block.
+ *
+ * The pool structure takes the first bytes of the buffer, under 200 bytes on
+ * 64-bit platforms, and the rest is the pool's first chunk. Allocations that
+ * fit involve no heap at all; once the buffer is full the pool grows into
+ * chunks from the default allocator, like any other pool. `pool->free` gives
+ * those back and leaves the buffer to its owner, which must keep it alive
+ * and unmoved until then.
+ *
+ * @param buffer The buffer.
+ * @param size The size of `buffer` in bytes.
+ * @return mongory_memory_pool* The pool, located in `buffer`, or NULL if the
+ * buffer is too small to hold a pool.
+ */
+mongory_memory_pool *mongory_memory_pool_init_with_buffer(void *buffer, size_t size);
+
+/**
+ * @brief Frees the chunks and pool structures cached by the calling thread.
+ *
+ * Freed pools leave their chunks in a small per-thread cache so that the next
+ * pool created on the thread can reuse them. The cache is released when the
+ * thread exits; call this to release it earlier, e.g. before a long idle
+ * period. `mongory_cleanup` calls it for the calling thread.
+ */
+void mongory_memory_pool_cache_clear(void);
+
 #endif /* MONGORY_MEMORY_POOL */
@@ -0,0 +1,157 @@
+#ifndef MONGORY_SINK_H
+#define MONGORY_SINK_H
+
+/**
+ * @file sink.h
+ * @brief Defines output sinks and the streaming value serializer.
+ *
+ * A sink is a destination for bytes: a callback, a `FILE *`, a file
+ * descriptor or a caller-owned fixed buffer. `mongory_value_serialize` writes
+ * a value to a sink in one pass, without building intermediate strings, and
+ * matcher explanations and traces can be written to a sink as well
+ * (`mongory_matcher_explain_to_sink`, `mongory_matcher_print_trace_to_sink`).
+ * `mongory_value_to_str` is itself a sink writing into a pool string.
+ *
+ * Once a write fails the sink is marked `failed` and ignores every later
+ * write, so a serializer can write a whole value and check the sink once.
+ */
+
+#include "mongory-core/foundations/memory_pool.h"
+#include "mongory-core/foundations/value.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Forward declaration of the mongory_sink structure.
+struct mongory_sink;
+/**
+ * @brief Alias for `struct mongory_sink`.
+ */
+typedef struct mongory_sink mongory_sink;
+
+/**
+ * @brief Function receiving the bytes written to a sink.
+ * @param sink The sink.
+ * @param data The bytes. Not '\0'-terminated.
+ * @param len The number of bytes.
+ * @return True if every byte was accepted, false otherwise.
+ */
+typedef bool (*mongory_sink_write_func)(mongory_sink *sink, const char *data, size_t len);
+
+/**
+ * @struct mongory_sink
+ * @brief A byte destination. Initialize it with one of the `*_init`
+ * functions; the fields are public so that custom sinks can be built on them.
+ */
+struct mongory_sink {
+  mongory_sink_write_func write; /**< Receives the bytes. */
+  void *ctx;                     /**< Callback context, or the `FILE *`. */
+  int fd;                        /**< File descriptor of a descriptor sink. */
+  char *buffer;                  /**< Storage of a fixed-buffer sink. */
+  size_t capacity;               /**< Size of `buffer` in bytes. */
+  size_t size;                   /**< Number of bytes written so far. */
+  bool failed;                   /**< A write failed; later writes are ignored. */
+  mongory_memory_pool *pool;     /**< Optional scratch pool, used for `to_str`
+                                    overrides and regex stringification. A
+                                    temporary pool is used when NULL. */
+};
+
+/**
+ * @brief Initializes a sink calling `write` for every chunk of output.
+ * @param sink The sink to initialize.
+ * @param write The callback.
+ * @param ctx Stored in `sink->ctx` for the callback.
+ */
+void mongory_sink_init(mongory_sink *sink, mongory_sink_write_func write, void *ctx);
+
+/**
+ * @brief Initializes a sink writing to a stdio stream. The stream's own
+ * buffering applies.
+ * @param sink The sink to initialize.
+ * @param file The stream.
+ */
+void mongory_sink_file_init(mongory_sink *sink, FILE *file);
+
+/**
+ * @brief Initializes a sink writing to a file descriptor with `write(2)`.
+ * Writes are unbuffered.
+ * @param sink The sink to initialize.
+ * @param fd The file descriptor.
+ */
+void mongory_sink_fd_init(mongory_sink *sink, int fd);
+
+/**
+ * @brief Initializes a sink writing into a caller-owned buffer.
+ *
+ * The buffer is kept '\0'-terminated. Output that does not fit is dropped
+ * and marks the sink failed, leaving the buffer holding a truncated prefix.
+ * @param sink The sink to initialize.
+ * @param buffer The buffer.
+ * @param capacity The size of `buffer`, terminator included. Must be at
+ * least 1.
+ */
+void mongory_sink_buffer_init(mongory_sink *sink, char *buffer, size_t capacity);
+
+/**
+ * @brief Writes bytes to a sink.
+ * @param sink The sink.
+ * @param data The bytes.
+ * @param len The number of bytes.
+ * @return False if the sink has failed, true otherwise.
+ */
+bool mongory_sink_write(mongory_sink *sink, const char *data, size_t len);
+
+/**
+ * @brief Writes a '\0'-terminated string to a sink, unquoted.
+ * @param sink The sink.
+ * @param str The string.
+ * @return False if the sink has failed, true otherwise.
+ */
+bool mongory_sink_puts(mongory_sink *sink, const char *str);
+
+/**
+ * @brief Writes an integer in decimal.
+ * @param sink The sink.
+ * @param i The integer.
+ * @return False if the sink has failed, true otherwise.
+ */
+bool mongory_sink_write_int(mongory_sink *sink, int64_t i);
+
+/**
+ * @brief Writes a double as a JSON number.
+ *
+ * Integral values print with a trailing ".0". Other values print with the
+ * fewest of 15 or 17 significant digits that read back as the same double.
+ * NaN and the infinities, which JSON cannot represent, print as `null`.
+ * @param sink The sink.
+ * @param d The double.
+ * @return False if the sink has failed, true otherwise.
+ */
+bool mongory_sink_write_double(mongory_sink *sink, double d);
+
+/**
+ * @brief Writes bytes as a quoted JSON string, escaping quotes, backslashes
+ * and control characters.
+ * @param sink The sink.
+ * @param s The bytes. May contain '\0'.
+ * @param len The number of bytes.
+ * @return False if the sink has failed, true otherwise.
+ */
+bool mongory_sink_write_string(mongory_sink *sink, const char *s, size_t len);
+
+/**
+ * @brief Serializes a value to a sink.
+ *
+ * Null, booleans, numbers, strings, arrays and tables are written as JSON.
+ * Regexes are written through the configured regex stringify function, and
+ * other pointers as their address. Unless values are compact, a value whose
+ * `to_str` is overridden is written as the override's result.
+ * @param value The value.
+ * @param sink The sink.
+ * @return False if the value is invalid or the sink has failed, true
+ * otherwise.
+ */
+bool mongory_value_serialize(mongory_value *value, mongory_sink *sink);
+
+#endif /* MONGORY_SINK_H */
@@ -0,0 +1,61 @@
+#ifndef MONGORY_STRING_INTERNER_H
+#define MONGORY_STRING_INTERNER_H
+
+/**
+ * @file string_interner.h
+ * @brief Defines the string interner, which keeps one copy of each distinct
+ * string and wraps it as interned string values.
+ *
+ * Interned values carry their string's hash and point at the interner's
+ * single copy of the bytes. Two values interned by the same interner are
+ * equal exactly when they point at the same bytes, so comparing them for
+ * equality is a pointer compare, and hashing them (as `$in` does) reads the
+ * stored hash. Document converters can intern enum-like strings such as
+ * status or country codes, and condition values can be interned with the
+ * same interner to make `$eq` and `$in` on them nearly free.
+ *
+ * An interner is not thread-safe. Its strings live as long as its pool.
+ */
+
+#include "mongory-core/foundations/memory_pool.h"
+#include "mongory-core/foundations/value.h"
+#include <stddef.h>
+
+// Forward declaration of the mongory_string_interner structure.
+struct mongory_string_interner;
+/**
+ * @brief Alias for `struct mongory_string_interner`.
+ */
+typedef struct mongory_string_interner mongory_string_interner;
+
+/**
+ * @brief Creates an empty string interner.
+ * @param pool The pool holding the interner and every interned string.
+ * @return The new interner, or NULL on allocation failure.
+ */
+mongory_string_interner *mongory_string_interner_new(mongory_memory_pool *pool);
+
+/**
+ * @brief Interns `len` bytes and wraps them as an interned string value.
+ *
+ * The bytes are copied into the interner the first time they are seen. The
+ * value itself is allocated from `pool`, which may be a short-lived pool
+ * such as a per-record one, as long as the interner outlives it.
+ *
+ * @param interner The interner.
+ * @param pool The pool to allocate the value from.
+ * @param s The string bytes. Need not be '\0'-terminated.
+ * @param len The number of bytes.
+ * @return The interned string value, or NULL on failure.
+ */
+mongory_value *mongory_string_interner_wrap(mongory_string_interner *interner, mongory_memory_pool *pool,
+                                            const char *s, size_t len);
+
+/**
+ * @brief Returns the number of distinct strings in the interner.
+ * @param interner The interner.
+ * @return The number of interned strings.
+ */
+size_t mongory_string_interner_count(mongory_string_interner *interner);
+
+#endif /* MONGORY_STRING_INTERNER_H */
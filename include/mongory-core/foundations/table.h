@@ -10,6 +10,10 @@
  * pointers. It uses a mongory_memory_pool for its allocations and handles
  * operations like get, set, delete, and iteration over key-value pairs.
  * The table automatically resizes (rehashes) when its load factor is exceeded.
+ * It is an open-addressing table with a power-of-two number of slots, each
+ * slot storing the key's full hash and length next to the key. Tables of up
+ * to eight keys skip the hashing layout: they keep their slots in a flat
+ * array, in insertion order, until a ninth key arrives.
  */
 
 #include "mongory-core/foundations/array.h" // Used internally by the table
@@ -17,6 +21,7 @@
 #include "mongory-core/foundations/value.h"
 #include <stdbool.h>
 #include <stddef.h> // For size_t
+#include <stdint.h> // For uint64_t
 
 // Forward declaration of the mongory_table structure.
 struct mongory_table;
@@ -43,6 +48,20 @@ typedef bool (*mongory_table_each_pair_callback_func)(char *key, mongory_value *
  */
 typedef mongory_value *(*mongory_table_get_func)(mongory_table *self, char *key);
 
+/**
+ * @brief Function pointer type for retrieving a value by a key whose length
+ * and hash are already known.
+ * Lets callers that look up the same key many times, like field matchers, skip
+ * measuring and hashing it on every call.
+ * @param self A pointer to the mongory_table instance.
+ * @param key The null-terminated string key.
+ * @param key_len The length of `key`, without the terminator.
+ * @param hash `mongory_table_hash_key(key, key_len)`.
+ * @return mongory_value* A pointer to the mongory_value associated with the
+ * key, or NULL if the key is not found.
+ */
+typedef mongory_value *(*mongory_table_get_hashed_func)(mongory_table *self, char *key, size_t key_len, uint64_t hash);
+
 /**
  * @brief Function pointer type for setting (adding or updating) a key-value
  * pair.
@@ -86,6 +105,47 @@ typedef bool (*mongory_table_del_func)(mongory_table *self, char *key);
  */
 mongory_table *mongory_table_new(mongory_memory_pool *pool);
 
+/**
+ * @brief Creates a new mongory_table instance sized to hold `capacity` pairs
+ * without rehashing.
+ * Useful when the number of keys is known up front, e.g. when converting a
+ * document of known width.
+ * @param pool A pointer to the mongory_memory_pool to be used for allocations.
+ * @param capacity The number of key-value pairs the table should hold before
+ * it first grows.
+ * @return mongory_table* A pointer to the newly created mongory_table, or NULL
+ * if creation fails (e.g., memory allocation failure).
+ */
+mongory_table *mongory_table_new_with_capacity(mongory_memory_pool *pool, size_t capacity);
+
+/**
+ * @brief Creates a new, empty shaped table.
+ * A shaped table does not store its keys: tables that receive the same keys
+ * in the same order share one interned key list (a shape) and only keep a
+ * vector of values. Field matchers remember where a field sits in the shapes
+ * they have seen, so looking a field up in a shaped table is usually a
+ * pointer comparison and an indexed load. Iteration follows insertion order.
+ * Shapes are process-wide and released by `mongory_cleanup`, so shaped tables
+ * must not outlive it. The set of shapes is bounded: a table with more than
+ * 64 keys, or one needing a new shape once 4096 exist, silently turns into a
+ * regular table and keeps working, only without the shared keys and the
+ * inline-cache fast path. Adding a key to a shaped table takes a global lock.
+ * @param pool A pointer to the mongory_memory_pool to be used for allocations.
+ * @return mongory_table* A pointer to the newly created mongory_table, or NULL
+ * if creation fails (e.g., memory allocation failure).
+ */
+mongory_table *mongory_table_new_shaped(mongory_memory_pool *pool);
+
+/**
+ * @brief Hashes a key the way mongory_table does.
+ * Callers of `get_hashed` pass this value; external table implementations may
+ * use it or ignore it.
+ * @param key The key bytes.
+ * @param key_len The number of bytes of `key`.
+ * @return uint64_t The hash of the key.
+ */
+uint64_t mongory_table_hash_key(const char *key, size_t key_len);
+
 /**
  * @brief Creates a new mongory_table instance with a nested table.
  *
@@ -111,6 +171,9 @@ mongory_table *mongory_table_nested_wrap(mongory_memory_pool *pool, int argc, ..
  * object-oriented interface. The `count` field indicates the number of
  * key-value pairs currently in the table and should be treated as read-only by
  * users of the table.
+ *
+ * `get_hashed` is optional: external implementations that cannot use a
+ * precomputed hash set it to NULL and are queried through `get`.
  */
 struct mongory_table {
   mongory_memory_pool *pool;    /**< The memory pool used for allocations. */
@@ -120,8 +183,25 @@ struct mongory_table {
   mongory_table_each_func each; /**< Function to iterate over key-value pairs. */
   mongory_table_set_func set;   /**< Function to set a key-value pair. */
   mongory_table_del_func del;   /**< Function to delete a key-value pair. */
+  mongory_table_get_hashed_func get_hashed; /**< Optional. Function to get a value by a pre-hashed key, or NULL. */
 };
 
+/**
+ * @brief Looks a key up, through `get_hashed` when the table provides it and
+ * through `get` otherwise.
+ * @param table The table to search.
+ * @param key The null-terminated string key.
+ * @param key_len The length of `key`, without the terminator.
+ * @param hash `mongory_table_hash_key(key, key_len)`.
+ * @return mongory_value* The value, or NULL if the key is not found.
+ */
+static inline mongory_value *mongory_table_get_with_hash(mongory_table *table, char *key, size_t key_len,
+                                                         uint64_t hash) {
+  if (table->get_hashed)
+    return table->get_hashed(table, key, key_len, hash);
+  return table->get(table, key);
+}
+
 mongory_table *mongory_table_merge(mongory_table *table, mongory_table *other);
 
 #endif /* MONGORY_TABLE_H */
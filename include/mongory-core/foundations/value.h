@@ -7,13 +7,14 @@
  * Mongory library.
  *
  * `mongory_value` is a tagged union that can represent various data types such
- * as null, boolean, integer, double, string, array, table, regex, pointers,
- * and an unsupported type. It includes functions for wrapping C types into
+ * as null, boolean, integer, double, string, array, table, regex, datetime,
+ * binary, pointers, and an unsupported type. It includes functions for wrapping C types into
  * `mongory_value` objects, comparing values, and converting them to strings.
  */
 
 #include "mongory-core/foundations/memory_pool.h"
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h> // For int64_t
 
 // Forward declarations for complex types that can be stored in mongory_value.
@@ -75,9 +76,23 @@ char *mongory_type_to_string(mongory_value *value);
  */
 void *mongory_value_extract(mongory_value *value);
 
+/**
+ * @def MONGORY_STRING_MAX_LEN
+ * @brief Longest string, in bytes, a mongory_value can hold.
+ */
+#define MONGORY_STRING_MAX_LEN 0x7FFFFFFFu
+
 /** @name Mongory Value Wrapper Functions
  *  Functions to create mongory_value instances from basic C types.
  *  These functions allocate a new mongory_value from the provided pool.
+ *
+ *  Strings are stored as a pointer and a byte length and are always followed
+ *  by a '\0'. `wrap_s` and `wrap_sn` copy the string into the pool; `wrap_sn`
+ *  takes the length from the caller, so the bytes may contain '\0'.
+ *  `wrap_s_borrowed` copies nothing: `s` must stay valid and unchanged for
+ *  the value's lifetime and `s[len]` must be '\0', as in cJSON or BSON
+ *  buffers. The string functions return NULL on allocation failure or when
+ *  `len` exceeds `MONGORY_STRING_MAX_LEN`.
  *  @{
  */
 mongory_value *mongory_value_wrap_n(mongory_memory_pool *pool, void *n);
@@ -85,6 +100,8 @@ mongory_value *mongory_value_wrap_b(mongory_memory_pool *pool, bool b);
 mongory_value *mongory_value_wrap_i(mongory_memory_pool *pool, int64_t i);
 mongory_value *mongory_value_wrap_d(mongory_memory_pool *pool, double d);
 mongory_value *mongory_value_wrap_s(mongory_memory_pool *pool, char *s);
+mongory_value *mongory_value_wrap_sn(mongory_memory_pool *pool, const char *s, size_t len);
+mongory_value *mongory_value_wrap_s_borrowed(mongory_memory_pool *pool, const char *s, size_t len);
 mongory_value *mongory_value_wrap_a(mongory_memory_pool *pool, struct mongory_array *a);
 mongory_value *mongory_value_wrap_t(mongory_memory_pool *pool, struct mongory_table *t);
 mongory_value *mongory_value_wrap_regex(mongory_memory_pool *pool, void *regex);
@@ -92,6 +109,52 @@ mongory_value *mongory_value_wrap_ptr(mongory_memory_pool *pool, void *ptr);
 mongory_value *mongory_value_wrap_u(mongory_memory_pool *pool, void *u);
 /** @} */
 
+/** @name Datetime and Binary Wrapper Functions
+ *  A datetime is a point in time as int64 nanoseconds since the Unix epoch,
+ *  stored in `data.i`. Datetimes compare only with datetimes, as integers.
+ *
+ *  A binary is `len` raw bytes at `data.bin`, such as a 12-byte ObjectId or
+ *  a UUID. Binaries compare only with binaries: a shorter binary sorts first,
+ *  and binaries of one length compare with `memcmp`. `wrap_binary` copies the
+ *  bytes into the pool; `wrap_binary_borrowed` copies nothing, so the bytes
+ *  must outlive the value. Both return NULL on allocation failure or when
+ *  `len` exceeds `MONGORY_STRING_MAX_LEN`.
+ *  @{
+ */
+mongory_value *mongory_value_wrap_datetime(mongory_memory_pool *pool, int64_t ns);
+mongory_value *mongory_value_wrap_binary(mongory_memory_pool *pool, const void *bin, size_t len);
+mongory_value *mongory_value_wrap_binary_borrowed(mongory_memory_pool *pool, const void *bin, size_t len);
+/** @} */
+
+/**
+ * @def MONGORY_SHARED_INT_MIN
+ * @brief Smallest int with a shared value.
+ */
+#define MONGORY_SHARED_INT_MIN (-128)
+
+/**
+ * @def MONGORY_SHARED_INT_MAX
+ * @brief Largest int with a shared value.
+ */
+#define MONGORY_SHARED_INT_MAX 1023
+
+/** @name Shared Value Functions
+ *  Drop-in replacements for `wrap_n`, `wrap_b` and `wrap_i` that return
+ *  statically allocated values instead of allocating. Null, true, false and
+ *  ints from MONGORY_SHARED_INT_MIN to MONGORY_SHARED_INT_MAX each have one
+ *  shared value; `wrap_i_shared` wraps other ints from `pool`, and returns
+ *  NULL for them if `pool` is NULL.
+ *
+ *  Shared values are shared by every thread and must never be modified,
+ *  including their `comp`, `to_str` and `origin`. They belong to no pool, so
+ *  their `pool` is NULL.
+ *  @{
+ */
+mongory_value *mongory_value_wrap_n_shared(mongory_memory_pool *pool, void *n);
+mongory_value *mongory_value_wrap_b_shared(mongory_memory_pool *pool, bool b);
+mongory_value *mongory_value_wrap_i_shared(mongory_memory_pool *pool, int64_t i);
+/** @} */
+
 /**
  * @def MONGORY_TYPE_MACRO
  * @brief X-Macro for defining mongory_type enum members and associated data.
@@ -111,6 +174,8 @@ mongory_value *mongory_value_wrap_u(mongory_memory_pool *pool, void *u);
   _(MONGORY_TYPE_TABLE, 15, "Table", t)                                                                                \
   _(MONGORY_TYPE_REGEX, 16, "Regex", regex)          /* Custom regex object pointer */                                 \
   _(MONGORY_TYPE_POINTER, 17, "Pointer", ptr)        /* Generic void pointer */                                        \
+  _(MONGORY_TYPE_DATETIME, 18, "Datetime", i)        /* Nanoseconds since the Unix epoch */                            \
+  _(MONGORY_TYPE_BINARY, 19, "Binary", bin)          /* Raw bytes, `len` of them */                                    \
   _(MONGORY_TYPE_UNSUPPORTED, 999, "Unsupported", u) /* External/unknown type pointer */
 
 /**
@@ -143,15 +208,47 @@ static const int mongory_value_compare_fail = 97;
  * @brief Represents a generic value in the Mongory system.
  *
  * It's a tagged union, where `type` indicates which field in the `data` union
- * is active. Each value also carries a pointer to the `mongory_memory_pool`
- * it was allocated from (or is associated with) and a `comp` function for
- * comparisons. The `origin` field can be used to store a pointer to an
- * original external data structure if the `mongory_value` is a bridge or
- * wrapper.
+ * is active.
+ *
+ * When built with `MONGORY_COMPACT_VALUE`, a value is only the tag and the
+ * payload, 16 bytes in all, and its behaviour comes from the built-in
+ * operations of its type. Otherwise each value also carries a pointer to the
+ * `mongory_memory_pool` it was allocated from (or is associated with), its
+ * own `comp` and `to_str` functions, which bridges may override, and an
+ * `origin` field that can store a pointer to an original external data
+ * structure if the `mongory_value` is a bridge or wrapper.
+ *
+ * Code that must build in both modes compares and stringifies values with
+ * `mongory_value_compare` and `mongory_value_to_str`, and reads the pool with
+ * `MONGORY_VALUE_POOL`.
  */
+#ifdef MONGORY_COMPACT_VALUE
+struct mongory_value {
+  mongory_type type;     /**< The type of data stored in the union. */
+  unsigned int len : 31; /**< Byte length of a string, without the terminator,
+                            or of a binary. */
+  unsigned int interned : 1; /**< The string comes from a `mongory_string_interner`. */
+  union {
+    bool b;                  /**< Boolean data. */
+    int64_t i;               /**< Integer data (64-bit). */
+    double d;                /**< Double-precision floating-point data. */
+    char *s;                 /**< String data (null-terminated, `len` bytes). */
+    struct mongory_array *a; /**< Pointer to a mongory_array. */
+    struct mongory_table *t; /**< Pointer to a mongory_table. */
+    void *regex;             /**< Pointer to a custom regex object/structure. */
+    unsigned char *bin;      /**< Binary data (`len` bytes). */
+    void *ptr;               /**< Generic void pointer for other data. */
+    void *u;                 /**< Pointer for unsupported/external types. */
+  } data;                    /**< Union holding the actual data based on type. */
+};
+#else
 struct mongory_value {
   mongory_memory_pool *pool;        /**< Memory pool associated with this value. */
   mongory_type type;                /**< The type of data stored in the union. */
+  unsigned int len : 31;            /**< Byte length of a string, without the
+                                       terminator, or of a binary. */
+  unsigned int interned : 1;        /**< The string comes from a
+                                       `mongory_string_interner`. */
   mongory_value_compare_func comp;  /**< Function to compare this value with
                                        another. */
   mongory_value_to_str_func to_str; /**< Function to convert this value to a
@@ -160,16 +257,112 @@ struct mongory_value {
     bool b;                  /**< Boolean data. */
     int64_t i;               /**< Integer data (64-bit). */
     double d;                /**< Double-precision floating-point data. */
-    char *s;                 /**< String data (null-terminated). String memory
-                                is typically managed by the pool. */
+    char *s;                 /**< String data (null-terminated, `len` bytes). String
+                                memory is managed by the pool unless borrowed. */
     struct mongory_array *a; /**< Pointer to a mongory_array. */
     struct mongory_table *t; /**< Pointer to a mongory_table. */
     void *regex;             /**< Pointer to a custom regex object/structure. */
+    unsigned char *bin;      /**< Binary data (`len` bytes). */
     void *ptr;               /**< Generic void pointer for other data. */
     void *u;                 /**< Pointer for unsupported/external types. */
   } data;                    /**< Union holding the actual data based on type. */
   void *origin;              /**< Optional pointer to an original external value, useful for
                                 bridging with other data systems. */
 };
+#endif
+
+/**
+ * @brief Compares two values with the built-in comparison of `a`'s type,
+ * ignoring any `comp` override.
+ * @param a The first value.
+ * @param b The second value.
+ * @return See `mongory_value_compare_func`.
+ */
+int mongory_value_type_compare(mongory_value *a, mongory_value *b);
+
+/**
+ * @brief Converts a value to a string with the built-in conversion of its
+ * type, ignoring any `to_str` override.
+ * @param value The value.
+ * @param pool The pool to allocate the string from.
+ * @return The string, or NULL on failure.
+ */
+char *mongory_value_type_to_str(mongory_value *value, mongory_memory_pool *pool);
+
+/**
+ * @brief Compares two values.
+ *
+ * Uses `a->comp` unless values are compact. In compact mode, int/int,
+ * datetime/datetime and double/double pairs are compared inline and
+ * everything else dispatches on `a->type`.
+ * @param a The first value.
+ * @param b The second value.
+ * @return See `mongory_value_compare_func`.
+ */
+static inline int mongory_value_compare(mongory_value *a, mongory_value *b) {
+#ifdef MONGORY_COMPACT_VALUE
+  if (a->type == b->type) {
+    if (a->type == MONGORY_TYPE_INT || a->type == MONGORY_TYPE_DATETIME)
+      return (a->data.i > b->data.i) - (a->data.i < b->data.i);
+    if (a->type == MONGORY_TYPE_DOUBLE)
+      return (a->data.d > b->data.d) - (a->data.d < b->data.d);
+  }
+  return mongory_value_type_compare(a, b);
+#else
+  return a->comp ? a->comp(a, b) : mongory_value_compare_fail;
+#endif
+}
+
+/**
+ * @brief Tells whether two values compare equal. Same result as
+ * `mongory_value_compare(a, b) == 0`, but two strings of different lengths
+ * are told apart without looking at their bytes, and two strings interned by
+ * the same interner are compared by pointer.
+ * @param a The first value.
+ * @param b The second value.
+ * @return True if the values are equal.
+ */
+bool mongory_value_equal(mongory_value *a, mongory_value *b);
+
+/**
+ * @brief Hashes a value structurally.
+ *
+ * Values that compare equal hash equally: numbers hash by their value as a
+ * double, so `1` and `1.0` collide on purpose; arrays hash their items in
+ * order; tables hash their pairs regardless of order. The exception is NaN,
+ * which compares equal to every number but has a hash of its own, so hash
+ * containers must handle a NaN themselves, including one nested in an array
+ * or a table. A NULL pointer hashes like a
+ * null value. The hash is recomputed on every call and walks the whole value.
+ * @param value The value, or NULL.
+ * @return The hash.
+ */
+uint64_t mongory_value_hash(mongory_value *value);
+
+/**
+ * @brief Converts a value to a string, using `value->to_str` unless values
+ * are compact.
+ * @param value The value.
+ * @param pool The pool to allocate the string from.
+ * @return The string, or NULL on failure.
+ */
+static inline char *mongory_value_to_str(mongory_value *value, mongory_memory_pool *pool) {
+#ifdef MONGORY_COMPACT_VALUE
+  return mongory_value_type_to_str(value, pool);
+#else
+  return value->to_str ? value->to_str(value, pool) : NULL;
+#endif
+}
+
+/**
+ * @def MONGORY_VALUE_POOL
+ * @brief The pool a value was allocated from, or `fallback` when the value
+ * does not record one (always the case for compact values).
+ */
+#ifdef MONGORY_COMPACT_VALUE
+#define MONGORY_VALUE_POOL(value, fallback) (fallback)
+#else
+#define MONGORY_VALUE_POOL(value, fallback) ((value)->pool ? (value)->pool : (fallback))
+#endif
 
 #endif /* MONGORY_VALUE */
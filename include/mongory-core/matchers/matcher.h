@@ -12,6 +12,7 @@
 
 #include "mongory-core/foundations/array.h" // For mongory_array (used in context)
 #include "mongory-core/foundations/memory_pool.h"
+#include "mongory-core/foundations/sink.h"
 #include "mongory-core/foundations/value.h"
 
 // Forward declaration for the main matcher structure.
@@ -32,6 +33,22 @@ typedef struct mongory_matcher mongory_matcher;
  */
 mongory_matcher *mongory_matcher_new(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx);
 
+/**
+ * @brief Freezes a matcher so that it can be shared between threads.
+ *
+ * Sub-matchers that are otherwise built on first use (such as the matchers
+ * handling array values) are built eagerly, and the whole tree is marked
+ * read-only. Matching a frozen matcher never modifies it nor allocates from
+ * its pool, so one frozen matcher can serve any number of threads without
+ * locking, as long as custom regex and matcher callbacks are thread-safe.
+ * Freezing an already frozen matcher does nothing.
+ *
+ * @param matcher The matcher to freeze.
+ * @return True on success, false on failure (the error is set on the
+ * matcher's pool).
+ */
+bool mongory_matcher_freeze(mongory_matcher *matcher);
+
 /**
  * @brief Matches a value against a matcher.
  * @param matcher The matcher to match against.
@@ -41,12 +58,61 @@ mongory_matcher *mongory_matcher_new(mongory_memory_pool *pool, mongory_value *c
 bool mongory_matcher_match(mongory_matcher *matcher, mongory_value *value);
 
 /**
- * @brief Explains a matcher.
+ * @brief Matches a batch of values against a matcher.
+ *
+ * Every matcher node runs once over the whole batch: AND children only see
+ * the rows still alive, OR children only the rows not yet accepted. The
+ * indexes of the matching values are written to `selection` in ascending
+ * order.
+ *
+ * @param matcher The matcher to match against.
+ * @param values The values to match.
+ * @param count The number of values.
+ * @param selection Output buffer with room for `count` indexes.
+ * @return The number of matching values written to `selection`.
+ */
+size_t mongory_matcher_match_batch(mongory_matcher *matcher, mongory_value **values, size_t count, size_t *selection);
+
+/**
+ * @brief Filters a collection on several threads.
+ *
+ * The records are split into chunks that are distributed over `nthreads`
+ * workers (the calling thread included) by a work-stealing scheduler. Each
+ * worker evaluates its chunks with its own scratch memory pool. The matching
+ * records are pushed to `out` in the order of `array`, independently of the
+ * number of threads.
+ *
+ * The matcher is frozen (see `mongory_matcher_freeze`) and shared by the
+ * workers, so custom regex or matcher callbacks must be safe to call
+ * concurrently. The records must be safe to read concurrently, which holds
+ * for deep-converted values.
+ *
+ * @param matcher The matcher to filter with.
+ * @param array The records to filter.
+ * @param nthreads The number of threads to use; values below 2 filter on the
+ * calling thread.
+ * @param out The array receiving the matching records.
+ * @return True on success, false on failure, in which case `out` may hold a
+ * partial result and `out->pool->error` is set.
+ */
+bool mongory_matcher_filter_parallel(mongory_matcher *matcher, mongory_array *array, int nthreads, mongory_array *out);
+
+/**
+ * @brief Explains a matcher on stdout.
  * @param matcher The matcher to explain.
  * @param temp_pool The temporary pool to use for the explanation.
  */
 void mongory_matcher_explain(mongory_matcher *matcher, mongory_memory_pool *temp_pool);
 
+/**
+ * @brief Writes the explanation of a matcher to a sink.
+ * @param matcher The matcher to explain.
+ * @param sink The sink to write to.
+ * @param temp_pool The temporary pool to use for the explanation, and the
+ * sink's scratch pool if it has none.
+ */
+void mongory_matcher_explain_to_sink(mongory_matcher *matcher, mongory_sink *sink, mongory_memory_pool *temp_pool);
+
 /**
  * @brief Traces a matcher.
  * @param matcher The matcher to trace.
@@ -55,13 +121,26 @@ void mongory_matcher_explain(mongory_matcher *matcher, mongory_memory_pool *temp
 bool mongory_matcher_trace(mongory_matcher *matcher, mongory_value *value);
 
 /**
- * @brief Prints the trace of a matcher.
+ * @brief Prints the trace of a matcher to stdout.
  * @param matcher The matcher to print the trace of.
  */
 void mongory_matcher_print_trace(mongory_matcher *matcher);
 
+/**
+ * @brief Writes the trace of a matcher to a sink.
+ * @param matcher The matcher to write the trace of.
+ * @param sink The sink to write to.
+ */
+void mongory_matcher_print_trace_to_sink(mongory_matcher *matcher, mongory_sink *sink);
+
 /**
  * @brief Enables the trace of a matcher.
+ *
+ * Tracing is an overlay of the calling thread: the matcher tree is left
+ * untouched, so frozen matchers can be traced while other threads keep using
+ * them. Matches made through `mongory_matcher_match` on this thread are
+ * recorded until the trace is disabled.
+ *
  * @param matcher The matcher to enable the trace of.
  * @param temp_pool The temporary pool to use for the trace.
  */
@@ -0,0 +1,52 @@
+#ifndef MONGORY_PROGRAM_H
+#define MONGORY_PROGRAM_H
+
+/**
+ * @file program.h
+ * @brief Defines the compiled form of a matcher tree.
+ *
+ * A `mongory_program` is a flat, contiguous instruction stream produced from
+ * a matcher tree built by `mongory_matcher_new`. Logical operators become
+ * conditional jumps, field access becomes load/pop pairs and comparisons are
+ * evaluated inline, so matching a document no longer walks the tree through
+ * `match` function pointers and child arrays.
+ */
+
+#include "mongory-core/foundations/memory_pool.h"
+#include "mongory-core/foundations/value.h"
+#include "mongory-core/matchers/matcher.h"
+#include <stdbool.h>
+
+// Forward declaration of the compiled program structure.
+typedef struct mongory_program mongory_program;
+
+/**
+ * @brief Compiles a matcher tree into a flat program.
+ *
+ * Sub-matchers that are normally created lazily on the first array value
+ * (array record matchers) are built during compilation, so the matcher tree
+ * may grow inside its own pool. The program keeps pointers into the tree;
+ * the matcher must outlive the program. Matchers without a dedicated
+ * instruction (e.g. `$regex`, `$in`, custom matchers) are invoked through a
+ * call instruction.
+ *
+ * @param pool The memory pool used for the instruction stream.
+ * @param matcher The matcher tree to compile.
+ * @return mongory_program* The compiled program, or NULL on failure (the
+ * reason is stored in `pool->error`).
+ */
+mongory_program *mongory_program_compile(mongory_memory_pool *pool, mongory_matcher *matcher);
+
+/**
+ * @brief Matches a value against a compiled program.
+ *
+ * Produces the same result as `mongory_matcher_match` on the matcher the
+ * program was compiled from. Programs do not record traces.
+ *
+ * @param program The compiled program.
+ * @param value The value to match.
+ * @return True if the value matches, false otherwise.
+ */
+bool mongory_program_match(mongory_program *program, mongory_value *value);
+
+#endif /* MONGORY_PROGRAM_H */
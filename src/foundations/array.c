@@ -24,10 +24,9 @@
 /**
  * @brief Resizes the internal storage of the array.
  *
- * Allocates a new block of memory for items and copies existing items to it.
- * The old item storage is not explicitly freed here as it's managed by the
- * memory pool; this function assumes the new allocation replaces the old one
- * in terms of where `internal->items` points.
+ * Grows the item storage in place when it is the last allocation of the
+ * pool. Otherwise allocates a new block of memory for items, copies existing
+ * items to it and releases the old block to the pool for reuse.
  *
  * @param self Pointer to the mongory_array instance.
  * @param size The new capacity (number of elements) for the array.
@@ -37,6 +36,14 @@
 bool mongory_array_resize(mongory_array *self, size_t size) {
   mongory_array_private *internal = (mongory_array_private *)self;
 
+  // Extend the current block if nothing was allocated after it.
+  if (self->pool->try_extend != NULL &&
+      self->pool->try_extend(self->pool, internal->items, sizeof(mongory_value *) * internal->capacity,
+                             sizeof(mongory_value *) * size)) {
+    internal->capacity = size;
+    return true;
+  }
+
   // Allocate a new, larger block of memory for the items.
   mongory_value **new_items = MG_ALLOC_ARY(self->pool, mongory_value*, size);
   if (!new_items) {
@@ -46,6 +53,9 @@ bool mongory_array_resize(mongory_array *self, size_t size) {
 
   // Copy existing item pointers to the new memory block.
   memcpy(new_items, internal->items, sizeof(mongory_value *) * self->count);
+  if (self->pool->release != NULL) {
+    self->pool->release(self->pool, internal->items, sizeof(mongory_value *) * internal->capacity);
+  }
 
   internal->items = new_items;
   internal->capacity = size;
@@ -163,6 +173,13 @@ static inline bool mongory_array_set(mongory_array *self, size_t index, mongory_
   return true;
 }
 
+void mongory_array_init_boxed(mongory_array_private *internal) {
+  internal->base.each = mongory_array_each;
+  internal->base.get = mongory_array_get;
+  internal->base.push = mongory_array_push;
+  internal->base.set = mongory_array_set;
+}
+
 /**
  * @brief Creates and initializes a new mongory_array.
  *
@@ -193,14 +210,11 @@ mongory_array *mongory_array_new(mongory_memory_pool *pool) {
   // Initialize the public part of the array structure.
   internal->base.pool = pool;
   internal->base.count = 0;
-  internal->base.each = mongory_array_each;
-  internal->base.get = mongory_array_get;
-  internal->base.push = mongory_array_push;
-  internal->base.set = mongory_array_set;
 
   // Initialize the private part of the array structure.
   internal->items = items;
   internal->capacity = MONGORY_ARRAY_INIT_SIZE;
+  mongory_array_init_boxed(internal);
 
   return &internal->base; // Return pointer to the public structure.
 }
@@ -220,7 +234,7 @@ mongory_array *mongory_array_new(mongory_memory_pool *pool) {
  */
 mongory_array *mongory_array_nested_wrap(mongory_memory_pool *pool, int argc, ...) {
   mongory_array *array = mongory_array_new(pool);
-  if (!array) {
+  if (!array || !mongory_array_reserve(array, (size_t)argc)) {
     return NULL;
   }
   va_list args;
@@ -233,6 +247,56 @@ mongory_array *mongory_array_nested_wrap(mongory_memory_pool *pool, int argc, ..
   return array;
 }
 
+/**
+ * @brief Ensures the array can hold `capacity` items without growing.
+ *
+ * Boxed arrays are resized to exactly `capacity`; typed arrays delegate to
+ * `mongory_typed_array_reserve`.
+ *
+ * @param array Pointer to the mongory_array instance.
+ * @param capacity The number of items to make room for.
+ * @return true on success, false on allocation failure.
+ */
+bool mongory_array_reserve(mongory_array *array, size_t capacity) {
+  if (array->get != mongory_array_get) {
+    return mongory_typed_array_reserve(array, capacity);
+  }
+  mongory_array_private *internal = (mongory_array_private *)array;
+  if (capacity <= internal->capacity) {
+    return true;
+  }
+  return mongory_array_resize(array, capacity);
+}
+
+/**
+ * @brief Appends `count` values after reserving room for all of them.
+ *
+ * Boxed arrays receive the values with a single copy; typed arrays push them
+ * one by one so that each value is unboxed (or deoptimizes the array).
+ *
+ * @param array Pointer to the mongory_array instance.
+ * @param values The values to append.
+ * @param count The number of values.
+ * @return true on success, false on allocation failure.
+ */
+bool mongory_array_push_many(mongory_array *array, mongory_value **values, size_t count) {
+  if (!mongory_array_reserve(array, array->count + count)) {
+    return false;
+  }
+  if (array->get != mongory_array_get) {
+    for (size_t i = 0; i < count; i++) {
+      if (!array->push(array, values[i])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  mongory_array_private *internal = (mongory_array_private *)array;
+  memcpy(internal->items + array->count, values, sizeof(mongory_value *) * count);
+  array->count += count;
+  return true;
+}
+
 typedef size_t(*mongory_array_sort_cb)(mongory_value *value, void *ctx);
 
 static mongory_value** mongory_array_merge_sort_finalize(mongory_memory_pool *pool, mongory_value **left, mongory_value **right, size_t count, void *ctx, mongory_array_sort_cb callback) {
@@ -266,20 +330,27 @@ static mongory_value** mongory_array_merge_sort(mongory_memory_pool *pool, mongo
 
 mongory_array *mongory_array_sort_by(mongory_array *self, mongory_memory_pool *temp_pool, void *ctx, mongory_array_sort_cb callback) {
   mongory_array_private *internal = (mongory_array_private *)self;
+  mongory_value **items = internal->items;
+  if (self->get != mongory_array_get) {
+    // A typed array boxes its items on demand.
+    items = MG_ALLOC_ARY(temp_pool, mongory_value*, self->count);
+    for (size_t i = 0; i < self->count; i++) {
+      items[i] = self->get(self, i);
+    }
+  }
 
-  mongory_value **new_items = mongory_array_merge_sort(temp_pool, internal->items, self->count, ctx, callback);
-  mongory_array_private *new_array = (mongory_array_private *)mongory_array_new(self->pool);
-  new_array->capacity = internal->capacity;
-  new_array->base.count = self->count;
-  new_array->items = MG_ALLOC_ARY(self->pool, mongory_value*, new_array->capacity);
-  memcpy(new_array->items, new_items, sizeof(mongory_value *) * self->count);
-  return &new_array->base;
+  mongory_value **new_items = mongory_array_merge_sort(temp_pool, items, self->count, ctx, callback);
+  mongory_array *new_array = mongory_array_new(self->pool);
+  if (!new_array || !mongory_array_push_many(new_array, new_items, self->count)) {
+    return NULL;
+  }
+  return new_array;
 }
 
 bool mongory_array_includes(mongory_array *self, mongory_value *value) {
   for (size_t i = 0; i < self->count; i++) {
     mongory_value *item = self->get(self, i);
-    if (item->comp(item, value) == 0) {
+    if (mongory_value_equal(item, value)) {
       return true;
     }
   }
@@ -13,6 +13,33 @@ typedef struct mongory_array_private {
   size_t capacity;       // capacity
 } mongory_array_private;
 
+/**
+ * @brief Installs the operations of a boxed array on `internal`, whose
+ * `items` and `capacity` must already be set.
+ */
+void mongory_array_init_boxed(mongory_array_private *internal);
+
+/**
+ * @brief Grows a typed array's item vector to at least `capacity` items.
+ * Backs `mongory_array_reserve` for typed arrays.
+ */
+bool mongory_typed_array_reserve(mongory_array *self, size_t capacity);
+
+/**
+ * @brief Reads an item without allocating.
+ *
+ * A typed array item that has not been boxed yet is built in `scratch`, and
+ * `scratch` is returned: the result is then only valid until `scratch` is
+ * reused and must not be kept. Any other item is returned as `get` returns
+ * it. Unlike `get`, never writes to the array, so frozen matchers and
+ * concurrent readers can scan typed arrays with it.
+ * @param self The array.
+ * @param index The index of the item.
+ * @param scratch Storage for a transient box.
+ * @return The item, or NULL if `index` is out of bounds.
+ */
+mongory_value *mongory_array_peek(mongory_array *self, size_t index, mongory_value *scratch);
+
 mongory_array *mongory_array_sort_by(mongory_array *self, mongory_memory_pool *temp_pool, void *ctx, size_t(*callback)(mongory_value *value, void *ctx));
 bool mongory_array_includes(mongory_array *self, mongory_value *value);
 
@@ -17,6 +17,8 @@
 #include "../matchers/literal_matcher.h"   // For specific matcher constructors
 #include "../matchers/external_matcher.h"     // For specific matcher constructors
 #include "config_private.h"                // For mongory_regex_adapter, mongory_value_converter, etc.
+#include "memory_pool_private.h"           // For mongory_internal_allocator
+#include "shape_private.h"                 // For mongory_shape_cleanup
 #include "mongory-core/foundations/memory_pool.h"
 #include "mongory-core/foundations/table.h"
 #include "mongory-core/foundations/value.h"
@@ -24,6 +26,8 @@
 static bool mongory_regex_default_func(mongory_memory_pool *pool, mongory_value *pattern, mongory_value *value);
 static char *mongory_regex_default_stringify_func(mongory_memory_pool *pool, mongory_value *pattern);
 
+// Global allocator of pools created without one; NULL for malloc/free.
+const mongory_allocator *mongory_internal_allocator = NULL;
 // Global internal memory pool for the library.
 mongory_memory_pool *mongory_internal_pool = NULL;
 // Global adapter for regex operations.
@@ -81,6 +85,12 @@ static char *mongory_regex_default_stringify_func(mongory_memory_pool *pool, mon
   return "//";   // Default behavior is no stringification.
 }
 
+/**
+ * @brief Sets the global default pool allocator.
+ * @param allocator The allocator, or NULL for malloc/free.
+ */
+void mongory_allocator_set(const mongory_allocator *allocator) { mongory_internal_allocator = allocator; }
+
 /**
  * @brief Sets the global regex matching function.
  * Initializes the regex adapter if it's not already.
@@ -267,4 +277,6 @@ void mongory_cleanup() {
   // Set other global pointers to NULL to indicate they are no longer valid.
   // The memory they pointed to should have been managed by the internal pool.
   mongory_matcher_mapping = NULL; // The table itself and its nodes.
+  mongory_shape_cleanup();        // Shapes have their own pool.
+  mongory_memory_pool_cache_clear();
 }
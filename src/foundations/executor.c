@@ -0,0 +1,158 @@
+/**
+ * @file executor.c
+ * @brief Implements the work-stealing executor on top of POSIX threads.
+ *
+ * Each worker owns a range of task indexes guarded by its own mutex. The owner
+ * pops from the head of the range and thieves pop from the tail, so the two
+ * only contend on the last task of a range. Tasks are expected to be coarse
+ * (thousands of records), which keeps the lock cost negligible.
+ */
+#include "executor.h"
+#include <pthread.h>
+#include <stdlib.h>
+
+/**
+ * @brief The range of tasks owned by one worker.
+ */
+typedef struct mongory_executor_queue {
+  pthread_mutex_t lock; /**< Guards `head` and `tail`. */
+  size_t head;          /**< Next task taken by the owner. */
+  size_t tail;          /**< One past the last task of the range. */
+} mongory_executor_queue;
+
+/**
+ * @brief State shared by all workers of one run.
+ */
+typedef struct mongory_executor {
+  mongory_executor_queue *queues;  /**< One queue per worker. */
+  size_t workers;                  /**< Number of workers. */
+  mongory_executor_task_func func; /**< Task function. */
+  void *ctx;                       /**< Task context. */
+  pthread_mutex_t state_lock;      /**< Guards `failed`. */
+  bool failed;                     /**< Set once a task fails. */
+} mongory_executor;
+
+/**
+ * @brief Per-thread start argument.
+ */
+typedef struct mongory_executor_worker {
+  mongory_executor *executor;
+  size_t index;
+} mongory_executor_worker;
+
+static bool mongory_executor_failed(mongory_executor *executor) {
+  pthread_mutex_lock(&executor->state_lock);
+  bool failed = executor->failed;
+  pthread_mutex_unlock(&executor->state_lock);
+  return failed;
+}
+
+static void mongory_executor_fail(mongory_executor *executor) {
+  pthread_mutex_lock(&executor->state_lock);
+  executor->failed = true;
+  pthread_mutex_unlock(&executor->state_lock);
+}
+
+/**
+ * @brief Takes the next task of the worker's own queue, or steals the last
+ * task of another worker's queue.
+ */
+static bool mongory_executor_next(mongory_executor *executor, size_t index, size_t *task) {
+  mongory_executor_queue *own = &executor->queues[index];
+  pthread_mutex_lock(&own->lock);
+  bool found = own->head < own->tail;
+  if (found)
+    *task = own->head++;
+  pthread_mutex_unlock(&own->lock);
+  if (found)
+    return true;
+
+  for (size_t offset = 1; offset < executor->workers; offset++) {
+    mongory_executor_queue *victim = &executor->queues[(index + offset) % executor->workers];
+    pthread_mutex_lock(&victim->lock);
+    found = victim->head < victim->tail;
+    if (found)
+      *task = --victim->tail;
+    pthread_mutex_unlock(&victim->lock);
+    if (found)
+      return true;
+  }
+  return false;
+}
+
+static void mongory_executor_work(mongory_executor *executor, size_t index) {
+  size_t task;
+  while (!mongory_executor_failed(executor) && mongory_executor_next(executor, index, &task)) {
+    if (!executor->func(executor->ctx, index, task)) {
+      mongory_executor_fail(executor);
+    }
+  }
+}
+
+static void *mongory_executor_thread_main(void *arg) {
+  mongory_executor_worker *worker = (mongory_executor_worker *)arg;
+  mongory_executor_work(worker->executor, worker->index);
+  return NULL;
+}
+
+bool mongory_executor_run(size_t workers, size_t task_count, mongory_executor_task_func func, void *ctx) {
+  if (task_count == 0)
+    return true;
+  if (workers > task_count)
+    workers = task_count;
+  if (workers <= 1) {
+    for (size_t task = 0; task < task_count; task++) {
+      if (!func(ctx, 0, task))
+        return false;
+    }
+    return true;
+  }
+
+  mongory_executor_queue *queues = calloc(workers, sizeof(mongory_executor_queue));
+  mongory_executor_worker *threads_args = calloc(workers, sizeof(mongory_executor_worker));
+  pthread_t *threads = calloc(workers, sizeof(pthread_t));
+  bool *started = calloc(workers, sizeof(bool));
+  if (!queues || !threads_args || !threads || !started) {
+    free(queues);
+    free(threads_args);
+    free(threads);
+    free(started);
+    return false;
+  }
+
+  mongory_executor executor = {
+      .queues = queues,
+      .workers = workers,
+      .func = func,
+      .ctx = ctx,
+      .failed = false,
+  };
+  pthread_mutex_init(&executor.state_lock, NULL);
+  for (size_t i = 0; i < workers; i++) {
+    pthread_mutex_init(&queues[i].lock, NULL);
+    queues[i].head = task_count * i / workers;
+    queues[i].tail = task_count * (i + 1) / workers;
+  }
+
+  for (size_t i = 1; i < workers; i++) {
+    threads_args[i].executor = &executor;
+    threads_args[i].index = i;
+    // A worker that fails to start leaves its range to be stolen.
+    started[i] = pthread_create(&threads[i], NULL, mongory_executor_thread_main, &threads_args[i]) == 0;
+  }
+  mongory_executor_work(&executor, 0);
+  for (size_t i = 1; i < workers; i++) {
+    if (started[i])
+      pthread_join(threads[i], NULL);
+  }
+
+  for (size_t i = 0; i < workers; i++) {
+    pthread_mutex_destroy(&queues[i].lock);
+  }
+  pthread_mutex_destroy(&executor.state_lock);
+  free(queues);
+  free(threads_args);
+  free(threads);
+  free(started);
+  return !executor.failed;
+}
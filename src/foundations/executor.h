@@ -0,0 +1,45 @@
+#ifndef MONGORY_EXECUTOR_H
+#define MONGORY_EXECUTOR_H
+
+/**
+ * @file executor.h
+ * @brief A small work-stealing executor for running independent tasks on
+ * several threads. This is an internal header for the library.
+ *
+ * Tasks are identified by their index in [0, task_count). Each worker starts
+ * with a contiguous slice of the indexes, takes tasks from the front of its own
+ * slice and, once it runs dry, steals from the back of the other workers'
+ * slices. The calling thread is worker 0, so running with a single worker
+ * never creates a thread.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Function executing one task.
+ * @param ctx The context passed to `mongory_executor_run`.
+ * @param worker The index of the worker running the task, in [0, workers).
+ * @param task The index of the task.
+ * @return True on success. Returning false cancels the tasks that have not
+ * started yet.
+ */
+typedef bool (*mongory_executor_task_func)(void *ctx, size_t worker, size_t task);
+
+/**
+ * @brief Runs `task_count` tasks on up to `workers` threads and waits for all
+ * of them.
+ *
+ * If a thread cannot be created, its share of the tasks is stolen by the
+ * workers that did start, so every task still runs.
+ *
+ * @param workers The number of workers, including the calling thread.
+ * @param task_count The number of tasks.
+ * @param func The task function.
+ * @param ctx Context passed to every task.
+ * @return True if every task succeeded, false if a task failed or the
+ * executor state could not be allocated.
+ */
+bool mongory_executor_run(size_t workers, size_t task_count, mongory_executor_task_func func, void *ctx);
+
+#endif /* MONGORY_EXECUTOR_H */
@@ -6,11 +6,48 @@
  * made from the current chunk. If the current chunk is full, a new, larger
  * chunk is allocated and added to the list. Freeing the pool deallocates all
  * chunks. It also supports tracing externally allocated memory.
+ *
+ * Pools are usually short-lived (one per record or per request), so freed
+ * chunks and pool structures are not handed back to `free` right away: each
+ * thread keeps a small cache of them, by chunk size class, and the next pool
+ * created on that thread reuses them. The cache of a thread is released when
+ * the thread exits or calls `mongory_memory_pool_cache_clear`.
+ *
+ * Blocks given back with `pool->release` go onto per-size-class freelists
+ * (a slab layer) that is set up on the first release: until then `alloc` is
+ * a plain bump allocation, and pools that never release pay nothing.
+ *
+ * Pool memory is not zeroed: nothing allocated from a pool may rely on its
+ * initial contents. Building with MONGORY_POOL_WIPE zeroes new chunks and
+ * wipes chunks when they are released, at the cost of touching every byte.
+ *
+ * Pools get their memory from a `mongory_allocator`, `malloc` and `free`
+ * unless the caller or `mongory_allocator_set` picks another one. The chunk
+ * cache and the mapping of large chunks only apply to the system allocator.
+ *
+ * Chunks of MONGORY_CHUNK_MMAP_THRESHOLD bytes and more are mapped straight
+ * from the system and unmapped when released, so their pages are only
+ * faulted in as the pool reaches them. Building with MONGORY_POOL_HUGEPAGES
+ * asks for transparent huge pages on those mappings, where supported. Both
+ * are POSIX-only: on Windows, large chunks come from `malloc` like the rest.
  */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE // For MAP_ANONYMOUS and madvise under strict C99.
+#endif
 #include <mongory-core/foundations/memory_pool.h>
+#include "memory_pool_private.h"
+#include "utils.h"  // For MONGORY_THREAD_LOCAL
+#include <pthread.h>
+#include <stdint.h> // For uintptr_t
 #include <stdio.h>  // For NULL, though stdlib.h or stddef.h is more common
-#include <stdlib.h> // For calloc, free, etc.
+#include <stdlib.h> // For malloc, free, etc.
 #include <string.h> // For memset
+#if !defined(_WIN32)
+#include <sys/mman.h> // For mmap, munmap and madvise
+#if defined(MAP_ANONYMOUS)
+#define MONGORY_POOL_MMAP
+#endif
+#endif
 
 /**
  * @def MONGORY_INITIAL_CHUNK_SIZE
@@ -19,6 +56,21 @@
  */
 #define MONGORY_INITIAL_CHUNK_SIZE 2048
 
+/**
+ * @def MONGORY_MAX_CHUNK_SIZE
+ * @brief Size at which chunk doubling stops. Later chunks keep this size,
+ * unless a single allocation needs more.
+ */
+#define MONGORY_MAX_CHUNK_SIZE ((size_t)64 << 20)
+
+/**
+ * @def MONGORY_CHUNK_MMAP_THRESHOLD
+ * @brief Chunks of this size and more are obtained with `mmap` rather than
+ * `malloc` where `mmap` is available. They are larger than any cached chunk
+ * class.
+ */
+#define MONGORY_CHUNK_MMAP_THRESHOLD ((size_t)1 << 20)
+
 /**
  * @def MONGORY_ALIGN8(size)
  * @brief Macro to align a given size to an 8-byte boundary.
@@ -29,6 +81,43 @@
  */
 #define MONGORY_ALIGN8(size) (((size) + 7) & ~((size_t)7))
 
+/**
+ * @def MONGORY_SLAB_SMALL_MAX
+ * @brief Largest block size with an exact size class. Blocks up to this size
+ * have one class per multiple of 8 bytes.
+ */
+#define MONGORY_SLAB_SMALL_MAX 256
+
+/**
+ * @def MONGORY_SLAB_LARGE_MIN_SHIFT
+ * @brief Log2 of the smallest power-of-two size class, 512 bytes.
+ */
+#define MONGORY_SLAB_LARGE_MIN_SHIFT 9
+
+/**
+ * @def MONGORY_SLAB_LARGE_MAX_SHIFT
+ * @brief Log2 of the largest power-of-two size class, 1 MiB. Larger
+ * allocations never come from the freelists.
+ */
+#define MONGORY_SLAB_LARGE_MAX_SHIFT 20
+
+/**
+ * @def MONGORY_SLAB_CLASSES
+ * @brief Number of size classes: the exact small classes, then one class per
+ * power of two.
+ */
+#define MONGORY_SLAB_CLASSES                                                                                           \
+  (MONGORY_SLAB_SMALL_MAX / 8 + MONGORY_SLAB_LARGE_MAX_SHIFT - MONGORY_SLAB_LARGE_MIN_SHIFT + 1)
+
+/**
+ * @struct mongory_memory_slab
+ * @brief Freelists of released blocks, by size class. A free block stores
+ * the next block of its list in its first word.
+ */
+typedef struct mongory_memory_slab {
+  void *free[MONGORY_SLAB_CLASSES]; /**< Head of each freelist. */
+} mongory_memory_slab;
+
 /**
  * @struct mongory_memory_node
  * @brief Represents a node in the linked list of memory chunks within the pool.
@@ -58,26 +147,252 @@ typedef struct mongory_memory_pool_ctx {
   mongory_memory_node *head;    /**< Head of the list of memory chunks. */
   mongory_memory_node *current; /**< Current chunk to allocate from. */
   mongory_memory_node *extra;   /**< Head of list for externally traced memory. */
+  const mongory_allocator *allocator; /**< Backing memory of the pool. */
+  mongory_memory_slab *slab;    /**< `slab_storage` once a block was released
+                                     since the last reset, NULL before. */
+  mongory_memory_slab *slab_storage; /**< Freelists, taken from the allocator
+                                          on the first release. */
+  bool in_buffer;               /**< The pool and its first chunk live in a
+                                     caller's buffer. */
 } mongory_memory_pool_ctx;
 
 /**
- * @brief Allocates a new memory chunk (node and its associated memory block).
+ * @struct mongory_memory_pool_shell
+ * @brief A pool and its context, allocated (and cached) together.
+ */
+typedef struct mongory_memory_pool_shell {
+  mongory_memory_pool pool;    /**< The public pool structure. */
+  mongory_memory_pool_ctx ctx; /**< Its context. */
+} mongory_memory_pool_shell;
+
+/**
+ * @def MONGORY_CHUNK_CACHE_CLASSES
+ * @brief Number of chunk size classes kept in a thread's cache: chunks of
+ * MONGORY_INITIAL_CHUNK_SIZE times 1, 2, 4, ... 128 bytes. Larger chunks are
+ * freed right away.
+ */
+#define MONGORY_CHUNK_CACHE_CLASSES 8
+
+/**
+ * @def MONGORY_CHUNK_CACHE_DEPTH
+ * @brief Number of chunks, and of pool structures, a thread's cache keeps per
+ * class.
+ */
+#define MONGORY_CHUNK_CACHE_DEPTH 4
+
+/**
+ * @struct mongory_chunk_cache
+ * @brief Chunks and pool structures released on a thread, ready for reuse.
+ * Cached chunks are linked through `next`, cached shells through `ctx.head`.
+ */
+typedef struct mongory_chunk_cache {
+  mongory_memory_node *chunks[MONGORY_CHUNK_CACHE_CLASSES]; /**< Free chunks, by size class. */
+  size_t chunk_counts[MONGORY_CHUNK_CACHE_CLASSES];         /**< Length of each list. */
+  mongory_memory_pool_shell *shells;                        /**< Free pool structures. */
+  size_t shell_count;                                       /**< Length of `shells`. */
+  mongory_memory_pool *scratch;                             /**< The thread's scratch pool, or NULL. */
+  bool registered; /**< Whether the thread-exit destructor is armed. */
+} mongory_chunk_cache;
+
+static MONGORY_THREAD_LOCAL mongory_chunk_cache mongory_chunk_cache_local;
+static pthread_key_t mongory_chunk_cache_key;
+static pthread_once_t mongory_chunk_cache_key_once = PTHREAD_ONCE_INIT;
+
+static void *mongory_system_alloc(void *ctx, size_t size) {
+  (void)ctx;
+  return malloc(size);
+}
+
+static void mongory_system_free(void *ctx, void *ptr, size_t size) {
+  (void)ctx;
+  (void)size;
+  free(ptr);
+}
+
+/**
+ * @brief The allocator of pools when none is configured.
+ */
+static const mongory_allocator mongory_system_allocator = {
+    .alloc = mongory_system_alloc,
+    .free = mongory_system_free,
+    .ctx = NULL,
+};
+
+/**
+ * @brief Obtains the memory of a chunk. On the system allocator, large chunks
+ * are private anonymous mappings.
+ * @return The memory, or NULL on failure.
+ */
+static inline void *mongory_memory_chunk_memory_new(const mongory_allocator *allocator, size_t chunk_size) {
+  if (allocator != &mongory_system_allocator) {
+    void *mem = allocator->alloc(allocator->ctx, chunk_size);
+#ifdef MONGORY_POOL_WIPE
+    if (mem)
+      memset(mem, 0, chunk_size);
+#endif
+    return mem;
+  }
+#ifdef MONGORY_POOL_MMAP
+  if (chunk_size >= MONGORY_CHUNK_MMAP_THRESHOLD) {
+    void *mem = mmap(NULL, chunk_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED)
+      return NULL;
+#if defined(MONGORY_POOL_HUGEPAGES) && defined(MADV_HUGEPAGE)
+    madvise(mem, chunk_size, MADV_HUGEPAGE); // Advisory; failure is harmless.
+#endif
+    return mem; // Mapped pages are already zero.
+  }
+#endif
+#ifdef MONGORY_POOL_WIPE
+  return calloc(1, chunk_size);
+#else
+  return malloc(chunk_size);
+#endif
+}
+
+/**
+ * @brief Frees a chunk, node included, back to its allocator.
+ */
+static inline void mongory_memory_chunk_free(const mongory_allocator *allocator, mongory_memory_node *node) {
+  if (allocator != &mongory_system_allocator) {
+#ifdef MONGORY_POOL_WIPE
+    memset(node->ptr, 0, node->size); // Clear memory for safety.
+#endif
+    allocator->free(allocator->ctx, node->ptr, node->size);
+    allocator->free(allocator->ctx, node, sizeof(mongory_memory_node));
+    return;
+  }
+#ifdef MONGORY_POOL_MMAP
+  if (node->size >= MONGORY_CHUNK_MMAP_THRESHOLD) {
+    munmap(node->ptr, node->size);
+    free(node);
+    return;
+  }
+#endif
+#ifdef MONGORY_POOL_WIPE
+  memset(node->ptr, 0, node->size); // Clear memory for safety.
+#endif
+  free(node->ptr);
+  free(node);
+}
+
+/**
+ * @brief Frees every chunk and pool structure in a cache.
+ */
+static void mongory_chunk_cache_release(mongory_chunk_cache *cache) {
+  if (cache->scratch) {
+    mongory_memory_pool *scratch = cache->scratch;
+    cache->scratch = NULL;
+    scratch->free(scratch);
+  }
+  for (int i = 0; i < MONGORY_CHUNK_CACHE_CLASSES; i++) {
+    while (cache->chunks[i]) {
+      mongory_memory_node *node = cache->chunks[i];
+      cache->chunks[i] = node->next;
+      free(node->ptr);
+      free(node);
+    }
+    cache->chunk_counts[i] = 0;
+  }
+  while (cache->shells) {
+    mongory_memory_pool_shell *shell = cache->shells;
+    cache->shells = (mongory_memory_pool_shell *)shell->ctx.head;
+    free(shell);
+  }
+  cache->shell_count = 0;
+}
+
+/**
+ * @brief Thread-exit destructor of the cache key.
+ */
+static void mongory_chunk_cache_destroy(void *cache) {
+  mongory_chunk_cache_release((mongory_chunk_cache *)cache);
+  ((mongory_chunk_cache *)cache)->registered = false;
+}
+
+static void mongory_chunk_cache_key_init(void) {
+  pthread_key_create(&mongory_chunk_cache_key, mongory_chunk_cache_destroy);
+}
+
+/**
+ * @brief Returns the calling thread's cache, arming its release at thread
+ * exit the first time something is put in it.
+ */
+static inline mongory_chunk_cache *mongory_chunk_cache_for_put(void) {
+  mongory_chunk_cache *cache = &mongory_chunk_cache_local;
+  if (!cache->registered) {
+    pthread_once(&mongory_chunk_cache_key_once, mongory_chunk_cache_key_init);
+    if (pthread_setspecific(mongory_chunk_cache_key, cache) != 0) {
+      return NULL; // Without a destructor the cache would leak; do not cache.
+    }
+    cache->registered = true;
+  }
+  return cache;
+}
+
+/**
+ * @brief The size class of a chunk, or -1 if chunks of that size are not
+ * cached.
+ */
+static inline int mongory_chunk_cache_class(size_t chunk_size) {
+  size_t class_size = MONGORY_INITIAL_CHUNK_SIZE;
+  for (int i = 0; i < MONGORY_CHUNK_CACHE_CLASSES; i++, class_size *= 2) {
+    if (chunk_size == class_size) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void mongory_memory_pool_cache_clear(void) { mongory_chunk_cache_release(&mongory_chunk_cache_local); }
+
+mongory_memory_pool *mongory_memory_pool_scratch(void) {
+  mongory_chunk_cache *cache = &mongory_chunk_cache_local;
+  if (cache->scratch == NULL) {
+    mongory_memory_pool *scratch = mongory_memory_pool_new();
+    // The cache owns the pool; arm its release at thread exit.
+    if (scratch == NULL || mongory_chunk_cache_for_put() == NULL) {
+      if (scratch)
+        scratch->free(scratch);
+      return NULL;
+    }
+    cache->scratch = scratch;
+  }
+  return cache->scratch;
+}
+
+/**
+ * @brief Allocates a new memory chunk (node and its associated memory block),
+ * reusing one from the thread's cache when possible.
  *
- * Uses `calloc` to ensure memory is zero-initialized.
+ * The memory is not zeroed unless MONGORY_POOL_WIPE is defined or the chunk
+ * is mapped.
  *
+ * @param allocator The allocator of the pool.
  * @param chunk_size The size of the memory block to allocate for this chunk.
  * @return mongory_memory_node* Pointer to the new memory node, or NULL on
  * failure.
  */
-static inline mongory_memory_node *mongory_memory_chunk_new(size_t chunk_size) {
-  mongory_memory_node *node = calloc(1, sizeof(mongory_memory_node));
+static inline mongory_memory_node *mongory_memory_chunk_new(const mongory_allocator *allocator, size_t chunk_size) {
+  int size_class = allocator == &mongory_system_allocator ? mongory_chunk_cache_class(chunk_size) : -1;
+  mongory_chunk_cache *cache = &mongory_chunk_cache_local;
+  if (size_class >= 0 && cache->chunks[size_class]) {
+    mongory_memory_node *node = cache->chunks[size_class];
+    cache->chunks[size_class] = node->next;
+    cache->chunk_counts[size_class]--;
+    node->used = 0;
+    node->next = NULL;
+    return node;
+  }
+
+  mongory_memory_node *node = allocator->alloc(allocator->ctx, sizeof(mongory_memory_node));
   if (!node) {
     return NULL; // Failed to allocate node structure.
   }
 
-  void *mem = calloc(1, chunk_size);
+  void *mem = mongory_memory_chunk_memory_new(allocator, chunk_size);
   if (!mem) {
-    free(node);  // Clean up allocated node structure.
+    allocator->free(allocator->ctx, node, sizeof(mongory_memory_node)); // Clean up allocated node structure.
     return NULL; // Failed to allocate memory block for the chunk.
   }
 
@@ -89,11 +404,41 @@ static inline mongory_memory_node *mongory_memory_chunk_new(size_t chunk_size) {
   return node;
 }
 
+/**
+ * @brief Releases a list of chunks, keeping what fits in the thread's cache
+ * and freeing the rest.
+ * @param allocator The allocator of the chunks.
+ * @param head Pointer to the head of the chunk list to release.
+ */
+static inline void mongory_memory_chunk_list_release(const mongory_allocator *allocator, mongory_memory_node *head) {
+  mongory_chunk_cache *cache = NULL;
+  mongory_memory_node *node = head;
+  while (node) {
+    mongory_memory_node *next = node->next;
+    int size_class = allocator == &mongory_system_allocator ? mongory_chunk_cache_class(node->size) : -1;
+    if (size_class >= 0 && cache == NULL) {
+      cache = mongory_chunk_cache_for_put();
+    }
+    if (size_class >= 0 && cache != NULL && cache->chunk_counts[size_class] < MONGORY_CHUNK_CACHE_DEPTH) {
+#ifdef MONGORY_POOL_WIPE
+      memset(node->ptr, 0, node->size); // Clear memory for safety.
+#endif
+      node->next = cache->chunks[size_class];
+      cache->chunks[size_class] = node;
+      cache->chunk_counts[size_class]++;
+    } else {
+      mongory_memory_chunk_free(allocator, node);
+    }
+    node = next;
+  }
+}
+
 /**
  * @brief Grows the memory pool by adding a new, larger chunk.
  *
- * The new chunk size is at least double the previous chunk size, and large
- * enough to satisfy `request_size`. The new chunk becomes the `current` chunk.
+ * The new chunk size is double the previous chunk size, up to
+ * MONGORY_MAX_CHUNK_SIZE, and large enough to satisfy `request_size`. The new
+ * chunk becomes the `current` chunk.
  *
  * @param ctx Pointer to the memory pool's context.
  * @param request_size The minimum size required from the new chunk for an
@@ -101,17 +446,26 @@ static inline mongory_memory_node *mongory_memory_chunk_new(size_t chunk_size) {
  * @return true if growth was successful, false otherwise.
  */
 static inline bool mongory_memory_pool_grow(mongory_memory_pool_ctx *ctx, size_t request_size) {
-  if (ctx->current->next) {
+  // Chunks after the current one only hold memory given up by a reset or a
+  // rewind; reuse the first one that fits the request.
+  while (ctx->current->next) {
     ctx->current = ctx->current->next;
-    return true; // Already have a next chunk.
+    ctx->current->used = 0;
+    if (ctx->current->size >= request_size) {
+      return true; // Already have a next chunk.
+    }
   }
-  // Double the chunk size, ensuring it's at least as large as request_size.
-  ctx->chunk_size *= 2;
-  while (request_size > ctx->chunk_size) {
+  // Double the chunk size, up to the cap, until it fits request_size. A
+  // request larger than the cap gets a chunk of its own size.
+  do {
+    if (ctx->chunk_size >= MONGORY_MAX_CHUNK_SIZE) {
+      break;
+    }
     ctx->chunk_size *= 2;
-  }
+  } while (request_size > ctx->chunk_size);
+  size_t chunk_size = request_size > ctx->chunk_size ? request_size : ctx->chunk_size;
 
-  mongory_memory_node *new_chunk = mongory_memory_chunk_new(ctx->chunk_size);
+  mongory_memory_node *new_chunk = mongory_memory_chunk_new(ctx->allocator, chunk_size);
   if (!new_chunk) {
     return false; // Failed to create a new chunk.
   }
@@ -154,8 +508,146 @@ static inline void *mongory_memory_pool_alloc(mongory_memory_pool *pool, size_t
   return ptr;
 }
 
+/**
+ * @brief Returns the size class an allocation of `size` bytes is served from:
+ * the smallest class whose blocks all hold `size` bytes.
+ * @param size An 8-byte aligned size.
+ * @return The class, or -1 if the size has none.
+ */
+static inline int mongory_memory_slab_fit_class(size_t size) {
+  if (size == 0)
+    return -1;
+  if (size <= MONGORY_SLAB_SMALL_MAX)
+    return (int)(size / 8) - 1;
+  int shift = MONGORY_SLAB_LARGE_MIN_SHIFT;
+  while (((size_t)1 << shift) < size) {
+    if (++shift > MONGORY_SLAB_LARGE_MAX_SHIFT)
+      return -1;
+  }
+  return MONGORY_SLAB_SMALL_MAX / 8 + shift - MONGORY_SLAB_LARGE_MIN_SHIFT;
+}
+
+/**
+ * @brief Returns the size class a released block of `size` bytes is filed
+ * under: the largest class it can serve every request of.
+ * @param size An 8-byte aligned size.
+ * @return The class, or -1 if the block is too small to be kept.
+ */
+static inline int mongory_memory_slab_hold_class(size_t size) {
+  if (size == 0)
+    return -1;
+  if (size < ((size_t)1 << MONGORY_SLAB_LARGE_MIN_SHIFT))
+    return size <= MONGORY_SLAB_SMALL_MAX ? (int)(size / 8) - 1 : MONGORY_SLAB_SMALL_MAX / 8 - 1;
+  int shift = MONGORY_SLAB_LARGE_MIN_SHIFT;
+  while (shift < MONGORY_SLAB_LARGE_MAX_SHIFT && ((size_t)1 << (shift + 1)) <= size)
+    shift++;
+  return MONGORY_SLAB_SMALL_MAX / 8 + shift - MONGORY_SLAB_LARGE_MIN_SHIFT;
+}
+
+/**
+ * @brief Allocates memory from the pool's freelists, falling back to the
+ * current chunk. Implements `pool->alloc` once a block has been released.
+ *
+ * @param pool Pointer to the `mongory_memory_pool`.
+ * @param size The number of bytes to allocate.
+ * @return void* Pointer to the allocated memory, or NULL on failure.
+ */
+static void *mongory_memory_pool_slab_alloc(mongory_memory_pool *pool, size_t size) {
+  mongory_memory_pool_ctx *pool_ctx = (mongory_memory_pool_ctx *)pool->ctx;
+  int size_class = mongory_memory_slab_fit_class(MONGORY_ALIGN8(size));
+  if (size_class >= 0) {
+    void **block = (void **)pool_ctx->slab->free[size_class];
+    if (block) {
+      pool_ctx->slab->free[size_class] = *block;
+      return block;
+    }
+  }
+  return mongory_memory_pool_alloc(pool, size);
+}
+
+/**
+ * @brief Drops the freelists, e.g. when the memory they point into is given
+ * back by a reset or a rewind.
+ */
+static inline void mongory_memory_pool_slab_drop(mongory_memory_pool *pool) {
+  mongory_memory_pool_ctx *pool_ctx = (mongory_memory_pool_ctx *)pool->ctx;
+  pool_ctx->slab = NULL;
+  if (pool->alloc == mongory_memory_pool_slab_alloc)
+    pool->alloc = mongory_memory_pool_alloc;
+}
+
+/**
+ * @brief Gives a block back to the pool. Implements `pool->release`.
+ *
+ * The last block of the current chunk is returned to the chunk directly.
+ * Other blocks go onto the freelist of their size class; the freelists are
+ * set up on the first such release, and `alloc` then checks them first.
+ *
+ * @param pool Pointer to the `mongory_memory_pool`.
+ * @param ptr The block.
+ * @param size The size the block was allocated with.
+ */
+static void mongory_memory_pool_release(mongory_memory_pool *pool, void *ptr, size_t size) {
+  mongory_memory_pool_ctx *pool_ctx = (mongory_memory_pool_ctx *)pool->ctx;
+  mongory_memory_node *chunk = pool_ctx->current;
+  size = MONGORY_ALIGN8(size);
+  if (ptr == NULL || size == 0)
+    return;
+  if (size <= chunk->used && (char *)ptr + size == (char *)chunk->ptr + chunk->used) {
+    chunk->used -= size;
+    return;
+  }
+  int size_class = mongory_memory_slab_hold_class(size);
+  if (size_class < 0)
+    return;
+  if (pool_ctx->slab == NULL) {
+    if (pool_ctx->slab_storage == NULL) {
+      const mongory_allocator *allocator = pool_ctx->allocator;
+      pool_ctx->slab_storage = allocator->alloc(allocator->ctx, sizeof(mongory_memory_slab));
+      if (pool_ctx->slab_storage == NULL)
+        return; // The block is abandoned, as without a slab layer.
+    }
+    memset(pool_ctx->slab_storage, 0, sizeof(mongory_memory_slab));
+    pool_ctx->slab = pool_ctx->slab_storage;
+    if (pool->alloc == mongory_memory_pool_alloc)
+      pool->alloc = mongory_memory_pool_slab_alloc; // Left alone if wrapped by the caller.
+  }
+  *(void **)ptr = pool_ctx->slab->free[size_class];
+  pool_ctx->slab->free[size_class] = ptr;
+}
+
+/**
+ * @brief Grows the last allocation of the current chunk in place. Implements
+ * `pool->try_extend`.
+ *
+ * @param pool Pointer to the `mongory_memory_pool`.
+ * @param ptr The block to grow.
+ * @param old_size The current size of the block.
+ * @param new_size The requested size.
+ * @return true if the block was grown, false otherwise.
+ */
+static inline bool mongory_memory_pool_try_extend(mongory_memory_pool *pool, void *ptr, size_t old_size,
+                                                  size_t new_size) {
+  mongory_memory_pool_ctx *pool_ctx = (mongory_memory_pool_ctx *)pool->ctx;
+  mongory_memory_node *chunk = pool_ctx->current;
+  old_size = MONGORY_ALIGN8(old_size);
+  new_size = MONGORY_ALIGN8(new_size);
+
+  // Only the block ending exactly at the chunk's high-water mark can grow.
+  if (ptr == NULL || old_size > chunk->used || (char *)ptr + old_size != (char *)chunk->ptr + chunk->used) {
+    return false;
+  }
+  size_t start = chunk->used - old_size;
+  if (new_size > chunk->size - start) {
+    return false; // Not enough room left in the chunk.
+  }
+  chunk->used = start + new_size;
+  return true;
+}
+
 static inline void mongory_memory_pool_reset(mongory_memory_pool *pool) {
   mongory_memory_pool_ctx *pool_ctx = (mongory_memory_pool_ctx *)pool->ctx;
+  mongory_memory_pool_slab_drop(pool);
   pool_ctx->current = pool_ctx->head;
   mongory_memory_node *node = pool_ctx->head;
   while (node) {
@@ -165,57 +657,102 @@ static inline void mongory_memory_pool_reset(mongory_memory_pool *pool) {
 }
 
 /**
- * @brief Frees a linked list of memory nodes.
+ * @brief Records the current allocation position. Implements `pool->mark`.
+ * @param pool Pointer to the `mongory_memory_pool`.
+ * @return The position.
+ */
+static inline mongory_memory_pool_mark mongory_memory_pool_mark_position(mongory_memory_pool *pool) {
+  mongory_memory_pool_ctx *pool_ctx = (mongory_memory_pool_ctx *)pool->ctx;
+  mongory_memory_pool_mark mark = {pool_ctx->current, pool_ctx->current->used};
+  return mark;
+}
+
+/**
+ * @brief Rolls the pool back to a recorded position. Implements
+ * `pool->rewind`.
+ *
+ * Only the chunk of the mark is touched: the chunks after it are cleared
+ * lazily, when growth moves on to them. Released blocks are forgotten, since
+ * some of them may lie past the mark.
+ *
+ * @param pool Pointer to the `mongory_memory_pool`.
+ * @param mark A position returned by `pool->mark`.
+ */
+static inline void mongory_memory_pool_rewind(mongory_memory_pool *pool, mongory_memory_pool_mark mark) {
+  mongory_memory_pool_ctx *pool_ctx = (mongory_memory_pool_ctx *)pool->ctx;
+  mongory_memory_pool_slab_drop(pool);
+  pool_ctx->current = (mongory_memory_node *)mark.chunk;
+  pool_ctx->current->used = mark.offset;
+}
+
+/**
+ * @brief Frees a linked list of traced external memory blocks.
  *
  * Iterates through the list, freeing the memory block (`node->ptr`) and then
- * the node structure itself for each node. Memory blocks are zeroed out before
- * freeing for security/safety.
+ * the node structure itself, which came from the pool's allocator, for each
+ * node.
  *
+ * @param allocator The allocator of the nodes.
  * @param head Pointer to the head of the memory node list to free.
  */
-static inline void mongory_memory_pool_node_list_free(mongory_memory_node *head) {
+static inline void mongory_memory_pool_node_list_free(const mongory_allocator *allocator, mongory_memory_node *head) {
   mongory_memory_node *node = head;
   while (node) {
     mongory_memory_node *next = node->next;
     if (node->ptr) {
+#ifdef MONGORY_POOL_WIPE
       memset(node->ptr, 0, node->size); // Clear memory for safety.
-      free(node->ptr);                  // Free the actual memory block.
+#endif
+      free(node->ptr); // Free the actual memory block.
     }
-    memset(node, 0,
-           sizeof(mongory_memory_node)); // Clear the node structure itself.
-    free(node);                          // Free the node structure.
+    allocator->free(allocator->ctx, node, sizeof(mongory_memory_node)); // Free the node structure.
     node = next;
   }
 }
 
 /**
- * @brief Destroys the memory pool and frees all associated memory.
+ * @brief Destroys the memory pool and releases all associated memory.
  * Implements `pool->free`.
  *
- * Frees all memory chunks allocated by the pool (`ctx->head` list) and all
- * externally traced memory blocks (`ctx->extra` list). Then frees the pool
- * context and the pool structure itself.
+ * Releases all memory chunks allocated by the pool (`ctx->head` list) to the
+ * thread's cache, frees all externally traced memory blocks (`ctx->extra`
+ * list), then caches or frees the pool structure itself. The structure and
+ * first chunk of a pool over a caller's buffer are left to the caller.
  *
  * @param pool Pointer to the `mongory_memory_pool` to destroy.
  */
 static inline void mongory_memory_pool_destroy(mongory_memory_pool *pool) {
   if (!pool)
     return;
-  mongory_memory_pool_ctx *ctx = (mongory_memory_pool_ctx *)pool->ctx;
+  mongory_memory_pool_shell *shell = (mongory_memory_pool_shell *)pool;
+  const mongory_allocator *allocator = shell->ctx.allocator;
 
-  if (ctx) {
-    // Free the main list of memory chunks.
-    mongory_memory_pool_node_list_free(ctx->head);
-    // Free the list of externally traced memory chunks.
-    mongory_memory_pool_node_list_free(ctx->extra);
+  bool in_buffer = shell->ctx.in_buffer;
 
-    memset(ctx, 0,
-           sizeof(mongory_memory_pool_ctx)); // Clear the context structure.
-    free(ctx);                               // Free the context structure.
+  // Release the main list of memory chunks.
+  mongory_memory_chunk_list_release(allocator, in_buffer ? shell->ctx.head->next : shell->ctx.head);
+  // Free the list of externally traced memory chunks.
+  mongory_memory_pool_node_list_free(allocator, shell->ctx.extra);
+  if (shell->ctx.slab_storage) {
+    allocator->free(allocator->ctx, shell->ctx.slab_storage, sizeof(mongory_memory_slab));
   }
 
-  memset(pool, 0, sizeof(mongory_memory_pool)); // Clear the pool structure.
-  free(pool);                                   // Free the pool structure.
+  memset(shell, 0, sizeof(mongory_memory_pool_shell)); // Clear the pool and its context.
+  if (in_buffer) {
+    return;
+  }
+  if (allocator != &mongory_system_allocator) {
+    allocator->free(allocator->ctx, shell, sizeof(mongory_memory_pool_shell));
+    return;
+  }
+  mongory_chunk_cache *cache = mongory_chunk_cache_for_put();
+  if (cache != NULL && cache->shell_count < MONGORY_CHUNK_CACHE_DEPTH) {
+    shell->ctx.head = (mongory_memory_node *)cache->shells;
+    cache->shells = shell;
+    cache->shell_count++;
+    return;
+  }
+  free(shell); // Free the pool structure.
 }
 
 /**
@@ -235,7 +772,8 @@ static inline void mongory_memory_pool_trace(mongory_memory_pool *pool, void *pt
   mongory_memory_pool_ctx *pool_ctx = (mongory_memory_pool_ctx *)pool->ctx;
 
   // Create a new node to trace this external allocation.
-  mongory_memory_node *extra_alloc_tracer = calloc(1, sizeof(mongory_memory_node));
+  mongory_memory_node *extra_alloc_tracer =
+      pool_ctx->allocator->alloc(pool_ctx->allocator->ctx, sizeof(mongory_memory_node));
   if (!extra_alloc_tracer) {
     // Allocation of tracer node failed; cannot trace.
     // This might lead to a leak of 'ptr' if the caller expects the pool to
@@ -250,49 +788,116 @@ static inline void mongory_memory_pool_trace(mongory_memory_pool *pool, void *pt
 }
 
 /**
- * @brief Creates and initializes a new memory pool.
- *
- * Allocates the `mongory_memory_pool` structure, its internal
- * `mongory_memory_pool_ctx`, and the first memory chunk. Sets up the function
- * pointers for `alloc`, `free`, and `trace`.
- *
- * @return mongory_memory_pool* Pointer to the new pool, or NULL on failure.
+ * @brief Returns the allocator of pools created without one.
  */
-mongory_memory_pool *mongory_memory_pool_new() {
-  // Allocate the main pool structure.
-  mongory_memory_pool *pool = calloc(1, sizeof(mongory_memory_pool));
-  if (!pool) {
-    return NULL;
-  }
-
-  // Allocate the internal context for the pool.
-  mongory_memory_pool_ctx *ctx = calloc(1, sizeof(mongory_memory_pool_ctx));
-  if (!ctx) {
-    free(pool); // Clean up partially allocated pool.
-    return NULL;
-  }
+static inline const mongory_allocator *mongory_memory_pool_default_allocator(void) {
+  return mongory_internal_allocator ? mongory_internal_allocator : &mongory_system_allocator;
+}
 
-  // Allocate the first memory chunk.
-  mongory_memory_node *first_chunk = mongory_memory_chunk_new(MONGORY_INITIAL_CHUNK_SIZE);
-  if (!first_chunk) {
-    free(ctx);  // Clean up context.
-    free(pool); // Clean up pool structure.
-    return NULL;
-  }
+/**
+ * @brief Initializes a pool and its context around a first chunk. Sets up
+ * the function pointers for `alloc`, `free`, and `trace`.
+ * @param shell The pool structure and its context.
+ * @param allocator The allocator backing the pool.
+ * @param first_chunk The first chunk.
+ */
+static void mongory_memory_pool_setup(mongory_memory_pool_shell *shell, const mongory_allocator *allocator,
+                                      mongory_memory_node *first_chunk) {
+  mongory_memory_pool *pool = &shell->pool;
+  mongory_memory_pool_ctx *ctx = &shell->ctx;
 
   // Initialize context fields.
   ctx->chunk_size = MONGORY_INITIAL_CHUNK_SIZE;
   ctx->head = first_chunk;
   ctx->current = first_chunk;
   ctx->extra = NULL; // No extra traced allocations initially.
+  ctx->allocator = allocator;
+  ctx->slab = NULL; // Nothing released yet.
+  ctx->slab_storage = NULL;
+  ctx->in_buffer = false;
 
   // Initialize pool fields.
   pool->ctx = ctx;
   pool->alloc = mongory_memory_pool_alloc;
+  pool->try_extend = mongory_memory_pool_try_extend;
+  pool->release = mongory_memory_pool_release;
   pool->reset = mongory_memory_pool_reset;
+  pool->mark = mongory_memory_pool_mark_position;
+  pool->rewind = mongory_memory_pool_rewind;
   pool->free = mongory_memory_pool_destroy;
   pool->trace = mongory_memory_pool_trace;
   pool->error = NULL; // No error initially.
+}
+
+/**
+ * @brief Creates and initializes a new memory pool.
+ *
+ * Allocates the `mongory_memory_pool` structure, its internal
+ * `mongory_memory_pool_ctx`, and the first memory chunk.
+ *
+ * @param allocator The allocator backing the pool, or NULL for the default.
+ * @return mongory_memory_pool* Pointer to the new pool, or NULL on failure.
+ */
+mongory_memory_pool *mongory_memory_pool_new_with_allocator(const mongory_allocator *allocator) {
+  if (allocator == NULL) {
+    allocator = mongory_memory_pool_default_allocator();
+  }
+  // Take the pool structure and its context from the thread's cache, or
+  // allocate them together.
+  mongory_chunk_cache *cache = &mongory_chunk_cache_local;
+  mongory_memory_pool_shell *shell = allocator == &mongory_system_allocator ? cache->shells : NULL;
+  if (shell) {
+    cache->shells = (mongory_memory_pool_shell *)shell->ctx.head;
+    cache->shell_count--;
+  } else {
+    shell = allocator->alloc(allocator->ctx, sizeof(mongory_memory_pool_shell));
+    if (!shell) {
+      return NULL;
+    }
+  }
+
+  // Allocate the first memory chunk.
+  mongory_memory_node *first_chunk = mongory_memory_chunk_new(allocator, MONGORY_INITIAL_CHUNK_SIZE);
+  if (!first_chunk) {
+    allocator->free(allocator->ctx, shell, sizeof(mongory_memory_pool_shell)); // Clean up pool structure.
+    return NULL;
+  }
+
+  mongory_memory_pool_setup(shell, allocator, first_chunk);
+  return &shell->pool;
+}
+
+mongory_memory_pool *mongory_memory_pool_new() { return mongory_memory_pool_new_with_allocator(NULL); }
+
+/**
+ * @brief Creates a memory pool inside a caller's buffer.
+ *
+ * The buffer holds, in order, the pool structure and its context, the node
+ * of the first chunk and the first chunk itself.
+ *
+ * @param buffer The buffer.
+ * @param size The size of the buffer.
+ * @return mongory_memory_pool* The pool, or NULL if the buffer is too small.
+ */
+mongory_memory_pool *mongory_memory_pool_init_with_buffer(void *buffer, size_t size) {
+  if (buffer == NULL) {
+    return NULL;
+  }
+  size_t shell_size = MONGORY_ALIGN8(sizeof(mongory_memory_pool_shell));
+  size_t header = shell_size + MONGORY_ALIGN8(sizeof(mongory_memory_node));
+  char *start = (char *)MONGORY_ALIGN8((uintptr_t)buffer);
+  char *end = (char *)buffer + size;
+  if (start >= end || (size_t)(end - start) <= header) {
+    return NULL; // No room left for the first chunk.
+  }
+  mongory_memory_pool_shell *shell = (mongory_memory_pool_shell *)start;
+  mongory_memory_node *first_chunk = (mongory_memory_node *)(start + shell_size);
+  first_chunk->ptr = start + header;
+  first_chunk->size = (size_t)(end - start) - header;
+  first_chunk->used = 0;
+  first_chunk->next = NULL;
 
-  return pool;
+  mongory_memory_pool_setup(shell, mongory_memory_pool_default_allocator(), first_chunk);
+  shell->ctx.in_buffer = true;
+  return &shell->pool;
 }
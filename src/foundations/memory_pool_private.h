@@ -0,0 +1,29 @@
+#ifndef MONGORY_MEMORY_POOL_PRIVATE_H
+#define MONGORY_MEMORY_POOL_PRIVATE_H
+
+/**
+ * @file memory_pool_private.h
+ * @brief Per-thread pools shared inside the library, and the default pool
+ * allocator. This is an internal header for the library.
+ */
+
+#include "mongory-core/foundations/memory_pool.h"
+
+/**
+ * @brief The allocator of pools created without one, set by
+ * `mongory_allocator_set`. NULL stands for the system allocator.
+ */
+extern const mongory_allocator *mongory_internal_allocator;
+
+/**
+ * @brief Returns the calling thread's scratch pool, creating it on first use.
+ *
+ * Users mark the pool, allocate short-lived data and rewind it before
+ * returning, so the pool never grows past the deepest such use. It is freed
+ * with the thread's chunk cache (at thread exit or by
+ * `mongory_memory_pool_cache_clear`).
+ * @return The pool, or NULL if it could not be created.
+ */
+mongory_memory_pool *mongory_memory_pool_scratch(void);
+
+#endif /* MONGORY_MEMORY_POOL_PRIVATE_H */
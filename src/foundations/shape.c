@@ -0,0 +1,362 @@
+/**
+ * @file shape.c
+ * @brief Implements shapes and shaped tables.
+ *
+ * A shaped table is a `mongory_table` whose keys are held by a shared shape
+ * and whose values sit in a dense vector indexed by the keys' positions in
+ * that shape. It stores no keys or hashes of its own, so a million records
+ * of one schema share a single copy of their keys.
+ *
+ * The transition tree is shared by every thread. Creating and finding a
+ * transition happens under a mutex; everything else only reads shapes, which
+ * never change once published.
+ *
+ * The tree is bounded: no shape holds more than MONGORY_SHAPE_MAX_KEYS keys
+ * and the tree holds at most MONGORY_SHAPE_MAX_COUNT shapes. A table whose
+ * next key would pass either limit stops being shaped: its pairs move into a
+ * regular table, which it forwards every operation to from then on.
+ */
+#include "shape_private.h"
+#include "utils.h"
+#include "mongory-core/foundations/error.h"
+#include "mongory-core/foundations/memory_pool.h"
+#include <pthread.h>
+#include <string.h>
+
+/**
+ * @brief Initial number of value slots of a shaped table.
+ */
+#define MONGORY_SHAPED_TABLE_INIT_SIZE 8
+
+/**
+ * @brief Largest number of keys of a shape. Tables with more keys are not
+ * shaped.
+ */
+#define MONGORY_SHAPE_MAX_KEYS 64
+
+/**
+ * @brief Largest number of shapes in the transition tree, root included.
+ * Once it is reached, tables needing a new shape are not shaped.
+ */
+#define MONGORY_SHAPE_MAX_COUNT 4096
+
+/**
+ * @brief Internal representation of a shaped table.
+ */
+typedef struct mongory_shaped_table {
+  mongory_table base;     /**< Public part of the table structure. */
+  mongory_shape *shape;   /**< The table's keys. */
+  mongory_value **values; /**< One value per key of `shape`. */
+  size_t capacity;        /**< Allocated length of `values`. */
+  mongory_table *pairs;   /**< The regular table holding the pairs once the
+                               table is no longer shaped, NULL before. */
+} mongory_shaped_table;
+
+/**
+ * @brief Value stored in the slot of a deleted key. Only its address is used.
+ */
+static mongory_value mongory_shaped_table_deleted;
+
+static pthread_mutex_t mongory_shape_lock = PTHREAD_MUTEX_INITIALIZER;
+static mongory_memory_pool *mongory_shape_pool = NULL; /**< Owns every shape; guarded by the lock. */
+static mongory_shape *mongory_shape_root = NULL;        /**< The empty shape; guarded by the lock. */
+static size_t mongory_shape_count = 0;                  /**< Shapes in the tree; guarded by the lock. */
+size_t mongory_shape_epoch = 0;
+
+/**
+ * @brief Returns the root shape, creating the shape pool on first use. Must be
+ * called with the lock held.
+ */
+static mongory_shape *mongory_shape_root_get(void) {
+  if (mongory_shape_root != NULL)
+    return mongory_shape_root;
+  if (mongory_shape_pool == NULL) {
+    mongory_shape_pool = mongory_memory_pool_new();
+    if (mongory_shape_pool == NULL)
+      return NULL;
+  }
+  mongory_shape *root = MG_ALLOC_PTR(mongory_shape_pool, mongory_shape);
+  if (root == NULL)
+    return NULL;
+  root->parent = NULL;
+  root->count = 0;
+  root->keys = NULL;
+  root->key_lens = NULL;
+  root->key_hashes = NULL;
+  root->children = NULL;
+  root->next_sibling = NULL;
+  mongory_shape_root = root;
+  mongory_shape_count = 1;
+  return root;
+}
+
+/**
+ * @brief Finds or creates the child of `shape` that appends `key`. Must be
+ * called with the lock held.
+ * @param full Set to true when the child does not exist and the tree's limits
+ * forbid creating it.
+ * @return The child, or NULL if it is full or on allocation failure.
+ */
+static mongory_shape *mongory_shape_child(mongory_shape *shape, const char *key, size_t key_len, uint64_t hash,
+                                          bool *full) {
+  size_t last = shape->count;
+  for (mongory_shape *child = shape->children; child; child = child->next_sibling) {
+    if (child->key_hashes[last] == hash && child->key_lens[last] == key_len &&
+        memcmp(child->keys[last], key, key_len) == 0) {
+      return child;
+    }
+  }
+  if (last >= MONGORY_SHAPE_MAX_KEYS || mongory_shape_count >= MONGORY_SHAPE_MAX_COUNT) {
+    *full = true;
+    return NULL;
+  }
+
+  mongory_memory_pool *pool = mongory_shape_pool;
+  size_t count = shape->count + 1;
+  mongory_shape *child = MG_ALLOC_PTR(pool, mongory_shape);
+  char *key_copy = MG_ALLOC(pool, key_len + 1);
+  if (child == NULL || key_copy == NULL)
+    return NULL;
+  child->keys = MG_ALLOC_ARY(pool, char *, count);
+  child->key_lens = MG_ALLOC_ARY(pool, size_t, count);
+  child->key_hashes = MG_ALLOC_ARY(pool, uint64_t, count);
+  if (child->keys == NULL || child->key_lens == NULL || child->key_hashes == NULL)
+    return NULL;
+  if (last > 0) {
+    memcpy(child->keys, shape->keys, sizeof(char *) * last);
+    memcpy(child->key_lens, shape->key_lens, sizeof(size_t) * last);
+    memcpy(child->key_hashes, shape->key_hashes, sizeof(uint64_t) * last);
+  }
+  memcpy(key_copy, key, key_len + 1);
+  child->keys[last] = key_copy;
+  child->key_lens[last] = key_len;
+  child->key_hashes[last] = hash;
+  child->count = count;
+  child->parent = shape;
+  child->children = NULL;
+  child->next_sibling = shape->children;
+  shape->children = child;
+  mongory_shape_count++;
+  return child;
+}
+
+size_t mongory_shape_index(mongory_shape *shape, const char *key, size_t key_len, uint64_t hash) {
+  for (size_t i = 0; i < shape->count; i++) {
+    if (shape->key_hashes[i] == hash && shape->key_lens[i] == key_len && memcmp(shape->keys[i], key, key_len) == 0) {
+      return i;
+    }
+  }
+  return MONGORY_SHAPE_NOT_FOUND;
+}
+
+void mongory_shape_cleanup(void) {
+  pthread_mutex_lock(&mongory_shape_lock);
+  if (mongory_shape_pool != NULL) {
+    mongory_shape_pool->free(mongory_shape_pool);
+    mongory_shape_pool = NULL;
+  }
+  mongory_shape_root = NULL;
+  mongory_shape_count = 0;
+  mongory_shape_epoch++; // Shape pointers cached until now may be reused.
+  pthread_mutex_unlock(&mongory_shape_lock);
+}
+
+mongory_value *mongory_shaped_table_at(mongory_table *table, size_t index) {
+  if (index == MONGORY_SHAPE_NOT_FOUND)
+    return NULL;
+  mongory_value *value = ((mongory_shaped_table *)table)->values[index];
+  return value == &mongory_shaped_table_deleted ? NULL : value;
+}
+
+/**
+ * @brief Retrieves a value by a pre-hashed key. Implements `table->get_hashed`.
+ */
+static mongory_value *mongory_shaped_table_get_hashed(mongory_table *self, char *key, size_t key_len, uint64_t hash) {
+  mongory_shaped_table *table = (mongory_shaped_table *)self;
+  return mongory_shaped_table_at(self, mongory_shape_index(table->shape, key, key_len, hash));
+}
+
+/**
+ * @brief Retrieves a value by key. Implements `table->get`.
+ */
+static mongory_value *mongory_shaped_table_get(mongory_table *self, char *key) {
+  size_t key_len = strlen(key);
+  return mongory_shaped_table_get_hashed(self, key, key_len, mongory_table_hash_key(key, key_len));
+}
+
+// Table operations of a shaped table that was unshaped: they forward to the
+// regular table holding its pairs and keep `count` in step with it.
+
+static mongory_value *mongory_shaped_table_pairs_get(mongory_table *self, char *key) {
+  mongory_table *pairs = ((mongory_shaped_table *)self)->pairs;
+  return pairs->get(pairs, key);
+}
+
+static mongory_value *mongory_shaped_table_pairs_get_hashed(mongory_table *self, char *key, size_t key_len,
+                                                            uint64_t hash) {
+  mongory_table *pairs = ((mongory_shaped_table *)self)->pairs;
+  return pairs->get_hashed(pairs, key, key_len, hash);
+}
+
+static bool mongory_shaped_table_pairs_each(mongory_table *self, void *acc,
+                                            mongory_table_each_pair_callback_func callback) {
+  mongory_table *pairs = ((mongory_shaped_table *)self)->pairs;
+  return pairs->each(pairs, acc, callback);
+}
+
+static bool mongory_shaped_table_pairs_set(mongory_table *self, char *key, mongory_value *value) {
+  mongory_table *pairs = ((mongory_shaped_table *)self)->pairs;
+  bool ok = pairs->set(pairs, key, value);
+  self->count = pairs->count;
+  return ok;
+}
+
+static bool mongory_shaped_table_pairs_del(mongory_table *self, char *key) {
+  mongory_table *pairs = ((mongory_shaped_table *)self)->pairs;
+  bool ok = pairs->del(pairs, key);
+  self->count = pairs->count;
+  return ok;
+}
+
+static bool mongory_shaped_table_pairs_copy(char *key, mongory_value *value, void *acc) {
+  mongory_table *pairs = (mongory_table *)acc;
+  return pairs->set(pairs, key, value);
+}
+
+/**
+ * @brief Moves the pairs of a shaped table into a regular table and makes
+ * the table forward every operation to it. Used when the transition tree is
+ * full. The regular table copies the keys, so nothing refers to the shape
+ * afterwards.
+ * @return true if successful, false on allocation failure (the table is then
+ * left unchanged).
+ */
+static bool mongory_shaped_table_unshape(mongory_shaped_table *table) {
+  mongory_table *self = &table->base;
+  mongory_table *pairs = mongory_table_new_with_capacity(self->pool, self->count + 1);
+  if (pairs == NULL || !self->each(self, pairs, mongory_shaped_table_pairs_copy))
+    return false;
+  table->pairs = pairs;
+  self->get = mongory_shaped_table_pairs_get;
+  self->get_hashed = mongory_shaped_table_pairs_get_hashed;
+  self->each = mongory_shaped_table_pairs_each;
+  self->set = mongory_shaped_table_pairs_set;
+  self->del = mongory_shaped_table_pairs_del;
+  return true;
+}
+
+/**
+ * @brief Sets a key-value pair. Implements `table->set`.
+ * A known key is updated in place. A new key moves the table to the child
+ * shape and appends the value.
+ */
+static bool mongory_shaped_table_set(mongory_table *self, char *key, mongory_value *value) {
+  mongory_shaped_table *table = (mongory_shaped_table *)self;
+  size_t key_len = strlen(key);
+  uint64_t hash = mongory_table_hash_key(key, key_len);
+  size_t index = mongory_shape_index(table->shape, key, key_len, hash);
+  if (index != MONGORY_SHAPE_NOT_FOUND) {
+    if (table->values[index] == &mongory_shaped_table_deleted)
+      self->count++;
+    table->values[index] = value;
+    return true;
+  }
+
+  if (table->shape->count == table->capacity) {
+    size_t capacity = table->capacity * 2;
+    mongory_value **values = MG_ALLOC_ARY(self->pool, mongory_value *, capacity);
+    if (values == NULL) {
+      self->pool->error = &MONGORY_ALLOC_ERROR;
+      return false;
+    }
+    memcpy(values, table->values, sizeof(mongory_value *) * table->shape->count);
+    table->values = values;
+    table->capacity = capacity;
+  }
+
+  bool full = false;
+  pthread_mutex_lock(&mongory_shape_lock);
+  mongory_shape *child = mongory_shape_child(table->shape, key, key_len, hash, &full);
+  pthread_mutex_unlock(&mongory_shape_lock);
+  if (full) {
+    if (!mongory_shaped_table_unshape(table)) {
+      self->pool->error = &MONGORY_ALLOC_ERROR;
+      return false;
+    }
+    return self->set(self, key, value);
+  }
+  if (child == NULL) {
+    self->pool->error = &MONGORY_ALLOC_ERROR;
+    return false;
+  }
+  table->values[table->shape->count] = value;
+  table->shape = child;
+  self->count++;
+  return true;
+}
+
+/**
+ * @brief Deletes a key. Implements `table->del`.
+ * The key stays in the shape, so the table keeps sharing it; only its slot is
+ * marked deleted.
+ */
+static bool mongory_shaped_table_del(mongory_table *self, char *key) {
+  mongory_shaped_table *table = (mongory_shaped_table *)self;
+  size_t key_len = strlen(key);
+  size_t index = mongory_shape_index(table->shape, key, key_len, mongory_table_hash_key(key, key_len));
+  if (index == MONGORY_SHAPE_NOT_FOUND || table->values[index] == &mongory_shaped_table_deleted)
+    return false;
+  table->values[index] = &mongory_shaped_table_deleted;
+  self->count--;
+  return true;
+}
+
+/**
+ * @brief Iterates over the pairs in insertion order. Implements `table->each`.
+ */
+static bool mongory_shaped_table_each(mongory_table *self, void *acc, mongory_table_each_pair_callback_func callback) {
+  mongory_shaped_table *table = (mongory_shaped_table *)self;
+  mongory_shape *shape = table->shape;
+  mongory_value **values = table->values;
+  for (size_t i = 0; i < shape->count; i++) {
+    if (values[i] == &mongory_shaped_table_deleted)
+      continue;
+    if (!callback(shape->keys[i], values[i], acc))
+      return false;
+  }
+  return true;
+}
+
+mongory_shape *mongory_table_shape(mongory_table *table) {
+  if (table->get != mongory_shaped_table_get)
+    return NULL;
+  return ((mongory_shaped_table *)table)->shape;
+}
+
+mongory_table *mongory_table_new_shaped(mongory_memory_pool *pool) {
+  if (!pool)
+    return NULL; // Must have a valid pool.
+
+  pthread_mutex_lock(&mongory_shape_lock);
+  mongory_shape *root = mongory_shape_root_get();
+  pthread_mutex_unlock(&mongory_shape_lock);
+  mongory_shaped_table *table = MG_ALLOC_PTR(pool, mongory_shaped_table);
+  mongory_value **values = MG_ALLOC_ARY(pool, mongory_value *, MONGORY_SHAPED_TABLE_INIT_SIZE);
+  if (root == NULL || table == NULL || values == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+
+  table->base.pool = pool;
+  table->base.count = 0;
+  table->base.get = mongory_shaped_table_get;
+  table->base.get_hashed = mongory_shaped_table_get_hashed;
+  table->base.each = mongory_shaped_table_each;
+  table->base.set = mongory_shaped_table_set;
+  table->base.del = mongory_shaped_table_del;
+  table->shape = root;
+  table->values = values;
+  table->capacity = MONGORY_SHAPED_TABLE_INIT_SIZE;
+  table->pairs = NULL;
+  return &table->base;
+}
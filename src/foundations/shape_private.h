@@ -0,0 +1,87 @@
+#ifndef MONGORY_SHAPE_PRIVATE_H
+#define MONGORY_SHAPE_PRIVATE_H
+
+/**
+ * @file shape_private.h
+ * @brief Shapes (hidden classes) backing shaped tables. This is an internal
+ * header for the library.
+ *
+ * A shape is an ordered list of keys. Shapes form a transition tree rooted at
+ * the empty shape: adding a key to a shaped table moves it to the child shape
+ * for that key, creating the child the first time. Tables built with the same
+ * key sequence therefore share one shape, and a key's position in the shape
+ * is the index of its value in every such table. Shapes are immutable once
+ * created.
+ *
+ * Growth and lifetime: the tree is process-wide and only grows, so it is
+ * bounded (see MONGORY_SHAPE_MAX_KEYS and MONGORY_SHAPE_MAX_COUNT in
+ * shape.c). Past either bound, tables fall back to regular, unshaped storage
+ * and the tree stops growing; workloads with many distinct key sets therefore
+ * lose the shape fast path rather than memory. Every transition lookup takes
+ * the tree's mutex. Shapes are freed only by `mongory_cleanup`, which also
+ * advances `mongory_shape_epoch`: anything caching shape pointers (the inline
+ * caches of field matchers) must compare the epoch it filled them under and
+ * drop them when it changed, since a freed shape's address can be reused.
+ */
+
+#include "mongory-core/foundations/table.h"
+#include "mongory-core/foundations/value.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Index returned for a key that is not part of a shape.
+ */
+#define MONGORY_SHAPE_NOT_FOUND ((size_t)-1)
+
+/**
+ * @brief An interned, immutable key list.
+ */
+typedef struct mongory_shape {
+  struct mongory_shape *parent;       /**< Shape without the last key, NULL for the root. */
+  size_t count;                       /**< Number of keys. */
+  char **keys;                        /**< The keys, in insertion order. */
+  size_t *key_lens;                   /**< Length of each key. */
+  uint64_t *key_hashes;               /**< `mongory_table_hash_key` of each key. */
+  struct mongory_shape *children;     /**< First shape extending this one by a key. */
+  struct mongory_shape *next_sibling; /**< Next shape sharing this shape's parent. */
+} mongory_shape;
+
+/**
+ * @brief Generation of the transition tree, advanced each time
+ * `mongory_shape_cleanup` frees it. Written only by the cleanup.
+ */
+extern size_t mongory_shape_epoch;
+
+/**
+ * @brief Returns the shape of a table.
+ * @param table Any table.
+ * @return The table's shape, or NULL if it is not a shaped table.
+ */
+mongory_shape *mongory_table_shape(mongory_table *table);
+
+/**
+ * @brief Finds the position of a key in a shape.
+ * @param shape The shape.
+ * @param key The key.
+ * @param key_len The length of `key`.
+ * @param hash `mongory_table_hash_key(key, key_len)`.
+ * @return The index of the key, or MONGORY_SHAPE_NOT_FOUND.
+ */
+size_t mongory_shape_index(mongory_shape *shape, const char *key, size_t key_len, uint64_t hash);
+
+/**
+ * @brief Reads the value stored at a shape index of a shaped table.
+ * @param table A shaped table.
+ * @param index An index of the table's shape, or MONGORY_SHAPE_NOT_FOUND.
+ * @return The value, or NULL if the index is MONGORY_SHAPE_NOT_FOUND or the
+ * key was deleted.
+ */
+mongory_value *mongory_shaped_table_at(mongory_table *table, size_t index);
+
+/**
+ * @brief Frees every shape. Called by `mongory_cleanup`.
+ */
+void mongory_shape_cleanup(void);
+
+#endif /* MONGORY_SHAPE_PRIVATE_H */
@@ -0,0 +1,186 @@
+/**
+ * @file sink.c
+ * @brief Implements the output sinks and their scalar writers.
+ *
+ * Numbers are formatted without `printf` where possible: integers are
+ * converted digit by digit into a stack buffer, and so are integral doubles.
+ * Only doubles with a fractional part go through `snprintf`.
+ */
+#include "mongory-core/foundations/sink.h"
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Largest double below which every integer is exactly representable.
+ */
+#define MONGORY_SINK_EXACT_DOUBLE_LIMIT 9007199254740992.0
+
+static inline void mongory_sink_reset(mongory_sink *sink, mongory_sink_write_func write) {
+  sink->write = write;
+  sink->ctx = NULL;
+  sink->fd = -1;
+  sink->buffer = NULL;
+  sink->capacity = 0;
+  sink->size = 0;
+  sink->failed = false;
+  sink->pool = NULL;
+}
+
+void mongory_sink_init(mongory_sink *sink, mongory_sink_write_func write, void *ctx) {
+  mongory_sink_reset(sink, write);
+  sink->ctx = ctx;
+}
+
+static bool mongory_sink_file_write(mongory_sink *sink, const char *data, size_t len) {
+  return fwrite(data, 1, len, (FILE *)sink->ctx) == len;
+}
+
+void mongory_sink_file_init(mongory_sink *sink, FILE *file) {
+  mongory_sink_reset(sink, mongory_sink_file_write);
+  sink->ctx = file;
+}
+
+static bool mongory_sink_fd_write(mongory_sink *sink, const char *data, size_t len) {
+  while (len > 0) {
+    ssize_t written = write(sink->fd, data, len);
+    if (written < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    data += written;
+    len -= (size_t)written;
+  }
+  return true;
+}
+
+void mongory_sink_fd_init(mongory_sink *sink, int fd) {
+  mongory_sink_reset(sink, mongory_sink_fd_write);
+  sink->fd = fd;
+}
+
+static bool mongory_sink_buffer_write(mongory_sink *sink, const char *data, size_t len) {
+  size_t room = sink->capacity - 1 - sink->size;
+  bool fits = len <= room;
+  if (!fits)
+    len = room;
+  memcpy(sink->buffer + sink->size, data, len);
+  sink->buffer[sink->size + len] = '\0';
+  if (!fits)
+    sink->size += len; // `mongory_sink_write` only counts accepted writes.
+  return fits;
+}
+
+void mongory_sink_buffer_init(mongory_sink *sink, char *buffer, size_t capacity) {
+  mongory_sink_reset(sink, mongory_sink_buffer_write);
+  sink->buffer = buffer;
+  sink->capacity = capacity;
+  buffer[0] = '\0';
+}
+
+bool mongory_sink_write(mongory_sink *sink, const char *data, size_t len) {
+  if (sink->failed)
+    return false;
+  if (len == 0)
+    return true;
+  if (!sink->write(sink, data, len)) {
+    sink->failed = true;
+    return false;
+  }
+  sink->size += len;
+  return true;
+}
+
+bool mongory_sink_puts(mongory_sink *sink, const char *str) { return mongory_sink_write(sink, str, strlen(str)); }
+
+/**
+ * @brief Formats the digits of an unsigned integer, right-aligned, into the
+ * end of `end`'s buffer.
+ * @return The first digit.
+ */
+static inline char *mongory_sink_format_digits(char *end, uint64_t n) {
+  do {
+    *--end = (char)('0' + n % 10);
+    n /= 10;
+  } while (n != 0);
+  return end;
+}
+
+bool mongory_sink_write_int(mongory_sink *sink, int64_t i) {
+  char digits[24];
+  char *end = digits + sizeof(digits);
+  uint64_t magnitude = i < 0 ? (uint64_t)0 - (uint64_t)i : (uint64_t)i;
+  char *start = mongory_sink_format_digits(end, magnitude);
+  if (i < 0)
+    *--start = '-';
+  return mongory_sink_write(sink, start, (size_t)(end - start));
+}
+
+bool mongory_sink_write_double(mongory_sink *sink, double d) {
+  if (!isfinite(d))
+    return mongory_sink_write(sink, "null", 4);
+
+  if (d == floor(d) && fabs(d) < MONGORY_SINK_EXACT_DOUBLE_LIMIT) {
+    char digits[24];
+    char *end = digits + sizeof(digits);
+    *--end = '0';
+    *--end = '.';
+    char *start = mongory_sink_format_digits(end, (uint64_t)fabs(d));
+    if (signbit(d))
+      *--start = '-';
+    return mongory_sink_write(sink, start, (size_t)(digits + sizeof(digits) - start));
+  }
+
+  char buffer[32];
+  int len = snprintf(buffer, sizeof(buffer), "%.15g", d);
+  if (strtod(buffer, NULL) != d)
+    len = snprintf(buffer, sizeof(buffer), "%.17g", d);
+  return mongory_sink_write(sink, buffer, (size_t)len);
+}
+
+bool mongory_sink_write_string(mongory_sink *sink, const char *s, size_t len) {
+  static const char hex[] = "0123456789abcdef";
+  mongory_sink_write(sink, "\"", 1);
+  size_t run = 0; // Start of the bytes not written yet.
+  for (size_t i = 0; i < len; i++) {
+    unsigned char c = (unsigned char)s[i];
+    if (c >= 0x20 && c != '"' && c != '\\')
+      continue;
+    mongory_sink_write(sink, s + run, i - run);
+    run = i + 1;
+    char escape[6] = {'\\', (char)c, 0, 0, 0, 0};
+    size_t escape_len = 2;
+    switch (c) {
+    case '"':
+    case '\\':
+      break;
+    case '\n':
+      escape[1] = 'n';
+      break;
+    case '\r':
+      escape[1] = 'r';
+      break;
+    case '\t':
+      escape[1] = 't';
+      break;
+    case '\b':
+      escape[1] = 'b';
+      break;
+    case '\f':
+      escape[1] = 'f';
+      break;
+    default:
+      memcpy(escape + 1, "u00", 3);
+      escape[4] = hex[c >> 4];
+      escape[5] = hex[c & 0xF];
+      escape_len = 6;
+      break;
+    }
+    mongory_sink_write(sink, escape, escape_len);
+  }
+  mongory_sink_write(sink, s + run, len - run);
+  return mongory_sink_write(sink, "\"", 1);
+}
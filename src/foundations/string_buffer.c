@@ -30,18 +30,21 @@ static inline void mongory_string_buffer_grow(mongory_string_buffer *buffer, siz
   char *previous_buffer = buffer->buffer;
   buffer->buffer = (char *)MG_ALLOC(buffer->pool, buffer->capacity);
   if (previous_buffer) {
-    strcpy(buffer->buffer, previous_buffer);
+    memcpy(buffer->buffer, previous_buffer, buffer->size + 1);
   }
 }
 
-void mongory_string_buffer_append(mongory_string_buffer *buffer, const char *str) {
-  size_t len = strlen(str);
+void mongory_string_buffer_append_n(mongory_string_buffer *buffer, const char *data, size_t len) {
   mongory_string_buffer_grow(buffer, len);
-  strcpy(buffer->buffer + buffer->size, str);
+  memcpy(buffer->buffer + buffer->size, data, len);
   buffer->size += len;
   buffer->buffer[buffer->size] = '\0';
 }
 
+void mongory_string_buffer_append(mongory_string_buffer *buffer, const char *str) {
+  mongory_string_buffer_append_n(buffer, str, strlen(str));
+}
+
 void mongory_string_buffer_appendf(mongory_string_buffer *buffer, const char *format, ...) {
   va_list args;
   va_start(args, format);
@@ -63,3 +66,13 @@ void mongory_string_buffer_clear(mongory_string_buffer *buffer) {
   buffer->size = 0;
   buffer->buffer[0] = '\0';
 }
+
+static bool mongory_sink_string_buffer_write(mongory_sink *sink, const char *data, size_t len) {
+  mongory_string_buffer_append_n((mongory_string_buffer *)sink->ctx, data, len);
+  return true;
+}
+
+void mongory_sink_string_buffer_init(mongory_sink *sink, mongory_string_buffer *buffer) {
+  mongory_sink_init(sink, mongory_sink_string_buffer_write, buffer);
+  sink->pool = buffer->pool;
+}
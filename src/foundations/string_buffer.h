@@ -19,6 +19,14 @@ mongory_string_buffer *mongory_string_buffer_new(mongory_memory_pool *pool);
  */
 void mongory_string_buffer_append(mongory_string_buffer *buffer, const char *str);
 
+/**
+ * @brief Appends `len` bytes to the buffer.
+ * @param buffer The buffer to append to.
+ * @param data The bytes to append.
+ * @param len The number of bytes.
+ */
+void mongory_string_buffer_append_n(mongory_string_buffer *buffer, const char *data, size_t len);
+
 /**
  * @brief Appends a formatted string to the buffer.
  * @param buffer The buffer to append to.
@@ -46,4 +54,12 @@ void mongory_string_buffer_clear(mongory_string_buffer *buffer);
  */
 void mongory_string_buffer_free(mongory_string_buffer *buffer);
 
+/**
+ * @brief Initializes a sink appending to the buffer. The sink's scratch pool
+ * is the buffer's pool.
+ * @param sink The sink to initialize.
+ * @param buffer The buffer to append to.
+ */
+void mongory_sink_string_buffer_init(mongory_sink *sink, mongory_string_buffer *buffer);
+
 #endif
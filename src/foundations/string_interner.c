@@ -0,0 +1,133 @@
+/**
+ * @file string_interner.c
+ * @brief Implements the string interner.
+ *
+ * Entries are kept in an open-addressing table with linear probing, keyed by
+ * their stored hash, and the table doubles once it is half full.
+ */
+#include "string_interner_private.h"
+#include "utils.h"
+#include "mongory-core/foundations/error.h"
+#include <string.h>
+
+/**
+ * @brief Smallest table capacity.
+ */
+#define MONGORY_STRING_INTERNER_MIN_CAPACITY 16
+
+struct mongory_string_interner {
+  mongory_memory_pool *pool;              /**< Pool owning the interner and its entries. */
+  mongory_string_intern_entry **entries;  /**< Slots, NULL when empty. */
+  size_t capacity;                        /**< Number of slots, a power of two. */
+  size_t count;                           /**< Number of entries. */
+};
+
+static mongory_string_intern_entry **mongory_string_interner_alloc_slots(mongory_memory_pool *pool, size_t capacity) {
+  mongory_string_intern_entry **entries = MG_ALLOC_ARY(pool, mongory_string_intern_entry *, capacity);
+  if (entries == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  memset(entries, 0, sizeof(mongory_string_intern_entry *) * capacity);
+  return entries;
+}
+
+/**
+ * @brief Finds the slot holding `s`, or the empty slot where it belongs.
+ */
+static mongory_string_intern_entry **mongory_string_interner_find(mongory_string_intern_entry **entries,
+                                                                  size_t capacity, uint64_t hash, const char *s,
+                                                                  size_t len) {
+  size_t mask = capacity - 1;
+  for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask) {
+    mongory_string_intern_entry *entry = entries[i];
+    if (entry == NULL)
+      return &entries[i];
+    if (entry->hash == hash && entry->len == len && memcmp(entry->bytes, s, len) == 0)
+      return &entries[i];
+  }
+}
+
+static bool mongory_string_interner_grow(mongory_string_interner *interner) {
+  size_t capacity = interner->capacity * 2;
+  mongory_string_intern_entry **entries = mongory_string_interner_alloc_slots(interner->pool, capacity);
+  if (entries == NULL)
+    return false;
+  for (size_t i = 0; i < interner->capacity; i++) {
+    mongory_string_intern_entry *entry = interner->entries[i];
+    if (entry != NULL)
+      *mongory_string_interner_find(entries, capacity, entry->hash, entry->bytes, entry->len) = entry;
+  }
+  interner->entries = entries;
+  interner->capacity = capacity;
+  return true;
+}
+
+mongory_string_interner *mongory_string_interner_new(mongory_memory_pool *pool) {
+  if (!pool)
+    return NULL;
+  mongory_string_interner *interner = MG_ALLOC_PTR(pool, mongory_string_interner);
+  if (interner == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  interner->pool = pool;
+  interner->capacity = MONGORY_STRING_INTERNER_MIN_CAPACITY;
+  interner->count = 0;
+  interner->entries = mongory_string_interner_alloc_slots(pool, interner->capacity);
+  if (interner->entries == NULL)
+    return NULL;
+  return interner;
+}
+
+/**
+ * @brief Returns the entry for `s`, adding it on first sight.
+ */
+static mongory_string_intern_entry *mongory_string_interner_intern(mongory_string_interner *interner, const char *s,
+                                                                   size_t len) {
+  uint64_t hash = mongory_hash_bytes(s, len);
+  mongory_string_intern_entry **slot =
+      mongory_string_interner_find(interner->entries, interner->capacity, hash, s, len);
+  if (*slot != NULL)
+    return *slot;
+
+  if ((interner->count + 1) * 2 > interner->capacity) {
+    if (!mongory_string_interner_grow(interner))
+      return NULL;
+    slot = mongory_string_interner_find(interner->entries, interner->capacity, hash, s, len);
+  }
+  mongory_memory_pool *pool = interner->pool;
+  mongory_string_intern_entry *entry = MG_ALLOC(pool, sizeof(mongory_string_intern_entry) + len + 1);
+  if (entry == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  entry->hash = hash;
+  entry->interner = interner;
+  entry->len = (uint32_t)len;
+  memcpy(entry->bytes, s, len);
+  entry->bytes[len] = '\0';
+  *slot = entry;
+  interner->count++;
+  return entry;
+}
+
+mongory_value *mongory_string_interner_wrap(mongory_string_interner *interner, mongory_memory_pool *pool,
+                                            const char *s, size_t len) {
+  if (!interner || !pool || !s)
+    return NULL;
+  if (len > MONGORY_STRING_MAX_LEN) {
+    // Let the value constructor report the length error.
+    return mongory_value_wrap_s_borrowed(pool, s, len);
+  }
+  mongory_string_intern_entry *entry = mongory_string_interner_intern(interner, s, len);
+  if (entry == NULL)
+    return NULL;
+  mongory_value *value = mongory_value_wrap_s_borrowed(pool, entry->bytes, len);
+  if (value == NULL)
+    return NULL;
+  value->interned = 1;
+  return value;
+}
+
+size_t mongory_string_interner_count(mongory_string_interner *interner) { return interner->count; }
@@ -0,0 +1,37 @@
+#ifndef MONGORY_STRING_INTERNER_PRIVATE_H
+#define MONGORY_STRING_INTERNER_PRIVATE_H
+
+/**
+ * @file string_interner_private.h
+ * @brief Layout of interned strings. This is an internal header for the
+ * library.
+ *
+ * The bytes of an interned string are the tail of an entry whose header
+ * records the string's hash and its interner. An interned value's `data.s`
+ * points at the bytes, so the header sits right before them.
+ */
+
+#include "mongory-core/foundations/string_interner.h"
+#include "mongory-core/foundations/value.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief One interned string.
+ */
+typedef struct mongory_string_intern_entry {
+  uint64_t hash;                              /**< `mongory_hash_bytes` of the bytes. */
+  const mongory_string_interner *interner;    /**< The interner owning the entry. */
+  uint32_t len;                               /**< Byte length, without the terminator. */
+  char bytes[];                               /**< The bytes, '\0'-terminated. */
+} mongory_string_intern_entry;
+
+/**
+ * @brief Returns the entry of an interned string value.
+ * @param value A string value with `interned` set.
+ */
+static inline mongory_string_intern_entry *mongory_string_intern_entry_of(mongory_value *value) {
+  return (mongory_string_intern_entry *)(value->data.s - offsetof(mongory_string_intern_entry, bytes));
+}
+
+#endif /* MONGORY_STRING_INTERNER_PRIVATE_H */
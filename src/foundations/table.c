@@ -3,55 +3,98 @@
  * @brief Implements the mongory_table hash table.
  *
  * This file contains the internal logic for a hash table that maps string keys
- * to mongory_value pointers. It uses separate chaining for collision resolution,
- * where each bucket in the hash table is a linked list of nodes. The underlying
- * storage for buckets is a mongory_array. The table automatically rehashes
- * when the load factor exceeds a threshold.
+ * to mongory_value pointers. It is an open-addressing table in the style of
+ * SwissTable: a power-of-two array of slots is paired with an array of one
+ * byte control tags. A tag is either EMPTY, DELETED, or the low seven bits of
+ * the key's hash. Lookups probe a group of 16 tags at once (with SSE2 when it
+ * is available) and only look at the slots whose tag matches, comparing the
+ * stored full hash and key length before the key bytes. The table grows by
+ * doubling once seven eighths of the slots are in use, re-inserting entries
+ * with their stored hashes.
+ *
+ * Most documents and conditions have only a few keys, so a table starts out
+ * small: its slots are a flat array filled in insertion order, without
+ * control tags, and lookups scan it comparing stored hashes. A small table
+ * holds at most MONGORY_TABLE_SMALL_MAX entries; one more turns it into a
+ * hash table for good.
  */
-#include "array_private.h" // For mongory_array_private details if needed
 #include <mongory-core/foundations/array.h>
 #include <mongory-core/foundations/config.h> // For mongory_string_cpy
 #include <mongory-core/foundations/table.h>
 #include <mongory-core/foundations/value.h>
 #include "utils.h"
 #include <stdarg.h>
-#include <string.h> // For strcmp, strlen
+#include <stdint.h>
+#include <string.h> // For memcmp, memcpy, strlen
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MONGORY_TABLE_SSE2
+#endif
+
+/**
+ * @def MONGORY_TABLE_GROUP_WIDTH
+ * @brief Number of control tags probed together.
+ */
+#define MONGORY_TABLE_GROUP_WIDTH 16
 
 /**
  * @def MONGORY_TABLE_INIT_SIZE
- * @brief Initial capacity (number of buckets) for a new hash table.
- * Should ideally be a prime number.
+ * @brief Initial capacity (number of slots) for a new hash table. Must be a
+ * power of two and at least one group wide.
+ */
+#define MONGORY_TABLE_INIT_SIZE 16
+
+/**
+ * @def MONGORY_TABLE_SMALL_MAX
+ * @brief Largest number of entries a small, flat table holds before it
+ * becomes a hash table.
+ */
+#define MONGORY_TABLE_SMALL_MAX 8
+
+/**
+ * @def MONGORY_TABLE_SMALL_INIT_SIZE
+ * @brief Initial number of slots of a small table created without a
+ * capacity.
  */
-#define MONGORY_TABLE_INIT_SIZE 17
+#define MONGORY_TABLE_SMALL_INIT_SIZE 4
 
 /**
- * @def MONGORY_TABLE_LOAD_FACTOR
- * @brief The maximum load factor before the table is rehashed.
- * Load factor = count / capacity.
+ * @def MONGORY_TABLE_CTRL_EMPTY
+ * @brief Control tag of a slot that was never used. Ends a probe sequence.
  */
-#define MONGORY_TABLE_LOAD_FACTOR 0.75
+#define MONGORY_TABLE_CTRL_EMPTY ((uint8_t)0x80)
 
 /**
- * @struct mongory_table_node
- * @brief Represents a node in a hash table bucket's linked list.
- * Stores a key-value pair and a pointer to the next node in the chain.
+ * @def MONGORY_TABLE_CTRL_DELETED
+ * @brief Control tag of a slot whose entry was deleted. Probing continues past
+ * it.
  */
-typedef struct mongory_table_node {
-  char *key;                       /**< The string key for this entry. */
-  mongory_value *value;            /**< The mongory_value associated with the key. */
-  struct mongory_table_node *next; /**< Pointer to the next node in the collision chain. */
-} mongory_table_node;
+#define MONGORY_TABLE_CTRL_DELETED ((uint8_t)0xFE)
+
+/**
+ * @struct mongory_table_slot
+ * @brief Stores one key-value pair along with the key's hash and length.
+ */
+typedef struct mongory_table_slot {
+  char *key;            /**< The string key for this entry. */
+  size_t key_len;       /**< Length of `key`, without the terminator. */
+  uint64_t hash;        /**< Full hash of `key`. */
+  mongory_value *value; /**< The mongory_value associated with the key. */
+} mongory_table_slot;
 
 /**
  * @struct mongory_table_internal
  * @brief Internal representation of the hash table.
- * Extends the public mongory_table structure with capacity information
- * and the underlying array used for buckets.
+ * Extends the public mongory_table structure with the slot and control arrays.
  */
 typedef struct mongory_table_internal {
-  mongory_table base;   /**< Public part of the table structure. */
-  size_t capacity;      /**< Current number of buckets in the table. */
-  mongory_array *array; /**< Array of mongory_table_node pointers (the buckets). */
+  mongory_table base;        /**< Public part of the table structure. */
+  size_t capacity;           /**< Number of slots, a power of two once hashed. */
+  size_t deleted;            /**< Number of DELETED tags. */
+  uint8_t *ctrl;             /**< `capacity + GROUP_WIDTH` tags; the tail mirrors the first group. NULL
+                                  while the table is small. */
+  mongory_table_slot *slots; /**< `capacity` slots; the first `count` ones while the table is small. */
 } mongory_table_internal;
 
 // ============================================================================
@@ -62,170 +105,198 @@ typedef struct mongory_table_internal {
 // ============================================================================
 
 /**
- * @brief Allocates a new mongory_table_node from the table's memory pool.
- * @param self Pointer to the mongory_table (used to access its memory pool).
- * @return mongory_table_node* Pointer to the new node, or NULL on failure.
+ * @brief The position where probing starts, from the high bits of the hash.
+ */
+static inline size_t mongory_table_h1(uint64_t hash) { return (size_t)(hash >> 7); }
+
+/**
+ * @brief The control tag of a full slot, from the low seven bits of the hash.
  */
-static inline mongory_table_node *mongory_table_node_new(mongory_table *self) {
-  return MG_ALLOC_PTR(self->pool, mongory_table_node);
+static inline uint8_t mongory_table_h2(uint64_t hash) { return (uint8_t)(hash & 0x7F); }
+
+/**
+ * @brief Returns a bit mask of the tags of the group starting at `ctrl` that
+ * are equal to `tag`. Bit i stands for `ctrl[i]`.
+ */
+static inline uint32_t mongory_table_group_match(const uint8_t *ctrl, uint8_t tag) {
+#ifdef MONGORY_TABLE_SSE2
+  __m128i group = _mm_loadu_si128((const __m128i *)ctrl);
+  return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)tag)));
+#else
+  uint32_t mask = 0;
+  for (int i = 0; i < MONGORY_TABLE_GROUP_WIDTH; i++) {
+    mask |= (uint32_t)(ctrl[i] == tag) << i;
+  }
+  return mask;
+#endif
 }
 
 /**
- * @brief Finds the next prime number greater than or equal to n.
+ * @brief Returns a bit mask of the EMPTY and DELETED tags of the group starting
+ * at `ctrl`. Both have their high bit set, full tags do not.
+ */
+static inline uint32_t mongory_table_group_match_free(const uint8_t *ctrl) {
+#ifdef MONGORY_TABLE_SSE2
+  return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)ctrl));
+#else
+  uint32_t mask = 0;
+  for (int i = 0; i < MONGORY_TABLE_GROUP_WIDTH; i++) {
+    mask |= (uint32_t)(ctrl[i] >> 7) << i;
+  }
+  return mask;
+#endif
+}
+
+/**
+ * @brief Index of the lowest set bit of a non-zero mask.
+ */
+static inline int mongory_table_lowest_bit(uint32_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctz(mask);
+#else
+  int index = 0;
+  while (!(mask & 1)) {
+    mask >>= 1;
+    index++;
+  }
+  return index;
+#endif
+}
+
+/**
+ * @brief Writes the tag of a slot, keeping the mirrored tail in sync so a
+ * group read near the end of the array sees the first tags again.
+ */
+static inline void mongory_table_set_ctrl(mongory_table_internal *internal, size_t index, uint8_t tag) {
+  internal->ctrl[index] = tag;
+  if (index < MONGORY_TABLE_GROUP_WIDTH) {
+    internal->ctrl[internal->capacity + index] = tag;
+  }
+}
+
+/**
+ * @brief Finds the slot holding a key.
  *
- * Using a prime number for the capacity of a hash table helps to distribute
- * keys more uniformly, reducing collisions.
+ * Probes groups in a triangular sequence, which visits every group of a
+ * power-of-two table. A group containing an EMPTY tag ends the search.
  *
- * @param n The number to start searching from.
- * @return The next prime number.
- */
-static inline size_t next_prime(size_t n) {
-  if (n <= 2) {
-    return 2;
-  }
-  if (n % 2 == 0) // Ensure n is odd to start.
-    n++;
-
-  while (1) {
-    bool is_prime = true;
-    // Check divisibility up to sqrt(n).
-    for (size_t i = 3; i * i <= n; i += 2) {
-      if (n % i == 0) {
-        is_prime = false;
-        break;
+ * @return The slot index, or `capacity` if the key is not in the table.
+ */
+static inline size_t mongory_table_find(mongory_table_internal *internal, const char *key, size_t key_len,
+                                        uint64_t hash) {
+  size_t mask = internal->capacity - 1;
+  uint8_t tag = mongory_table_h2(hash);
+  size_t position = mongory_table_h1(hash) & mask;
+  for (size_t stride = MONGORY_TABLE_GROUP_WIDTH;; stride += MONGORY_TABLE_GROUP_WIDTH) {
+    const uint8_t *group = internal->ctrl + position;
+    for (uint32_t match = mongory_table_group_match(group, tag); match; match &= match - 1) {
+      size_t index = (position + mongory_table_lowest_bit(match)) & mask;
+      mongory_table_slot *slot = &internal->slots[index];
+      if (slot->hash == hash && slot->key_len == key_len && memcmp(slot->key, key, key_len) == 0) {
+        return index;
       }
     }
-    if (is_prime) {
-      return n;
+    if (mongory_table_group_match(group, MONGORY_TABLE_CTRL_EMPTY)) {
+      return internal->capacity;
     }
-    n += 2; // Check next odd number.
+    position = (position + stride) & mask;
   }
 }
 
 /**
- * @brief Computes a hash value for a null-terminated string (djb2 algorithm).
- * @param str The string to hash.
- * @return The hash value.
+ * @brief Finds the first EMPTY or DELETED slot on the probe sequence of a hash.
  */
-static inline size_t hash_string(const char *str) {
-  size_t hash = 5381; // Initial hash value.
-  int c;
-  while ((c = *str++)) {             // Iterate through characters of the string.
-    hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
+static inline size_t mongory_table_find_free(mongory_table_internal *internal, uint64_t hash) {
+  size_t mask = internal->capacity - 1;
+  size_t position = mongory_table_h1(hash) & mask;
+  for (size_t stride = MONGORY_TABLE_GROUP_WIDTH;; stride += MONGORY_TABLE_GROUP_WIDTH) {
+    uint32_t match = mongory_table_group_match_free(internal->ctrl + position);
+    if (match) {
+      return (position + mongory_table_lowest_bit(match)) & mask;
+    }
+    position = (position + stride) & mask;
   }
-  return hash;
 }
 
 /**
- * @brief Walks a linked list of mongory_table_node, applying a callback to each.
- * @param head The head of the linked list.
- * @param acc Accumulator/context for the callback.
- * @param callback Function to call for each node. Stops if callback returns
- * false.
- * @return true if iteration completed, false if callback stopped it.
+ * @brief Number of slots needed to hold `count` entries under the 7/8 load
+ * limit.
  */
-static inline bool mongory_table_node_walk(mongory_table_node *head, void *acc,
-                                           bool (*callback)(mongory_table_node *node, void *acc)) {
-  for (mongory_table_node *node = head; node;) {
-    mongory_table_node *next = node->next; // Save next before callback modifies node
-    if (!callback(node, acc)) {
-      return false; // Callback requested stop.
-    }
-    node = next;
+static inline size_t mongory_table_capacity_for(size_t count) {
+  size_t capacity = MONGORY_TABLE_INIT_SIZE;
+  while (capacity - capacity / 8 < count + 1) {
+    capacity *= 2;
   }
-  return true;
+  return capacity;
 }
 
 /**
- * @brief Callback used during rehashing to re-insert a node into the new table
- * structure.
- * Calculates the new bucket index for the node and prepends it to that
- * bucket's list.
- * @param node The node to rehash.
- * @param acc Pointer to the mongory_table_internal structure (cast from void*).
- * @return Always true to continue walking the old bucket list.
- */
-static inline bool mongory_table_rehash_on_node(mongory_table_node *node, void *acc) {
-  mongory_table_internal *internal = (mongory_table_internal *)acc;
-  mongory_array *new_bucket_array = internal->array;
-  // Calculate index in the new array based on new capacity.
-  size_t new_index = hash_string(node->key) % internal->capacity;
-
-  // Get current head of the new bucket's list.
-  mongory_table_node *current_bucket_head = (mongory_table_node *)new_bucket_array->get(new_bucket_array, new_index);
-  // Prepend the node to this list.
-  node->next = current_bucket_head;
-  new_bucket_array->set(new_bucket_array, new_index, (mongory_value *)node);
+ * @brief Allocates the slot and control arrays for `capacity` slots, with
+ * every tag EMPTY.
+ */
+static inline bool mongory_table_alloc_arrays(mongory_memory_pool *pool, size_t capacity, uint8_t **ctrl,
+                                              mongory_table_slot **slots) {
+  *ctrl = MG_ALLOC_ARY(pool, uint8_t, capacity + MONGORY_TABLE_GROUP_WIDTH);
+  *slots = MG_ALLOC_ARY(pool, mongory_table_slot, capacity);
+  if (*ctrl == NULL || *slots == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return false;
+  }
+  memset(*ctrl, MONGORY_TABLE_CTRL_EMPTY, capacity + MONGORY_TABLE_GROUP_WIDTH);
   return true;
 }
 
 /**
- * @brief Rehashes the table when the load factor is exceeded.
- * Creates a new underlying array with a larger, prime capacity, and
- * re-inserts all existing nodes into this new array.
+ * @brief Moves every entry into arrays of `new_capacity` slots, dropping the
+ * DELETED tags. Entries are placed with their stored hashes, so no key is
+ * hashed again.
+ *
+ * The old arrays are not released: an iteration in progress keeps reading
+ * them.
  * @param self Pointer to the mongory_table.
+ * @param new_capacity The new number of slots, a power of two.
  * @return true if rehashing was successful, false otherwise.
  */
-static inline bool mongory_table_rehash(mongory_table *self) {
+static inline bool mongory_table_rehash(mongory_table *self, size_t new_capacity) {
   mongory_table_internal *internal = (mongory_table_internal *)self;
-  mongory_array_private *old_array_private_view = (mongory_array_private *)internal->array;
-
-  mongory_value **original_items_ptr = old_array_private_view->items;
-  size_t original_capacity = internal->capacity;
-  size_t new_capacity = next_prime(original_capacity * 2);
-
-  // Reset the count of the existing array before resizing, as resize
-  // might copy elements if count is not zero. We are managing elements manually.
-  internal->array->count = 0;
-
-  if (!mongory_array_resize(internal->array, new_capacity)) {
-    // Error: Rehashing failed because the underlying array could not be resized.
-    // The table remains functional but may have a suboptimal load factor.
-    self->pool->error = &MONGORY_ALLOC_ERROR;
-    internal->array->count = self->count; // Try to restore roughly
+  uint8_t *old_ctrl = internal->ctrl;
+  mongory_table_slot *old_slots = internal->slots;
+  size_t old_capacity = internal->capacity;
+
+  if (!mongory_table_alloc_arrays(self->pool, new_capacity, &internal->ctrl, &internal->slots)) {
+    // The table keeps its old arrays and stays usable.
+    internal->ctrl = old_ctrl;
+    internal->slots = old_slots;
     return false;
   }
-  // After resize, internal->array (and old_array_private_view) points to the
-  // new items array. The old items array (original_items_ptr) is now detached
-  // but its contents (the nodes) are still valid.
-
-  internal->capacity = new_capacity; // Update table's capacity.
-
-  // Iterate through all buckets of the old array structure.
-  for (size_t i = 0; i < original_capacity; i++) {
-    // Walk the linked list in each old bucket and rehash each node.
-    mongory_table_node_walk((mongory_table_node *)original_items_ptr[i], self, mongory_table_rehash_on_node);
+  internal->capacity = new_capacity;
+  internal->deleted = 0;
+
+  for (size_t i = 0; i < old_capacity; i++) {
+    if (old_ctrl[i] & 0x80)
+      continue; // EMPTY or DELETED.
+    size_t index = mongory_table_find_free(internal, old_slots[i].hash);
+    internal->slots[index] = old_slots[i];
+    mongory_table_set_ctrl(internal, index, old_ctrl[i]);
   }
-  // The memory for original_items_ptr itself (the array of pointers) is now
-  // stale / managed by the memory pool if mongory_array_resize reallocated.
-  // The mongory_table_nodes it pointed to have been relinked into the new array.
+  // The old arrays are reclaimed with the memory pool.
   return true;
 }
 
-/**
- * @struct mongory_table_kv_context
- * @brief Context structure used for get and set operations within a bucket
- * list.
- */
-typedef struct mongory_table_kv_context {
-  char *key;            /**< The key being searched for or set. */
-  mongory_value *value; /**< Stores the found value (for get) or the value to set. */
-} mongory_table_kv_context;
+uint64_t mongory_table_hash_key(const char *key, size_t key_len) { return mongory_hash_bytes(key, key_len); }
 
 /**
- * @brief Callback for mongory_table_get to find a key in a bucket's list.
- * If the node's key matches ctx->key, sets ctx->value and returns false to stop.
- * @param node Current node in the list.
- * @param acc Pointer to mongory_table_kv_context.
- * @return true to continue search, false if key found.
+ * @brief Retrieves a value by a pre-hashed key. Implements `table->get_hashed`.
+ * @param self Pointer to the mongory_table.
+ * @param key The key to search for.
+ * @param key_len The length of `key`.
+ * @param hash The hash of `key`.
+ * @return Pointer to the mongory_value, or NULL if not found.
  */
-static inline bool mongory_table_get_on_node(mongory_table_node *node, void *acc) {
-  mongory_table_kv_context *ctx = (mongory_table_kv_context *)acc;
-  if (strcmp(node->key, ctx->key) == 0) {
-    ctx->value = node->value; // Key found, store value.
-    return false;             // Stop search.
-  }
-  return true; // Continue search.
+mongory_value *mongory_table_get_hashed(mongory_table *self, char *key, size_t key_len, uint64_t hash) {
+  mongory_table_internal *internal = (mongory_table_internal *)self;
+  size_t index = mongory_table_find(internal, key, key_len, hash);
+  return index == internal->capacity ? NULL : internal->slots[index].value;
 }
 
 /**
@@ -235,40 +306,16 @@ static inline bool mongory_table_get_on_node(mongory_table_node *node, void *acc
  * @return Pointer to the mongory_value, or NULL if not found.
  */
 mongory_value *mongory_table_get(mongory_table *self, char *key) {
-  mongory_table_internal *internal = (mongory_table_internal *)self;
-  mongory_array *bucket_array = internal->array;
-  size_t index = hash_string(key) % internal->capacity;
-
-  mongory_table_node *bucket_head = (mongory_table_node *)bucket_array->get(bucket_array, index);
-
-  mongory_table_kv_context ctx = {key, NULL};
-  mongory_table_node_walk(bucket_head, &ctx, mongory_table_get_on_node);
-  return ctx.value; // NULL if not found, otherwise the value.
-}
-
-/**
- * @brief Callback for mongory_table_set to update a value if key exists in a
- * bucket's list.
- * If node's key matches ctx->key, updates node's value and returns false to
- * stop.
- * @param node Current node in the list.
- * @param acc Pointer to mongory_table_kv_context.
- * @return true to continue search (if key not matched), false if key updated.
- */
-static inline bool mongory_table_set_on_node(mongory_table_node *node, void *acc) {
-  mongory_table_kv_context *ctx = (mongory_table_kv_context *)acc;
-  if (strcmp(node->key, ctx->key) == 0) {
-    node->value = ctx->value; // Key found, update value.
-    return false;             // Stop search, indicates update happened.
-  }
-  return true; // Continue search.
+  size_t key_len = strlen(key);
+  return mongory_table_get_hashed(self, key, key_len, mongory_table_hash_key(key, key_len));
 }
 
 /**
  * @brief Sets (adds or updates) a key-value pair in the table. Implements
  * `table->set`.
- * If key exists, its value is updated. Otherwise, a new node is created and
- * added. Triggers rehashing if load factor is exceeded after adding.
+ * If key exists, its value is updated. Otherwise, the key is copied into a
+ * free slot. Grows the table first if the new entry would exceed the load
+ * limit.
  * @param self Pointer to the mongory_table.
  * @param key The key to set. A copy of this key will be made.
  * @param value The value to associate with the key.
@@ -276,45 +323,42 @@ static inline bool mongory_table_set_on_node(mongory_table_node *node, void *acc
  */
 bool mongory_table_set(mongory_table *self, char *key, mongory_value *value) {
   mongory_table_internal *internal = (mongory_table_internal *)self;
-  mongory_array *bucket_array = internal->array;
-  size_t index = hash_string(key) % internal->capacity;
-
-  mongory_table_node *bucket_head = (mongory_table_node *)bucket_array->get(bucket_array, index);
-
-  mongory_table_kv_context ctx = {key, value};
-  // Try to find and update existing key. If mongory_table_node_walk returns
-  // false, it means set_on_node found the key and updated it.
-  if (!mongory_table_node_walk(bucket_head, &ctx, mongory_table_set_on_node)) {
-    return true; // Update successful.
+  size_t key_len = strlen(key);
+  uint64_t hash = mongory_table_hash_key(key, key_len);
+  size_t index = mongory_table_find(internal, key, key_len, hash);
+  if (index != internal->capacity) {
+    internal->slots[index].value = value; // Key found, update value.
+    return true;
   }
 
-  // Key not found, create a new node and prepend it to the bucket list.
-  mongory_table_node *new_node = mongory_table_node_new(self);
-  if (!new_node) {
-    self->pool->error = &MONGORY_ALLOC_ERROR;
-    return false; // Node allocation failed.
+  size_t limit = internal->capacity - internal->capacity / 8;
+  if (self->count + internal->deleted + 1 > limit) {
+    // Double when the table is really full, otherwise only sweep the DELETED
+    // tags out at the same capacity.
+    size_t new_capacity = self->count + 1 > limit / 2 ? internal->capacity * 2 : internal->capacity;
+    if (!mongory_table_rehash(self, new_capacity) && self->count + internal->deleted + 1 >= internal->capacity) {
+      return false; // Rehashing failed and there is no free slot left.
+    }
   }
 
-  char *key_copy = mongory_string_cpy(self->pool, key);
+  char *key_copy = MG_ALLOC(self->pool, key_len + 1);
   if (!key_copy) {
     self->pool->error = &MONGORY_ALLOC_ERROR;
     return false; // Key copy failed.
   }
+  memcpy(key_copy, key, key_len + 1);
 
-  new_node->key = key_copy;
-  new_node->value = value;
-  new_node->next = bucket_head; // Prepend to list.
-  bucket_array->set(bucket_array, index, (mongory_value *)new_node);
-
-  self->count++;
-  // Check load factor and rehash if necessary.
-  if (self->count > internal->capacity * MONGORY_TABLE_LOAD_FACTOR) {
-    if (!mongory_table_rehash(self)) {
-      // Rehashing failed. The table will still work, but its performance
-      // may be degraded due to a higher-than-optimal load factor.
-      self->pool->error = &MONGORY_ALLOC_ERROR;
-    }
+  index = mongory_table_find_free(internal, hash);
+  if (internal->ctrl[index] == MONGORY_TABLE_CTRL_DELETED) {
+    internal->deleted--;
   }
+  mongory_table_slot *slot = &internal->slots[index];
+  slot->key = key_copy;
+  slot->key_len = key_len;
+  slot->hash = hash;
+  slot->value = value;
+  mongory_table_set_ctrl(internal, index, mongory_table_h2(hash));
+  self->count++;
   return true;
 }
 
@@ -326,141 +370,264 @@ bool mongory_table_set(mongory_table *self, char *key, mongory_value *value) {
  */
 bool mongory_table_del(mongory_table *self, char *key) {
   mongory_table_internal *internal = (mongory_table_internal *)self;
-  mongory_array *bucket_array = internal->array;
-  size_t index = hash_string(key) % internal->capacity;
-
-  mongory_table_node *node = (mongory_table_node *)bucket_array->get(bucket_array, index);
-  mongory_table_node *prev = NULL;
-
-  while (node) {
-    if (strcmp(node->key, key) == 0) {
-      if (prev) {
-        prev->next = node->next; // Unlink from middle/end of list.
-      } else {
-        // Node is the head of the list for this bucket.
-        bucket_array->set(bucket_array, index, (mongory_value *)node->next);
-      }
-      // The memory for the node and its key is not freed here.
-      // It was allocated from the memory pool and will be reclaimed all at
-      // once when the pool is destroyed. This is a core design principle
-      // of the library's memory management.
-      self->count--;
-      return true; // Deletion successful.
+  size_t key_len = strlen(key);
+  size_t index = mongory_table_find(internal, key, key_len, mongory_table_hash_key(key, key_len));
+  if (index == internal->capacity) {
+    return false; // Key not found.
+  }
+  // The slot is marked DELETED rather than EMPTY so probe sequences passing
+  // through it keep going. The key copy goes back to the pool for reuse.
+  mongory_table_set_ctrl(internal, index, MONGORY_TABLE_CTRL_DELETED);
+  if (self->pool->release != NULL) {
+    self->pool->release(self->pool, internal->slots[index].key, key_len + 1);
+  }
+  internal->deleted++;
+  self->count--;
+  return true;
+}
+
+/**
+ * @brief Iterates over all key-value pairs in the table. Implements
+ * `table->each`.
+ * @param self Pointer to the mongory_table.
+ * @param acc Accumulator/context for the user callback.
+ * @param callback User function to call for each pair.
+ * @return true if iteration completed, false if callback stopped it.
+ */
+bool mongory_table_each_pair(mongory_table *self, void *acc, mongory_table_each_pair_callback_func callback) {
+  mongory_table_internal *internal = (mongory_table_internal *)self;
+  // The arrays are read once, so a callback that grows the table keeps
+  // iterating over the entries that existed when the iteration started.
+  uint8_t *ctrl = internal->ctrl;
+  mongory_table_slot *slots = internal->slots;
+  size_t capacity = internal->capacity;
+  for (size_t i = 0; i < capacity; i++) {
+    if (ctrl[i] & 0x80)
+      continue; // EMPTY or DELETED.
+    if (!callback(slots[i].key, slots[i].value, acc)) {
+      return false;
     }
-    prev = node;
-    node = node->next;
   }
-  return false; // Key not found.
+  return true;
 }
 
 /**
- * @struct mongory_table_each_pair_context
- * @brief Context for iterating over table key-value pairs.
+ * @brief Installs the hash table operations.
  */
-typedef struct mongory_table_each_pair_context {
-  void *acc;                                      /**< User-provided accumulator. */
-  mongory_table_each_pair_callback_func callback; /**< User callback function. */
-} mongory_table_each_pair_context;
+static inline void mongory_table_init_hashed(mongory_table_internal *internal) {
+  internal->base.each = mongory_table_each_pair;
+  internal->base.get = mongory_table_get;
+  internal->base.get_hashed = mongory_table_get_hashed;
+  internal->base.set = mongory_table_set;
+  internal->base.del = mongory_table_del;
+}
+
+// ============================================================================
+// Small Tables
+// ============================================================================
 
 /**
- * @brief Callback for mongory_table_each_pair, applied to each node in a
- * bucket list. Invokes the user's callback.
- * @param node Current table node.
- * @param acc Pointer to mongory_table_each_pair_context.
- * @return Result of the user's callback.
+ * @brief Finds the slot holding a key in a small table.
+ * @return The slot index, or `count` if the key is not in the table.
  */
-static inline bool mongory_table_each_pair_on_node(mongory_table_node *node, void *acc) {
-  mongory_table_each_pair_context *ctx = (mongory_table_each_pair_context *)acc;
-  return ctx->callback(node->key, node->value, ctx->acc);
+static inline size_t mongory_table_small_find(mongory_table_internal *internal, const char *key, size_t key_len,
+                                              uint64_t hash) {
+  mongory_table_slot *slots = internal->slots;
+  size_t count = internal->base.count;
+  for (size_t i = 0; i < count; i++) {
+    if (slots[i].hash == hash && slots[i].key_len == key_len && memcmp(slots[i].key, key, key_len) == 0) {
+      return i;
+    }
+  }
+  return count;
 }
 
 /**
- * @brief Callback for iterating through the table's underlying array of buckets.
- * For each non-empty bucket (which is a mongory_table_node* cast to
- * mongory_value*), it walks that bucket's linked list.
- * @param value The head of a bucket's linked list (cast to mongory_value*).
- * @param acc Pointer to mongory_table_each_pair_context.
- * @return Result of mongory_table_node_walk on the bucket list.
+ * @brief Turns a full small table into a hash table with room for one more
+ * entry. Entries keep their stored hashes.
+ * @return true if successful, false on allocation failure (the table is then
+ * left small and unchanged).
  */
-static inline bool mongory_table_each_pair_on_root(mongory_value *value, void *acc) {
-  mongory_table_node *node_head = (mongory_table_node *)value;
-  // If bucket is empty (value is NULL from array->get), this will do nothing.
-  return mongory_table_node_walk(node_head, acc, mongory_table_each_pair_on_node);
+static bool mongory_table_small_promote(mongory_table_internal *internal) {
+  mongory_table *self = &internal->base;
+  mongory_table_slot *small_slots = internal->slots;
+  size_t small_capacity = internal->capacity;
+  size_t capacity = mongory_table_capacity_for(self->count + 1);
+  if (!mongory_table_alloc_arrays(self->pool, capacity, &internal->ctrl, &internal->slots)) {
+    internal->ctrl = NULL;
+    internal->slots = small_slots;
+    internal->capacity = small_capacity;
+    return false;
+  }
+  internal->capacity = capacity;
+  internal->deleted = 0;
+  for (size_t i = 0; i < self->count; i++) {
+    size_t index = mongory_table_find_free(internal, small_slots[i].hash);
+    internal->slots[index] = small_slots[i];
+    mongory_table_set_ctrl(internal, index, mongory_table_h2(small_slots[i].hash));
+  }
+  mongory_table_init_hashed(internal);
+  return true;
 }
 
 /**
- * @brief Iterates over all key-value pairs in the table. Implements
- * `table->each`.
- * @param self Pointer to the mongory_table.
- * @param acc Accumulator/context for the user callback.
- * @param callback User function to call for each pair.
- * @return true if iteration completed, false if callback stopped it.
+ * @brief Implements `table->get_hashed` for small tables.
  */
-bool mongory_table_each_pair(mongory_table *self, void *acc, mongory_table_each_pair_callback_func callback) {
+static mongory_value *mongory_table_small_get_hashed(mongory_table *self, char *key, size_t key_len, uint64_t hash) {
   mongory_table_internal *internal = (mongory_table_internal *)self;
-  mongory_table_each_pair_context each_ctx = {acc, callback};
-  // Iterate over the array of buckets. Each element in this array is the head
-  // of a linked list of table nodes (or NULL if bucket is empty).
-  return internal->array->each(internal->array, &each_ctx, mongory_table_each_pair_on_root);
+  size_t index = mongory_table_small_find(internal, key, key_len, hash);
+  return index == self->count ? NULL : internal->slots[index].value;
 }
 
 /**
- * @brief Creates and initializes a new mongory_table.
- * Allocates the table structure, its internal array for buckets, and sets up
- * function pointers.
- * @param pool The memory pool to use for all allocations.
- * @return Pointer to the new mongory_table, or NULL on failure.
+ * @brief Implements `table->get` for small tables.
  */
-mongory_table *mongory_table_new(mongory_memory_pool *pool) {
-  if (!pool)
-    return NULL; // Must have a valid pool.
+static mongory_value *mongory_table_small_get(mongory_table *self, char *key) {
+  size_t key_len = strlen(key);
+  return mongory_table_small_get_hashed(self, key, key_len, mongory_table_hash_key(key, key_len));
+}
+
+/**
+ * @brief Implements `table->set` for small tables. Appends new keys, growing
+ * the flat array up to MONGORY_TABLE_SMALL_MAX slots and promoting the table
+ * past that.
+ */
+static bool mongory_table_small_set(mongory_table *self, char *key, mongory_value *value) {
+  mongory_table_internal *internal = (mongory_table_internal *)self;
+  size_t key_len = strlen(key);
+  uint64_t hash = mongory_table_hash_key(key, key_len);
+  size_t index = mongory_table_small_find(internal, key, key_len, hash);
+  if (index != self->count) {
+    internal->slots[index].value = value; // Key found, update value.
+    return true;
+  }
+
+  if (self->count == internal->capacity) {
+    if (internal->capacity >= MONGORY_TABLE_SMALL_MAX) {
+      if (!mongory_table_small_promote(internal)) {
+        return false;
+      }
+      return mongory_table_set(self, key, value);
+    }
+    size_t capacity = internal->capacity * 2;
+    if (capacity > MONGORY_TABLE_SMALL_MAX) {
+      capacity = MONGORY_TABLE_SMALL_MAX;
+    }
+    mongory_memory_pool *pool = self->pool;
+    if (pool->try_extend == NULL ||
+        !pool->try_extend(pool, internal->slots, sizeof(mongory_table_slot) * internal->capacity,
+                          sizeof(mongory_table_slot) * capacity)) {
+      mongory_table_slot *slots = MG_ALLOC_ARY(pool, mongory_table_slot, capacity);
+      if (!slots) {
+        pool->error = &MONGORY_ALLOC_ERROR;
+        return false;
+      }
+      memcpy(slots, internal->slots, sizeof(mongory_table_slot) * self->count);
+      internal->slots = slots;
+    }
+    internal->capacity = capacity;
+  }
 
-  size_t init_capacity = MONGORY_TABLE_INIT_SIZE;
-  mongory_array *bucket_array = mongory_array_new(pool);
+  char *key_copy = MG_ALLOC(self->pool, key_len + 1);
+  if (!key_copy) {
+    self->pool->error = &MONGORY_ALLOC_ERROR;
+    return false; // Key copy failed.
+  }
+  memcpy(key_copy, key, key_len + 1);
 
-  // Initialize the bucket array. We resize it to the initial capacity and
-  // then set the last element to NULL. The `mongory_array_set` function
-  // will automatically fill all intermediate slots with NULL if the index is
-  // out of bounds, which perfectly initializes our bucket array.
-  bool array_init_success = bucket_array && mongory_array_resize(bucket_array, init_capacity) &&
-                            bucket_array->set(bucket_array, init_capacity - 1, NULL);
+  mongory_table_slot *slot = &internal->slots[self->count++];
+  slot->key = key_copy;
+  slot->key_len = key_len;
+  slot->hash = hash;
+  slot->value = value;
+  return true;
+}
 
-  if (!array_init_success) {
-    // If array initialization fails, we cannot proceed.
-    // The memory for `bucket_array` itself (if allocated) will be handled
-    // by the memory pool when it's eventually freed.
-    pool->error = &MONGORY_ALLOC_ERROR;
-    return NULL;
+/**
+ * @brief Implements `table->del` for small tables. Later entries move down,
+ * keeping insertion order.
+ */
+static bool mongory_table_small_del(mongory_table *self, char *key) {
+  mongory_table_internal *internal = (mongory_table_internal *)self;
+  size_t key_len = strlen(key);
+  size_t index = mongory_table_small_find(internal, key, key_len, mongory_table_hash_key(key, key_len));
+  if (index == self->count) {
+    return false; // Key not found.
+  }
+  if (self->pool->release != NULL) {
+    self->pool->release(self->pool, internal->slots[index].key, key_len + 1);
+  }
+  self->count--;
+  memmove(&internal->slots[index], &internal->slots[index + 1], sizeof(mongory_table_slot) * (self->count - index));
+  return true;
+}
+
+/**
+ * @brief Implements `table->each` for small tables, in insertion order.
+ */
+static bool mongory_table_small_each(mongory_table *self, void *acc, mongory_table_each_pair_callback_func callback) {
+  mongory_table_internal *internal = (mongory_table_internal *)self;
+  // As for hash tables, entries added by the callback are not visited.
+  mongory_table_slot *slots = internal->slots;
+  size_t count = self->count;
+  for (size_t i = 0; i < count; i++) {
+    if (!callback(slots[i].key, slots[i].value, acc)) {
+      return false;
+    }
   }
-  // After initialization, bucket_array->count will equal init_capacity.
-  // This is correct for the array's state, but the table's logical count is 0.
-  // We leave array->count as is, since the table's `each` function iterates
-  // over the array's full capacity.
-  bucket_array->count = init_capacity;
+  return true;
+}
+
+mongory_table *mongory_table_new_with_capacity(mongory_memory_pool *pool, size_t capacity) {
+  if (!pool)
+    return NULL; // Must have a valid pool.
 
   mongory_table_internal *internal = MG_ALLOC_PTR(pool, mongory_table_internal);
   if (!internal) {
     pool->error = &MONGORY_ALLOC_ERROR;
     return NULL;
   }
+  internal->deleted = 0;
 
   // Initialize public part (base)
   internal->base.pool = pool;
   internal->base.count = 0; // Table is initially empty.
-  internal->base.each = mongory_table_each_pair;
-  internal->base.get = mongory_table_get;
-  internal->base.set = mongory_table_set;
-  internal->base.del = mongory_table_del;
 
-  // Initialize private part
-  internal->array = bucket_array;
-  internal->capacity = init_capacity;
+  if (capacity <= MONGORY_TABLE_SMALL_MAX) {
+    internal->capacity = capacity > 0 ? capacity : MONGORY_TABLE_SMALL_INIT_SIZE;
+    internal->ctrl = NULL;
+    internal->slots = MG_ALLOC_ARY(pool, mongory_table_slot, internal->capacity);
+    if (!internal->slots) {
+      pool->error = &MONGORY_ALLOC_ERROR;
+      return NULL;
+    }
+    internal->base.each = mongory_table_small_each;
+    internal->base.get = mongory_table_small_get;
+    internal->base.get_hashed = mongory_table_small_get_hashed;
+    internal->base.set = mongory_table_small_set;
+    internal->base.del = mongory_table_small_del;
+    return &internal->base;
+  }
+
+  internal->capacity = mongory_table_capacity_for(capacity);
+  if (!mongory_table_alloc_arrays(pool, internal->capacity, &internal->ctrl, &internal->slots)) {
+    return NULL;
+  }
+  mongory_table_init_hashed(internal);
 
   return &internal->base; // Return pointer to the public structure.
 }
 
+/**
+ * @brief Creates and initializes a new mongory_table with the default
+ * capacity.
+ * @param pool The memory pool to use for all allocations.
+ * @return Pointer to the new mongory_table, or NULL on failure.
+ */
+mongory_table *mongory_table_new(mongory_memory_pool *pool) { return mongory_table_new_with_capacity(pool, 0); }
+
 mongory_table *mongory_table_nested_wrap(mongory_memory_pool *pool, int argc, ...) {
-  mongory_table *table = mongory_table_new(pool);
+  mongory_table *table = mongory_table_new_with_capacity(pool, argc > 0 ? (size_t)argc : 0);
   if (!table) {
     return NULL;
   }
@@ -471,7 +638,7 @@ mongory_table *mongory_table_nested_wrap(mongory_memory_pool *pool, int argc, ..
     MONGORY_VALIDATE_PTR(pool, key);
     mongory_value *value = va_arg(args, mongory_value *);
     MONGORY_VALIDATE_PTR(pool, value);
-    mongory_table_set(table, key, value);
+    table->set(table, key, value);
   }
   va_end(args);
   if (pool->error != NULL) {
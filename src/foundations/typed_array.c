@@ -0,0 +1,394 @@
+/**
+ * @file typed_array.c
+ * @brief Implements typed arrays, which store int, double or string items
+ * unboxed.
+ *
+ * A typed array is a `mongory_array_private` whose `items` serve as a cache
+ * of boxes, allocated the first time an item is read through `get` or
+ * `each`. The items themselves live in a contiguous vector next to it, and
+ * both share `capacity`. When an item the vector cannot hold comes in, every
+ * item is boxed and the array switches to the operations of a boxed array.
+ */
+#include "array_private.h"
+#include "value_private.h"
+#include "mongory-core/foundations/error.h"
+#include "mongory-core/foundations/memory_pool.h"
+#include <string.h>
+
+/**
+ * @def MONGORY_TYPED_ARRAY_INIT_SIZE
+ * @brief Initial capacity of a typed array.
+ */
+#define MONGORY_TYPED_ARRAY_INIT_SIZE 8
+
+/**
+ * @brief Internal representation of a typed array.
+ */
+typedef struct mongory_typed_array {
+  mongory_array_private base; /**< Boxed part; `items` is NULL until the first box. */
+  mongory_type item_type;     /**< Type of every item. */
+  union {
+    int64_t *ints;                 /**< Items of an int array. */
+    double *doubles;               /**< Items of a double array. */
+    mongory_string_slice *strings; /**< Items of a string array. */
+    void *ptr;                     /**< Any of the above. */
+  } data;
+} mongory_typed_array;
+
+static mongory_value *mongory_typed_array_get(mongory_array *self, size_t index);
+
+static inline size_t mongory_typed_array_item_size(mongory_type item_type) {
+  switch (item_type) {
+  case MONGORY_TYPE_INT:
+    return sizeof(int64_t);
+  case MONGORY_TYPE_DOUBLE:
+    return sizeof(double);
+  default:
+    return sizeof(mongory_string_slice);
+  }
+}
+
+static inline mongory_typed_array *mongory_typed_array_of(mongory_array *array, mongory_type item_type) {
+  if (array == NULL || array->get != mongory_typed_array_get)
+    return NULL;
+  mongory_typed_array *typed = (mongory_typed_array *)array;
+  return typed->item_type == item_type ? typed : NULL;
+}
+
+/**
+ * @brief Allocates `capacity` empty box slots.
+ */
+static mongory_value **mongory_typed_array_boxes_new(mongory_memory_pool *pool, size_t capacity) {
+  mongory_value **boxes = MG_ALLOC_ARY(pool, mongory_value *, capacity);
+  if (boxes == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  memset(boxes, 0, sizeof(mongory_value *) * capacity);
+  return boxes;
+}
+
+/**
+ * @brief Grows a block of `old_count` items of `item_size` bytes to hold
+ * `new_count` items, in place when the pool allows it. A block that moves is
+ * released to the pool.
+ * @return The block, or NULL on allocation failure.
+ */
+static void *mongory_typed_array_grow_block(mongory_memory_pool *pool, void *block, size_t item_size,
+                                            size_t used_count, size_t old_count, size_t new_count) {
+  if (pool->try_extend != NULL && pool->try_extend(pool, block, item_size * old_count, item_size * new_count))
+    return block;
+  void *grown = MG_ALLOC(pool, item_size * new_count);
+  if (grown == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  memcpy(grown, block, item_size * used_count);
+  if (pool->release != NULL)
+    pool->release(pool, block, item_size * old_count);
+  return grown;
+}
+
+/**
+ * @brief Grows the vector and the box cache together to `capacity` items.
+ */
+static bool mongory_typed_array_resize(mongory_typed_array *typed, size_t capacity) {
+  mongory_array *self = &typed->base.base;
+  size_t item_size = mongory_typed_array_item_size(typed->item_type);
+  void *data = mongory_typed_array_grow_block(self->pool, typed->data.ptr, item_size, self->count,
+                                              typed->base.capacity, capacity);
+  if (data == NULL)
+    return false;
+  typed->data.ptr = data;
+  if (typed->base.items != NULL) {
+    mongory_value **boxes = mongory_typed_array_grow_block(self->pool, typed->base.items, sizeof(mongory_value *),
+                                                           self->count, typed->base.capacity, capacity);
+    if (boxes == NULL)
+      return false;
+    typed->base.items = boxes;
+  }
+  typed->base.capacity = capacity;
+  return true;
+}
+
+/**
+ * @brief Makes room for an item at index `size`.
+ */
+static bool mongory_typed_array_grow_if_needed(mongory_typed_array *typed, size_t size) {
+  if (size < typed->base.capacity)
+    return true;
+  size_t capacity = typed->base.capacity * 2;
+  while (capacity <= size)
+    capacity *= 2;
+  return mongory_typed_array_resize(typed, capacity);
+}
+
+/**
+ * @brief Builds the value of an item in place.
+ */
+static inline void mongory_typed_array_fill(mongory_typed_array *typed, size_t index, mongory_value *value) {
+  mongory_value_init(value, typed->item_type);
+  switch (typed->item_type) {
+  case MONGORY_TYPE_INT:
+    value->data.i = typed->data.ints[index];
+    break;
+  case MONGORY_TYPE_DOUBLE:
+    value->data.d = typed->data.doubles[index];
+    break;
+  default:
+    value->data.s = (char *)typed->data.strings[index].s;
+    value->len = (unsigned int)typed->data.strings[index].len;
+    break;
+  }
+}
+
+/**
+ * @brief Returns the box of an item, boxing it into the pool if needed.
+ */
+static mongory_value *mongory_typed_array_box(mongory_typed_array *typed, size_t index) {
+  mongory_memory_pool *pool = typed->base.base.pool;
+  if (typed->base.items == NULL) {
+    typed->base.items = mongory_typed_array_boxes_new(pool, typed->base.capacity);
+    if (typed->base.items == NULL)
+      return NULL;
+  }
+  mongory_value *box = typed->base.items[index];
+  if (box != NULL)
+    return box;
+  box = MG_ALLOC_PTR(pool, mongory_value);
+  if (box == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  mongory_typed_array_fill(typed, index, box);
+#ifndef MONGORY_COMPACT_VALUE
+  box->pool = pool;
+#endif
+  typed->base.items[index] = box;
+  return box;
+}
+
+/**
+ * @brief Boxes every item and turns the array into a boxed array.
+ */
+static bool mongory_typed_array_deoptimize(mongory_typed_array *typed) {
+  mongory_array *self = &typed->base.base;
+  for (size_t i = 0; i < self->count; i++) {
+    if (mongory_typed_array_box(typed, i) == NULL)
+      return false;
+  }
+  if (typed->base.items == NULL) {
+    typed->base.items = mongory_typed_array_boxes_new(self->pool, typed->base.capacity);
+    if (typed->base.items == NULL)
+      return false;
+  }
+  if (self->pool->release != NULL)
+    self->pool->release(self->pool, typed->data.ptr,
+                        mongory_typed_array_item_size(typed->item_type) * typed->base.capacity);
+  mongory_array_init_boxed(&typed->base);
+  return true;
+}
+
+/**
+ * @brief Stores a value at an index below the capacity, if the vector can
+ * hold it. The value becomes the item's box.
+ */
+static bool mongory_typed_array_store(mongory_typed_array *typed, size_t index, mongory_value *value) {
+  if (value == NULL || value->type != typed->item_type || !mongory_value_is_plain(value))
+    return false;
+  switch (typed->item_type) {
+  case MONGORY_TYPE_INT:
+    typed->data.ints[index] = value->data.i;
+    break;
+  case MONGORY_TYPE_DOUBLE:
+    typed->data.doubles[index] = value->data.d;
+    break;
+  default:
+    if (value->data.s == NULL)
+      return false;
+    typed->data.strings[index].s = value->data.s;
+    typed->data.strings[index].len = value->len;
+    break;
+  }
+  if (typed->base.items != NULL)
+    typed->base.items[index] = value;
+  return true;
+}
+
+static inline bool mongory_typed_array_fits(mongory_typed_array *typed, mongory_value *value) {
+  return value != NULL && value->type == typed->item_type && mongory_value_is_plain(value) &&
+         (value->type != MONGORY_TYPE_STRING || value->data.s != NULL);
+}
+
+/**
+ * @brief Appends an item. Implements `array->push`.
+ */
+static bool mongory_typed_array_push(mongory_array *self, mongory_value *value) {
+  mongory_typed_array *typed = (mongory_typed_array *)self;
+  if (!mongory_typed_array_fits(typed, value)) {
+    if (!mongory_typed_array_deoptimize(typed))
+      return false;
+    return self->push(self, value);
+  }
+  if (!mongory_typed_array_grow_if_needed(typed, self->count))
+    return false;
+  mongory_typed_array_store(typed, self->count++, value);
+  return true;
+}
+
+/**
+ * @brief Sets an item. Implements `array->set`. Leaving a gap of NULL items
+ * turns the array into a boxed array.
+ */
+static bool mongory_typed_array_set(mongory_array *self, size_t index, mongory_value *value) {
+  mongory_typed_array *typed = (mongory_typed_array *)self;
+  if (index == self->count)
+    return mongory_typed_array_push(self, value);
+  if (index > self->count || !mongory_typed_array_fits(typed, value)) {
+    if (!mongory_typed_array_deoptimize(typed))
+      return false;
+    return self->set(self, index, value);
+  }
+  mongory_typed_array_store(typed, index, value);
+  return true;
+}
+
+/**
+ * @brief Returns the box of an item. Implements `array->get`.
+ */
+static mongory_value *mongory_typed_array_get(mongory_array *self, size_t index) {
+  if (index >= self->count)
+    return NULL;
+  return mongory_typed_array_box((mongory_typed_array *)self, index);
+}
+
+/**
+ * @brief Iterates over the boxes of the items. Implements `array->each`.
+ */
+static bool mongory_typed_array_each(mongory_array *self, void *acc, mongory_array_callback_func func) {
+  mongory_typed_array *typed = (mongory_typed_array *)self;
+  for (size_t i = 0; i < self->count; i++) {
+    mongory_value *item = mongory_typed_array_box(typed, i);
+    if (item == NULL || !func(item, acc))
+      return false;
+  }
+  return true;
+}
+
+mongory_array *mongory_array_new_typed(mongory_memory_pool *pool, mongory_type item_type) {
+  if (!pool)
+    return NULL; // Must have a valid pool.
+  if (item_type != MONGORY_TYPE_INT && item_type != MONGORY_TYPE_DOUBLE && item_type != MONGORY_TYPE_STRING)
+    return NULL;
+  mongory_typed_array *typed = MG_ALLOC_PTR(pool, mongory_typed_array);
+  void *data = MG_ALLOC(pool, mongory_typed_array_item_size(item_type) * MONGORY_TYPED_ARRAY_INIT_SIZE);
+  if (typed == NULL || data == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  typed->base.base.pool = pool;
+  typed->base.base.count = 0;
+  typed->base.base.each = mongory_typed_array_each;
+  typed->base.base.get = mongory_typed_array_get;
+  typed->base.base.push = mongory_typed_array_push;
+  typed->base.base.set = mongory_typed_array_set;
+  typed->base.items = NULL;
+  typed->base.capacity = MONGORY_TYPED_ARRAY_INIT_SIZE;
+  typed->item_type = item_type;
+  typed->data.ptr = data;
+  return &typed->base.base;
+}
+
+/**
+ * @brief Reserves the next item of a typed array; the caller writes it.
+ * @return The index of the new item, or `(size_t)-1` on allocation failure.
+ */
+static inline size_t mongory_typed_array_append(mongory_typed_array *typed) {
+  mongory_array *self = &typed->base.base;
+  if (!mongory_typed_array_grow_if_needed(typed, self->count))
+    return (size_t)-1;
+  if (typed->base.items != NULL)
+    typed->base.items[self->count] = NULL;
+  return self->count++;
+}
+
+bool mongory_array_push_i(mongory_array *array, int64_t i) {
+  mongory_typed_array *typed = mongory_typed_array_of(array, MONGORY_TYPE_INT);
+  if (typed == NULL) {
+    mongory_value *value = mongory_value_wrap_i(array->pool, i);
+    return value != NULL && array->push(array, value);
+  }
+  size_t index = mongory_typed_array_append(typed);
+  if (index == (size_t)-1)
+    return false;
+  typed->data.ints[index] = i;
+  return true;
+}
+
+bool mongory_array_push_d(mongory_array *array, double d) {
+  mongory_typed_array *typed = mongory_typed_array_of(array, MONGORY_TYPE_DOUBLE);
+  if (typed == NULL) {
+    mongory_value *value = mongory_value_wrap_d(array->pool, d);
+    return value != NULL && array->push(array, value);
+  }
+  size_t index = mongory_typed_array_append(typed);
+  if (index == (size_t)-1)
+    return false;
+  typed->data.doubles[index] = d;
+  return true;
+}
+
+bool mongory_array_push_sn(mongory_array *array, const char *s, size_t len) {
+  mongory_typed_array *typed = mongory_typed_array_of(array, MONGORY_TYPE_STRING);
+  if (typed == NULL || s == NULL || len > MONGORY_STRING_MAX_LEN) {
+    mongory_value *value = mongory_value_wrap_sn(array->pool, s, len);
+    return value != NULL && array->push(array, value);
+  }
+  char *copy = MG_ALLOC(array->pool, len + 1);
+  if (copy == NULL) {
+    array->pool->error = &MONGORY_ALLOC_ERROR;
+    return false;
+  }
+  memcpy(copy, s, len);
+  copy[len] = '\0';
+  size_t index = mongory_typed_array_append(typed);
+  if (index == (size_t)-1)
+    return false;
+  typed->data.strings[index].s = copy;
+  typed->data.strings[index].len = len;
+  return true;
+}
+
+bool mongory_typed_array_reserve(mongory_array *self, size_t capacity) {
+  mongory_typed_array *typed = (mongory_typed_array *)self;
+  if (capacity <= typed->base.capacity)
+    return true;
+  return mongory_typed_array_resize(typed, capacity);
+}
+
+const int64_t *mongory_array_ints(mongory_array *array) {
+  mongory_typed_array *typed = mongory_typed_array_of(array, MONGORY_TYPE_INT);
+  return typed ? typed->data.ints : NULL;
+}
+
+const double *mongory_array_doubles(mongory_array *array) {
+  mongory_typed_array *typed = mongory_typed_array_of(array, MONGORY_TYPE_DOUBLE);
+  return typed ? typed->data.doubles : NULL;
+}
+
+const mongory_string_slice *mongory_array_strings(mongory_array *array) {
+  mongory_typed_array *typed = mongory_typed_array_of(array, MONGORY_TYPE_STRING);
+  return typed ? typed->data.strings : NULL;
+}
+
+mongory_value *mongory_array_peek(mongory_array *self, size_t index, mongory_value *scratch) {
+  if (self->get != mongory_typed_array_get)
+    return self->get(self, index);
+  if (index >= self->count)
+    return NULL;
+  mongory_typed_array *typed = (mongory_typed_array *)self;
+  if (typed->base.items != NULL && typed->base.items[index] != NULL)
+    return typed->base.items[index];
+  mongory_typed_array_fill(typed, index, scratch);
+  return scratch;
+}
@@ -96,6 +96,49 @@ double mongory_log(double x, double base) {
   return log(x) / log(base);
 }
 
+uint64_t mongory_hash_u64(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+/**
+ * @brief Multiplies two words into 128 bits and folds the halves together.
+ */
+static inline uint64_t mongory_hash_fold(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t product = (__uint128_t)a * b;
+  return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+  uint64_t lo = (a & 0xffffffffULL) * (b & 0xffffffffULL);
+  uint64_t mid1 = (a >> 32) * (b & 0xffffffffULL);
+  uint64_t mid2 = (a & 0xffffffffULL) * (b >> 32);
+  uint64_t hi = (a >> 32) * (b >> 32);
+  uint64_t cross = (lo >> 32) + (mid1 & 0xffffffffULL) + mid2;
+  hi += (mid1 >> 32) + (cross >> 32);
+  return (lo & 0xffffffffULL) ^ (cross << 32) ^ hi;
+#endif
+}
+
+uint64_t mongory_hash_bytes(const void *data, size_t len) {
+  const unsigned char *bytes = (const unsigned char *)data;
+  uint64_t hash = 0x243f6a8885a308d3ULL ^ (uint64_t)len;
+  uint64_t word;
+  while (len >= 8) {
+    memcpy(&word, bytes, 8);
+    hash = mongory_hash_fold(word ^ 0xa0761d6478bd642fULL, hash ^ 0xe7037ed1a0b428dbULL);
+    bytes += 8;
+    len -= 8;
+  }
+  word = 0;
+  memcpy(&word, bytes, len);
+  hash = mongory_hash_fold(word ^ 0x8ebc6af09c88c6e3ULL, hash ^ 0x589965cc75374cc3ULL);
+  return mongory_hash_u64(hash);
+}
+
 bool mongory_validate_ptr(mongory_memory_pool *pool, char *name, void *ptr, char *file, int line) {
   if (pool->error != NULL) {
     return false;
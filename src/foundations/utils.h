@@ -4,6 +4,17 @@
 #include "mongory-core/foundations/memory_pool.h"
 #include "mongory-core/foundations/value.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Storage class specifier for thread-local variables.
+ */
+#if defined(_MSC_VER)
+#define MONGORY_THREAD_LOCAL __declspec(thread)
+#else
+#define MONGORY_THREAD_LOCAL __thread
+#endif
 
 /**
  * @brief Attempts to parse an integer from a string.
@@ -52,6 +63,24 @@ char *mongory_string_cpyf(mongory_memory_pool *pool, char *format, ...);
 
 double mongory_log(double x, double base);
 
+/**
+ * @brief Mixes the bits of a 64-bit integer (the splitmix64 finalizer), so
+ * that every input bit affects every output bit.
+ * @param x The value to mix.
+ * @return The mixed value.
+ */
+uint64_t mongory_hash_u64(uint64_t x);
+
+/**
+ * @brief Hashes a byte range. Reads eight bytes per step and folds each word
+ * with a 64x64->128-bit multiply, so long keys hash quickly and short keys
+ * still avalanche.
+ * @param data The bytes to hash.
+ * @param len The number of bytes.
+ * @return The 64-bit hash.
+ */
+uint64_t mongory_hash_bytes(const void *data, size_t len);
+
 bool mongory_validate_ptr(mongory_memory_pool *pool, char *name, void *ptr, char *file, int line);
 #define MONGORY_VALIDATE_PTR(pool, ptr) mongory_validate_ptr(pool, #ptr, ptr, __FILE__, __LINE__)
 
@@ -7,6 +7,7 @@
  * `mongory_value` has a corresponding comparison function and wrapping
  * function.
  */
+#include "array_private.h"
 #include "string_buffer.h"
 #include <mongory-core/foundations/array.h>
 #include <mongory-core/foundations/config.h> 
@@ -14,7 +15,10 @@
 #include <mongory-core/foundations/memory_pool.h>
 #include <mongory-core/foundations/table.h>
 #include <mongory-core/foundations/value.h>
+#include <mongory-core/foundations/sink.h>
 #include "config_private.h"
+#include "string_interner_private.h"
+#include "value_private.h"
 #include <stddef.h> // For NULL
 #include <stdio.h>  // For snprintf
 #include <stdlib.h> // For general utilities (not directly used here but common)
@@ -62,21 +66,237 @@ void *mongory_value_extract(mongory_value *value) {
   }
 }
 
-static char *mongory_value_null_to_str(mongory_value *value, mongory_memory_pool *pool);
-static char *mongory_value_bool_to_str(mongory_value *value, mongory_memory_pool *pool);
-static char *mongory_value_int_to_str(mongory_value *value, mongory_memory_pool *pool);
-static char *mongory_value_double_to_str(mongory_value *value, mongory_memory_pool *pool);
-static char *mongory_value_string_to_str(mongory_value *value, mongory_memory_pool *pool);
-static char *mongory_value_array_to_str(mongory_value *value, mongory_memory_pool *pool);
-static char *mongory_value_table_to_str(mongory_value *value, mongory_memory_pool *pool);
-static char *mongory_value_generic_ptr_to_str(mongory_value *value, mongory_memory_pool *pool);
+static bool mongory_value_null_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_bool_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_int_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_double_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_string_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_array_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_table_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_generic_ptr_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_regex_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_datetime_serialize(mongory_value *value, mongory_sink *sink);
+static bool mongory_value_binary_serialize(mongory_value *value, mongory_sink *sink);
+static char *mongory_value_builtin_to_str(mongory_value *value, mongory_memory_pool *pool);
+static int mongory_value_null_compare(mongory_value *a, mongory_value *b);
+static int mongory_value_bool_compare(mongory_value *a, mongory_value *b);
+static int mongory_value_int_compare(mongory_value *a, mongory_value *b);
+static int mongory_value_double_compare(mongory_value *a, mongory_value *b);
+static int mongory_value_string_compare(mongory_value *a, mongory_value *b);
+static int mongory_value_array_compare(mongory_value *a, mongory_value *b);
+static int mongory_value_table_compare(mongory_value *a, mongory_value *b);
+static int mongory_value_generic_ptr_compare(mongory_value *a, mongory_value *b);
+static int mongory_value_datetime_compare(mongory_value *a, mongory_value *b);
+static int mongory_value_binary_compare(mongory_value *a, mongory_value *b);
+
+/**
+ * @brief The built-in behaviour of one value type.
+ */
+typedef bool (*mongory_value_serialize_func)(mongory_value *value, mongory_sink *sink);
+
+typedef struct mongory_value_type_ops {
+  mongory_value_compare_func comp;        /**< Compares a value of the type with another value. */
+  mongory_value_serialize_func serialize; /**< Writes a value of the type to a sink. */
+} mongory_value_type_ops;
+
+static const mongory_value_type_ops mongory_value_null_ops = {mongory_value_null_compare,
+                                                              mongory_value_null_serialize};
+static const mongory_value_type_ops mongory_value_bool_ops = {mongory_value_bool_compare,
+                                                              mongory_value_bool_serialize};
+static const mongory_value_type_ops mongory_value_int_ops = {mongory_value_int_compare, mongory_value_int_serialize};
+static const mongory_value_type_ops mongory_value_double_ops = {mongory_value_double_compare,
+                                                                mongory_value_double_serialize};
+static const mongory_value_type_ops mongory_value_string_ops = {mongory_value_string_compare,
+                                                                mongory_value_string_serialize};
+static const mongory_value_type_ops mongory_value_array_ops = {mongory_value_array_compare,
+                                                               mongory_value_array_serialize};
+static const mongory_value_type_ops mongory_value_table_ops = {mongory_value_table_compare,
+                                                               mongory_value_table_serialize};
+static const mongory_value_type_ops mongory_value_regex_ops = {mongory_value_generic_ptr_compare,
+                                                               mongory_value_regex_serialize};
+static const mongory_value_type_ops mongory_value_datetime_ops = {mongory_value_datetime_compare,
+                                                                  mongory_value_datetime_serialize};
+static const mongory_value_type_ops mongory_value_binary_ops = {mongory_value_binary_compare,
+                                                                mongory_value_binary_serialize};
+static const mongory_value_type_ops mongory_value_generic_ptr_ops = {mongory_value_generic_ptr_compare,
+                                                                     mongory_value_generic_ptr_serialize};
+
+/**
+ * @brief Returns the built-in operations of a type. Unknown types get the
+ * operations of generic pointers, which never compare equal.
+ */
+static inline const mongory_value_type_ops *mongory_value_ops(mongory_type type) {
+  switch (type) {
+  case MONGORY_TYPE_NULL:
+    return &mongory_value_null_ops;
+  case MONGORY_TYPE_BOOL:
+    return &mongory_value_bool_ops;
+  case MONGORY_TYPE_INT:
+    return &mongory_value_int_ops;
+  case MONGORY_TYPE_DOUBLE:
+    return &mongory_value_double_ops;
+  case MONGORY_TYPE_STRING:
+    return &mongory_value_string_ops;
+  case MONGORY_TYPE_ARRAY:
+    return &mongory_value_array_ops;
+  case MONGORY_TYPE_TABLE:
+    return &mongory_value_table_ops;
+  case MONGORY_TYPE_REGEX:
+    return &mongory_value_regex_ops;
+  case MONGORY_TYPE_DATETIME:
+    return &mongory_value_datetime_ops;
+  case MONGORY_TYPE_BINARY:
+    return &mongory_value_binary_ops;
+  default:
+    return &mongory_value_generic_ptr_ops;
+  }
+}
+
+int mongory_value_type_compare(mongory_value *a, mongory_value *b) { return mongory_value_ops(a->type)->comp(a, b); }
+
+char *mongory_value_type_to_str(mongory_value *value, mongory_memory_pool *pool) {
+  return mongory_value_builtin_to_str(value, pool);
+}
+
+/** Seeds of the hashes of values without a payload to hash. */
+#define MONGORY_VALUE_HASH_NULL 0x6e756c6cULL
+#define MONGORY_VALUE_HASH_TRUE 0x74727565ULL
+#define MONGORY_VALUE_HASH_FALSE 0x66616c73ULL
+#define MONGORY_VALUE_HASH_NAN 0x4e614eULL
+#define MONGORY_VALUE_HASH_DATETIME 0x64617465ULL
+
+static bool mongory_value_table_hash_each(char *key, mongory_value *value, void *acc) {
+  uint64_t pair = mongory_table_hash_key(key, strlen(key)) ^ (mongory_value_hash(value) * 0x9e3779b97f4a7c15ULL);
+  *(uint64_t *)acc += mongory_hash_u64(pair); // A sum does not depend on the iteration order.
+  return true;
+}
+
+uint64_t mongory_value_hash(mongory_value *value) {
+  if (value == NULL)
+    return MONGORY_VALUE_HASH_NULL; // Arrays treat NULL items as nulls.
+  switch (value->type) {
+  case MONGORY_TYPE_NULL:
+    return MONGORY_VALUE_HASH_NULL;
+  case MONGORY_TYPE_BOOL:
+    return value->data.b ? MONGORY_VALUE_HASH_TRUE : MONGORY_VALUE_HASH_FALSE;
+  case MONGORY_TYPE_INT:
+  case MONGORY_TYPE_DOUBLE: {
+    // Equal ints and doubles convert to the same double.
+    double number = value->type == MONGORY_TYPE_INT ? (double)value->data.i : value->data.d;
+    if (number != number)
+      return MONGORY_VALUE_HASH_NAN;
+    if (number == 0.0)
+      number = 0.0; // -0.0 and 0.0 compare equal.
+    uint64_t bits;
+    memcpy(&bits, &number, sizeof(bits));
+    return mongory_hash_u64(bits);
+  }
+  case MONGORY_TYPE_STRING:
+    if (value->data.s == NULL)
+      return MONGORY_VALUE_HASH_NULL;
+    if (value->interned)
+      return mongory_string_intern_entry_of(value)->hash;
+    return mongory_hash_bytes(value->data.s, value->len);
+  case MONGORY_TYPE_DATETIME:
+    return mongory_hash_u64((uint64_t)value->data.i ^ MONGORY_VALUE_HASH_DATETIME);
+  case MONGORY_TYPE_BINARY:
+    if (value->data.bin == NULL)
+      return MONGORY_VALUE_HASH_NULL;
+    return mongory_hash_bytes(value->data.bin, value->len);
+  case MONGORY_TYPE_ARRAY: {
+    struct mongory_array *array = value->data.a;
+    if (array == NULL)
+      return MONGORY_VALUE_HASH_NULL;
+    uint64_t hash = mongory_hash_u64(array->count);
+    mongory_value scratch;
+    for (size_t i = 0; i < array->count; i++) {
+      mongory_value *item = mongory_array_peek(array, i, &scratch);
+      hash = mongory_hash_u64(hash ^ mongory_value_hash(item));
+    }
+    return hash;
+  }
+  case MONGORY_TYPE_TABLE: {
+    struct mongory_table *table = value->data.t;
+    if (table == NULL)
+      return MONGORY_VALUE_HASH_NULL;
+    uint64_t sum = 0;
+    table->each(table, &sum, mongory_value_table_hash_each);
+    return mongory_hash_u64(sum ^ table->count);
+  }
+  default:
+    // Pointer-like values never compare equal; any hash will do.
+    return mongory_hash_u64((uint64_t)(uintptr_t)value->data.ptr);
+  }
+}
+
+bool mongory_value_equal(mongory_value *a, mongory_value *b) {
+#ifdef MONGORY_COMPACT_VALUE
+  bool builtin = true;
+#else
+  // An overridden `comp` decides by itself.
+  bool builtin = a->comp == mongory_value_string_compare || a->comp == mongory_value_binary_compare;
+#endif
+  if (builtin && a->type == MONGORY_TYPE_BINARY && b->type == MONGORY_TYPE_BINARY) {
+    if (a->data.bin == NULL || b->data.bin == NULL || a->len != b->len)
+      return false;
+    return a->data.bin == b->data.bin || memcmp(a->data.bin, b->data.bin, a->len) == 0;
+  }
+  if (builtin && a->type == MONGORY_TYPE_STRING && b->type == MONGORY_TYPE_STRING) {
+    if (a->data.s == NULL || b->data.s == NULL || a->len != b->len)
+      return false;
+    if (a->data.s == b->data.s)
+      return true;
+    if (a->interned && b->interned) {
+      mongory_string_intern_entry *a_entry = mongory_string_intern_entry_of(a);
+      mongory_string_intern_entry *b_entry = mongory_string_intern_entry_of(b);
+      if (a_entry->hash != b_entry->hash || a_entry->interner == b_entry->interner)
+        return false; // One interner never holds two copies of a string.
+    }
+    return memcmp(a->data.s, b->data.s, a->len) == 0;
+  }
+  return mongory_value_compare(a, b) == 0;
+}
+
+void mongory_value_init(mongory_value *value, mongory_type type) {
+  value->type = type;
+  value->len = 0;
+  value->interned = 0;
+#ifndef MONGORY_COMPACT_VALUE
+  value->pool = NULL;
+  value->origin = NULL;
+  value->comp = mongory_value_ops(type)->comp;
+  value->to_str = mongory_value_builtin_to_str;
+#endif
+}
+
+bool mongory_value_is_plain(mongory_value *value) {
+#ifdef MONGORY_COMPACT_VALUE
+  (void)value;
+  return true;
+#else
+  return value->comp == mongory_value_ops(value->type)->comp && value->to_str == mongory_value_builtin_to_str &&
+         value->origin == NULL;
+#endif
+}
+
+bool mongory_value_has_builtin_comp(mongory_value *value) {
+#ifdef MONGORY_COMPACT_VALUE
+  (void)value;
+  return true;
+#else
+  return value->comp == mongory_value_ops(value->type)->comp;
+#endif
+}
 
 /**
  * @brief Internal helper to allocate a new mongory_value structure from a pool.
+ * Sets the type and, unless values are compact, the pool, origin, the
+ * type's built-in `comp` and the built-in `to_str`.
  * @param pool The memory pool to allocate from.
+ * @param type The type of the new value.
  * @return A pointer to the new mongory_value, or NULL on allocation failure.
  */
-static inline mongory_value *mongory_value_new(mongory_memory_pool *pool) {
+static inline mongory_value *mongory_value_new(mongory_memory_pool *pool, mongory_type type) {
   if (!pool || !pool->alloc)
     return NULL; // Invalid pool.
   mongory_value *value = MG_ALLOC_PTR(pool, mongory_value);
@@ -84,8 +304,10 @@ static inline mongory_value *mongory_value_new(mongory_memory_pool *pool) {
     pool->error = &MONGORY_ALLOC_ERROR;
     return NULL;
   }
+  mongory_value_init(value, type);
+#ifndef MONGORY_COMPACT_VALUE
   value->pool = pool;
-  value->origin = NULL; // Default origin to NULL.
+#endif
   return value;
 }
 
@@ -110,12 +332,9 @@ static inline int mongory_value_null_compare(mongory_value *a, mongory_value *b)
 /** Wraps a NULL value. The `n` parameter is ignored. */
 mongory_value *mongory_value_wrap_n(mongory_memory_pool *pool, void *n) {
   (void)n; // Parameter 'n' is unused for wrapping NULL.
-  mongory_value *value = mongory_value_new(pool);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_NULL);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_NULL;
-  value->comp = mongory_value_null_compare;
-  value->to_str = mongory_value_null_to_str;
   // data union is not explicitly set for NULL.
   return value;
 }
@@ -125,7 +344,7 @@ mongory_value *mongory_value_wrap_n(mongory_memory_pool *pool, void *n) {
 //
 // These functions create a `mongory_value` and wrap a native C type
 // (like bool, int, char*). They allocate the value from the memory pool and
-// set its type, data, and function pointers (`comp`, `to_str`).
+// set its type and data; `mongory_value_new` fills in the type's operations.
 // ============================================================================
 
 /** Compares two MONGORY_TYPE_BOOL values. */
@@ -138,13 +357,10 @@ static inline int mongory_value_bool_compare(mongory_value *a, mongory_value *b)
 
 /** Wraps a boolean value. */
 mongory_value *mongory_value_wrap_b(mongory_memory_pool *pool, bool b_val) {
-  mongory_value *value = mongory_value_new(pool);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_BOOL);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_BOOL;
   value->data.b = b_val;
-  value->comp = mongory_value_bool_compare;
-  value->to_str = mongory_value_bool_to_str;
   return value;
 }
 
@@ -167,13 +383,10 @@ static inline int mongory_value_int_compare(mongory_value *a, mongory_value *b)
 
 /** Wraps an integer (promoted to int64_t). */
 mongory_value *mongory_value_wrap_i(mongory_memory_pool *pool, int64_t i_val) {
-  mongory_value *value = mongory_value_new(pool);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_INT);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_INT;
   value->data.i = i_val;
-  value->comp = mongory_value_int_compare;
-  value->to_str = mongory_value_int_to_str;
   return value;
 }
 
@@ -195,48 +408,84 @@ static inline int mongory_value_double_compare(mongory_value *a, mongory_value *
 
 /** Wraps a double value. */
 mongory_value *mongory_value_wrap_d(mongory_memory_pool *pool, double d_val) {
-  mongory_value *value = mongory_value_new(pool);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_DOUBLE);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_DOUBLE;
   value->data.d = d_val;
-  value->comp = mongory_value_double_compare;
-  value->to_str = mongory_value_double_to_str;
   return value;
 }
 
-/** Compares two MONGORY_TYPE_STRING values lexicographically. */
+/**
+ * Compares two MONGORY_TYPE_STRING values byte-wise, a proper prefix sorting
+ * first. Same order as `strcmp` for strings without embedded '\0'.
+ */
 static inline int mongory_value_string_compare(mongory_value *a, mongory_value *b) {
   // Ensure both are strings and not NULL pointers.
   if (b->type != MONGORY_TYPE_STRING || a->data.s == NULL || b->data.s == NULL) {
-    // If one is NULL string and other is not, how to compare?
-    // For now, strict: both must be valid strings.
-    // Or, define NULL string < non-NULL string.
     // Current: fail if not string or if actual char* is NULL.
     return mongory_value_compare_fail;
   }
-  int cmp_result = strcmp(a->data.s, b->data.s);
+  size_t a_len = a->len;
+  size_t b_len = b->len;
+  int cmp_result = memcmp(a->data.s, b->data.s, a_len < b_len ? a_len : b_len);
+  if (cmp_result == 0)
+    return (a_len > b_len) - (a_len < b_len);
   return (cmp_result > 0) - (cmp_result < 0); // Normalize to -1, 0, 1
 }
 
-/** Wraps a string. Makes a copy of the string using the pool. */
-mongory_value *mongory_value_wrap_s(mongory_memory_pool *pool, char *s_val) {
-  mongory_value *value = mongory_value_new(pool);
+static mongory_error mongory_value_string_too_long_error = {
+  .type = MONGORY_ERROR_INVALID_ARGUMENT,
+  .message = "String length exceeds MONGORY_STRING_MAX_LEN",
+};
+
+/**
+ * @brief Wraps `len` bytes at `s` as a string value without copying them.
+ */
+static inline mongory_value *mongory_value_string_new(mongory_memory_pool *pool, char *s, size_t len) {
+  if (pool && len > MONGORY_STRING_MAX_LEN) {
+    pool->error = &mongory_value_string_too_long_error;
+    return NULL;
+  }
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_STRING);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_STRING;
-  // `mongory_string_cpy` handles the allocation and copying of the string.
-  // If `s_val` is NULL, `value->data.s` will be NULL.
-  // If allocation fails, `value->data.s` will also be NULL.
-  // TODO: This function should ideally return NULL if the string copy fails
-  // when `s_val` was not NULL, but this requires a more complex error handling
-  // strategy with the memory pool.
-  value->data.s = mongory_string_cpy(pool, s_val);
-  value->comp = mongory_value_string_compare;
-  value->to_str = mongory_value_string_to_str;
+  value->data.s = s;
+  value->len = (unsigned int)len;
   return value;
 }
 
+/** Wraps a string. Makes a copy of the string using the pool. */
+mongory_value *mongory_value_wrap_s(mongory_memory_pool *pool, char *s_val) {
+  if (s_val == NULL)
+    return mongory_value_string_new(pool, NULL, 0); // A NULL string never compares equal.
+  return mongory_value_wrap_sn(pool, s_val, strlen(s_val));
+}
+
+/** Wraps `len` bytes of a string. Copies them into the pool with a terminator. */
+mongory_value *mongory_value_wrap_sn(mongory_memory_pool *pool, const char *s_val, size_t len) {
+  if (!pool || !pool->alloc)
+    return NULL;
+  if (s_val == NULL)
+    return mongory_value_string_new(pool, NULL, 0);
+  if (len > MONGORY_STRING_MAX_LEN) {
+    pool->error = &mongory_value_string_too_long_error;
+    return NULL;
+  }
+  char *copy = MG_ALLOC(pool, len + 1);
+  if (!copy) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  memcpy(copy, s_val, len);
+  copy[len] = '\0';
+  return mongory_value_string_new(pool, copy, len);
+}
+
+/** Wraps a '\0'-terminated string of `len` bytes that stays owned by the caller. */
+mongory_value *mongory_value_wrap_s_borrowed(mongory_memory_pool *pool, const char *s_val, size_t len) {
+  return mongory_value_string_new(pool, (char *)s_val, s_val ? len : 0);
+}
+
 /** Compares two MONGORY_TYPE_ARRAY values element by element. */
 static inline int mongory_value_array_compare(mongory_value *a, mongory_value *b) {
   if (b->type != MONGORY_TYPE_ARRAY || a->data.a == NULL || b->data.a == NULL) {
@@ -252,9 +501,10 @@ static inline int mongory_value_array_compare(mongory_value *a, mongory_value *b
   }
 
   // Same count, compare element by element.
+  mongory_value scratch_a, scratch_b;
   for (size_t i = 0; i < array_a->count; i++) {
-    mongory_value *item_a = array_a->get(array_a, i);
-    mongory_value *item_b = array_b->get(array_b, i);
+    mongory_value *item_a = mongory_array_peek(array_a, i, &scratch_a);
+    mongory_value *item_b = mongory_array_peek(array_b, i, &scratch_b);
 
     // Handle NULL elements within arrays carefully.
     bool a_item_is_null = (item_a == NULL || item_a->type == MONGORY_TYPE_NULL);
@@ -267,11 +517,8 @@ static inline int mongory_value_array_compare(mongory_value *a, mongory_value *b
     if (b_item_is_null)
       return 1; // Non-null is greater than null.
 
-    // Both items are non-null, compare them using their own comp functions.
-    if (!item_a->comp || !item_b->comp)
-      return mongory_value_compare_fail; // Should not happen for valid values
-
-    int cmp_result = item_a->comp(item_a, item_b);
+    // Both items are non-null, compare them with the first item's compare.
+    int cmp_result = mongory_value_compare(item_a, item_b);
     if (cmp_result == mongory_value_compare_fail)
       return mongory_value_compare_fail; // Incomparable elements
     if (cmp_result != 0) {
@@ -283,36 +530,75 @@ static inline int mongory_value_array_compare(mongory_value *a, mongory_value *b
 
 /** Wraps a mongory_array. */
 mongory_value *mongory_value_wrap_a(mongory_memory_pool *pool, struct mongory_array *a_val) {
-  mongory_value *value = mongory_value_new(pool);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_ARRAY);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_ARRAY;
   value->data.a = a_val;
-  value->comp = mongory_value_array_compare;
-  value->to_str = mongory_value_array_to_str;
   return value;
 }
 
-/** Compares two MONGORY_TYPE_TABLE values. Currently unsupported (always fails). */
+/** Accumulator of `mongory_value_table_find_null_each`. */
+typedef struct mongory_value_table_null_key {
+  char *key;  /**< Key looked for. */
+  bool found; /**< Set once `key` is seen holding NULL. */
+} mongory_value_table_null_key;
+
+/** Stops the iteration at the key looked for, if it holds NULL. */
+static bool mongory_value_table_find_null_each(char *key, mongory_value *value, void *acc) {
+  mongory_value_table_null_key *target = (mongory_value_table_null_key *)acc;
+  if (value == NULL && strcmp(key, target->key) == 0) {
+    target->found = true;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Table comparison callback: looks `key` of table `a` up in table `b` (the
+ * accumulator) and stops the iteration at the first mismatch. A NULL value
+ * on either side only matches a NULL on the other. `get` cannot tell a NULL
+ * value from a missing key, so a NULL in `a` is only matched once `b` is
+ * scanned and found to hold that key too.
+ */
+static bool mongory_value_table_compare_each(char *key, mongory_value *value, void *acc) {
+  mongory_table *other = (mongory_table *)acc;
+  mongory_value *other_value = other->get(other, key);
+  if (value == NULL) {
+    if (other_value != NULL)
+      return false;
+    mongory_value_table_null_key target = {.key = key, .found = false};
+    other->each(other, &target, mongory_value_table_find_null_each);
+    return target.found;
+  }
+  if (other_value == NULL)
+    return false;
+  return mongory_value_equal(value, other_value);
+}
+
+/**
+ * Compares two MONGORY_TYPE_TABLE values. Tables have no order, so they are
+ * either equal (same keys, equal values) or incomparable.
+ */
 static inline int mongory_value_table_compare(mongory_value *a, mongory_value *b) {
-  (void)a; // Unused.
-  (void)b; // Unused.
-  // True table comparison is complex because the order of keys is not
-  // significant. It would require iterating over keys of one table and checking
-  // for their presence and value equality in the other. This is not
-  // implemented. Therefore, tables are considered incomparable.
-  return mongory_value_compare_fail;
+  if (b->type != MONGORY_TYPE_TABLE || a->data.t == NULL || b->data.t == NULL) {
+    return mongory_value_compare_fail; // Must be two valid tables.
+  }
+  struct mongory_table *table_a = a->data.t;
+  struct mongory_table *table_b = b->data.t;
+  if (table_a == table_b)
+    return 0;
+  if (table_a->count != table_b->count)
+    return mongory_value_compare_fail;
+  // Same count and every key of `a` has an equal value in `b`: same keys.
+  return table_a->each(table_a, table_b, mongory_value_table_compare_each) ? 0 : mongory_value_compare_fail;
 }
 
 /** Wraps a mongory_table. */
 mongory_value *mongory_value_wrap_t(mongory_memory_pool *pool, struct mongory_table *t_val) {
-  mongory_value *value = mongory_value_new(pool);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_TABLE);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_TABLE;
   value->data.t = t_val;
-  value->comp = mongory_value_table_compare;
-  value->to_str = mongory_value_table_to_str;
   return value;
 }
 
@@ -326,175 +612,361 @@ static inline int mongory_value_generic_ptr_compare(mongory_value *a, mongory_va
 
 /** Wraps an unsupported/unknown type pointer. */
 mongory_value *mongory_value_wrap_u(mongory_memory_pool *pool, void *u_val) {
-  mongory_value *value = mongory_value_new(pool);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_UNSUPPORTED);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_UNSUPPORTED;
   value->data.u = u_val;
-  value->comp = mongory_value_generic_ptr_compare; // Unsupported types are not comparable.
-  value->to_str = mongory_value_generic_ptr_to_str;
   return value;
 }
 
-static char *mongory_value_regex_to_str(mongory_value *value, mongory_memory_pool *pool) {
-  char *str = mongory_internal_regex_adapter.stringify_func(pool, value);
-  if (!str)
-    return NULL;
-  return str;
-}
-
 /** Wraps a regex type pointer. */
 mongory_value *mongory_value_wrap_regex(mongory_memory_pool *pool, void *regex_val) {
-  mongory_value *value = mongory_value_new(pool);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_REGEX);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_REGEX;
   value->data.regex = regex_val;
-  value->comp = mongory_value_generic_ptr_compare; // Regex values are not directly comparable.
-  value->to_str = mongory_value_regex_to_str;
   return value;
 }
 
 /** Wraps a generic void pointer. */
 mongory_value *mongory_value_wrap_ptr(mongory_memory_pool *pool, void *ptr_val) {
-  mongory_value *value = mongory_value_new(pool);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_POINTER);
   if (!value)
     return NULL;
-  value->type = MONGORY_TYPE_POINTER;
   value->data.ptr = ptr_val;
-  value->comp = mongory_value_generic_ptr_compare; // Generic pointers are not comparable.
-  value->to_str = mongory_value_generic_ptr_to_str;
   return value;
 }
 
-// ============================================================================
-// Stringify Functions
-//
-// Each data type has a corresponding `to_str` function that converts the
-// value to a string representation (often JSON-like) and appends it to a
-// `mongory_string_buffer`.
-// ============================================================================
-
-static char *mongory_value_null_to_str(mongory_value *value, mongory_memory_pool *pool) {
-  (void)value;
-  return mongory_string_cpy(pool, "null");
+/** Compares MONGORY_TYPE_DATETIME with DATETIME. */
+static inline int mongory_value_datetime_compare(mongory_value *a, mongory_value *b) {
+  if (b->type != MONGORY_TYPE_DATETIME)
+    return mongory_value_compare_fail; // Datetimes are not numbers.
+  return (a->data.i > b->data.i) - (a->data.i < b->data.i);
 }
 
-static char *mongory_value_bool_to_str(mongory_value *value, mongory_memory_pool *pool) {
-  if (!MONGORY_VALIDATE_PTR(pool, &value->data.b)) {
+/** Wraps a datetime, in nanoseconds since the Unix epoch. */
+mongory_value *mongory_value_wrap_datetime(mongory_memory_pool *pool, int64_t ns) {
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_DATETIME);
+  if (!value)
     return NULL;
-  }
-  return mongory_string_cpy(pool, value->data.b ? "true" : "false");
+  value->data.i = ns;
+  return value;
 }
 
-static char *mongory_value_int_to_str(mongory_value *value, mongory_memory_pool *pool) {
-  if (!MONGORY_VALIDATE_PTR(pool, &value->data.i)) {
-    return NULL;
-  }
-  return mongory_string_cpyf(pool, "%lld", (long long)value->data.i);
+/** Compares two MONGORY_TYPE_BINARY values: by length, then byte-wise. */
+static inline int mongory_value_binary_compare(mongory_value *a, mongory_value *b) {
+  if (b->type != MONGORY_TYPE_BINARY || a->data.bin == NULL || b->data.bin == NULL)
+    return mongory_value_compare_fail;
+  if (a->len != b->len)
+    return a->len < b->len ? -1 : 1;
+  int cmp_result = memcmp(a->data.bin, b->data.bin, a->len);
+  return (cmp_result > 0) - (cmp_result < 0);
 }
 
-static char *mongory_value_double_to_str(mongory_value *value, mongory_memory_pool *pool) {
-  if (!MONGORY_VALIDATE_PTR(pool, &value->data.d)) {
+static mongory_error mongory_value_binary_too_long_error = {
+  .type = MONGORY_ERROR_INVALID_ARGUMENT,
+  .message = "Binary length exceeds MONGORY_STRING_MAX_LEN",
+};
+
+/** Wraps `len` bytes as a binary without copying them. */
+mongory_value *mongory_value_wrap_binary_borrowed(mongory_memory_pool *pool, const void *bin, size_t len) {
+  if (pool && len > MONGORY_STRING_MAX_LEN) {
+    pool->error = &mongory_value_binary_too_long_error;
     return NULL;
   }
-  return mongory_string_cpyf(pool, "%f", value->data.d);
+  mongory_value *value = mongory_value_new(pool, MONGORY_TYPE_BINARY);
+  if (!value)
+    return NULL;
+  value->data.bin = (unsigned char *)bin;
+  value->len = (unsigned int)len;
+  return value;
 }
 
-static char *mongory_value_string_to_str(mongory_value *value, mongory_memory_pool *pool) {
-  if (!MONGORY_VALIDATE_PTR(pool, value->data.s)) {
+/** Wraps `len` bytes as a binary. Copies them into the pool. */
+mongory_value *mongory_value_wrap_binary(mongory_memory_pool *pool, const void *bin, size_t len) {
+  if (!pool || !pool->alloc)
+    return NULL;
+  if (bin == NULL)
+    return mongory_value_wrap_binary_borrowed(pool, NULL, 0); // A NULL binary never compares equal.
+  if (len > MONGORY_STRING_MAX_LEN) {
+    pool->error = &mongory_value_binary_too_long_error;
     return NULL;
   }
-  return mongory_string_cpyf(pool, "\"%s\"", value->data.s);
+  unsigned char *copy = MG_ALLOC(pool, len > 0 ? len : 1);
+  if (!copy) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  memcpy(copy, bin, len);
+  return mongory_value_wrap_binary_borrowed(pool, copy, len);
+}
+
+// ============================================================================
+// Shared Values
+//
+// Statically allocated values for null, the booleans and small integers.
+// They belong to no pool and live for the whole program.
+// ============================================================================
+
+#ifdef MONGORY_COMPACT_VALUE
+#define MONGORY_SHARED_VALUE(value_type, ops, field, v)                                                                \
+  { .type = (value_type), .data = {.field = (v)} }
+#else
+#define MONGORY_SHARED_VALUE(value_type, ops, field, v)                                                                \
+  { .type = (value_type), .comp = ops##_compare, .to_str = mongory_value_builtin_to_str, .data = {.field = (v)} }
+#endif
+
+#define MONGORY_SHARED_INT(n) MONGORY_SHARED_VALUE(MONGORY_TYPE_INT, mongory_value_int, i, (n)),
+#define MONGORY_SHARED_INT_2(n) MONGORY_SHARED_INT(n) MONGORY_SHARED_INT((n) + 1)
+#define MONGORY_SHARED_INT_4(n) MONGORY_SHARED_INT_2(n) MONGORY_SHARED_INT_2((n) + 2)
+#define MONGORY_SHARED_INT_8(n) MONGORY_SHARED_INT_4(n) MONGORY_SHARED_INT_4((n) + 4)
+#define MONGORY_SHARED_INT_16(n) MONGORY_SHARED_INT_8(n) MONGORY_SHARED_INT_8((n) + 8)
+#define MONGORY_SHARED_INT_32(n) MONGORY_SHARED_INT_16(n) MONGORY_SHARED_INT_16((n) + 16)
+#define MONGORY_SHARED_INT_64(n) MONGORY_SHARED_INT_32(n) MONGORY_SHARED_INT_32((n) + 32)
+#define MONGORY_SHARED_INT_128(n) MONGORY_SHARED_INT_64(n) MONGORY_SHARED_INT_64((n) + 64)
+
+static mongory_value mongory_value_shared_null = MONGORY_SHARED_VALUE(MONGORY_TYPE_NULL, mongory_value_null, i, 0);
+static mongory_value mongory_value_shared_true = MONGORY_SHARED_VALUE(MONGORY_TYPE_BOOL, mongory_value_bool, b, true);
+static mongory_value mongory_value_shared_false = MONGORY_SHARED_VALUE(MONGORY_TYPE_BOOL, mongory_value_bool, b, false);
+
+/** Shared ints, from MONGORY_SHARED_INT_MIN to MONGORY_SHARED_INT_MAX. */
+static mongory_value mongory_value_shared_ints[MONGORY_SHARED_INT_MAX - MONGORY_SHARED_INT_MIN + 1] = {
+    MONGORY_SHARED_INT_128(-128) MONGORY_SHARED_INT_128(0) MONGORY_SHARED_INT_128(128) MONGORY_SHARED_INT_128(256)
+        MONGORY_SHARED_INT_128(384) MONGORY_SHARED_INT_128(512) MONGORY_SHARED_INT_128(640)
+            MONGORY_SHARED_INT_128(768) MONGORY_SHARED_INT_128(896)};
+
+/** Returns the shared null. The pool and `n` are unused. */
+mongory_value *mongory_value_wrap_n_shared(mongory_memory_pool *pool, void *n) {
+  (void)pool;
+  (void)n;
+  return &mongory_value_shared_null;
+}
+
+/** Returns the shared true or false. The pool is unused. */
+mongory_value *mongory_value_wrap_b_shared(mongory_memory_pool *pool, bool b_val) {
+  (void)pool;
+  return b_val ? &mongory_value_shared_true : &mongory_value_shared_false;
+}
+
+/** Returns a shared small int, or wraps a new one from the pool. */
+mongory_value *mongory_value_wrap_i_shared(mongory_memory_pool *pool, int64_t i_val) {
+  if (i_val >= MONGORY_SHARED_INT_MIN && i_val <= MONGORY_SHARED_INT_MAX)
+    return &mongory_value_shared_ints[i_val - MONGORY_SHARED_INT_MIN];
+  return mongory_value_wrap_i(pool, i_val);
 }
 
-typedef struct mongory_value_container_to_str_ctx {
-  size_t count;
-  size_t total;
-  mongory_string_buffer *buffer; /**< The string buffer to append to. */
-} mongory_value_container_to_str_ctx;
+// ============================================================================
+// Serialize Functions
+//
+// Each data type has a corresponding `serialize` function that writes the
+// value to a sink, JSON for the data types. Containers write their items in
+// the same pass, so no intermediate strings are built. `to_str` serializes
+// into a pool string.
+// ============================================================================
 
-static bool mongory_value_array_to_str_each(mongory_value *value, void *ctx) {
-  mongory_value_container_to_str_ctx *context = (mongory_value_container_to_str_ctx *)ctx;
-  mongory_string_buffer *buffer = context->buffer;
-  mongory_memory_pool *pool = buffer->pool;
-  MONGORY_VALIDATE_PTR(pool, value);
-  MONGORY_VALIDATE_PTR(pool, value->to_str);
-  if (pool->error != NULL) {
-    return false;
+static bool mongory_value_serialize_fail(mongory_sink *sink) {
+  sink->failed = true;
+  return false;
+}
+
+/**
+ * @def MONGORY_VALUE_SERIALIZE_BUFFER_SIZE
+ * @brief Size of the stack buffer a temporary stringification pool starts in.
+ */
+#define MONGORY_VALUE_SERIALIZE_BUFFER_SIZE 1024
+
+/**
+ * @brief Writes the string a pool-based stringifier returns for a value,
+ * using the sink's scratch pool or a temporary one over a stack buffer.
+ */
+static bool mongory_value_serialize_with(mongory_value *value, mongory_sink *sink, mongory_value_to_str_func to_str) {
+  mongory_memory_pool *pool = sink->pool;
+  mongory_memory_pool *temp_pool = NULL;
+  char buffer[MONGORY_VALUE_SERIALIZE_BUFFER_SIZE];
+  if (pool == NULL) {
+    pool = temp_pool = mongory_memory_pool_init_with_buffer(buffer, sizeof(buffer));
+    if (pool == NULL)
+      return mongory_value_serialize_fail(sink);
   }
-  char *str = value->to_str(value, pool);
-  if (!str)
-    return false;
-  mongory_string_buffer_append(buffer, str);
-  context->count++;
-  if (context->count < context->total) {
-    mongory_string_buffer_append(buffer, ",");
+  char *str = to_str(value, pool);
+  bool written = str != NULL ? mongory_sink_puts(sink, str) : mongory_value_serialize_fail(sink);
+  if (temp_pool != NULL)
+    temp_pool->free(temp_pool);
+  return written;
+}
+
+bool mongory_value_serialize(mongory_value *value, mongory_sink *sink) {
+  if (value == NULL)
+    return mongory_value_serialize_fail(sink);
+#ifndef MONGORY_COMPACT_VALUE
+  if (value->to_str != mongory_value_builtin_to_str) {
+    if (value->to_str == NULL)
+      return mongory_value_serialize_fail(sink);
+    return mongory_value_serialize_with(value, sink, value->to_str);
   }
-  return true;
+#endif
+  return mongory_value_ops(value->type)->serialize(value, sink);
 }
 
-static char *mongory_value_array_to_str(mongory_value *value, mongory_memory_pool *pool) {
+/**
+ * @brief The built-in `to_str` of every type: serializes the value, ignoring
+ * any override on the value itself, into a string allocated from `pool`.
+ */
+static char *mongory_value_builtin_to_str(mongory_value *value, mongory_memory_pool *pool) {
   mongory_string_buffer *buffer = mongory_string_buffer_new(pool);
   if (!buffer)
     return NULL;
-  mongory_array *array = value->data.a;
-  MONGORY_VALIDATE_PTR(pool, array);
-  MONGORY_VALIDATE_PTR(pool, array->each);
-  MONGORY_VALIDATE_PTR(pool, &array->count);
-  if (pool->error != NULL) {
+  mongory_sink sink;
+  mongory_sink_string_buffer_init(&sink, buffer);
+  if (!mongory_value_ops(value->type)->serialize(value, &sink))
     return NULL;
-  }
-  mongory_string_buffer_append(buffer, "[");
-  mongory_value_container_to_str_ctx ctx = {.count = 0, .total = array->count, .buffer = buffer};
-  array->each(array, &ctx, mongory_value_array_to_str_each);
-  mongory_string_buffer_append(buffer, "]");
   return mongory_string_buffer_cstr(buffer);
 }
 
-static bool mongory_value_table_to_str_each(char *key, mongory_value *value, void *ctx) {
-  mongory_value_container_to_str_ctx *context = (mongory_value_container_to_str_ctx *)ctx;
-  mongory_string_buffer *buffer = context->buffer;
-  mongory_memory_pool *pool = buffer->pool;
-  MONGORY_VALIDATE_PTR(pool, key);
-  MONGORY_VALIDATE_PTR(pool, value);
-  MONGORY_VALIDATE_PTR(pool, value->to_str);
-  if (pool->error != NULL) {
-    return false;
-  }
-  mongory_string_buffer_appendf(buffer, "\"%s\":", key);
-  char *str = value->to_str(value, buffer->pool);
-  if (!str)
+static bool mongory_value_null_serialize(mongory_value *value, mongory_sink *sink) {
+  (void)value;
+  return mongory_sink_write(sink, "null", 4);
+}
+
+static bool mongory_value_bool_serialize(mongory_value *value, mongory_sink *sink) {
+  return value->data.b ? mongory_sink_write(sink, "true", 4) : mongory_sink_write(sink, "false", 5);
+}
+
+static bool mongory_value_int_serialize(mongory_value *value, mongory_sink *sink) {
+  return mongory_sink_write_int(sink, value->data.i);
+}
+
+static bool mongory_value_double_serialize(mongory_value *value, mongory_sink *sink) {
+  return mongory_sink_write_double(sink, value->data.d);
+}
+
+static bool mongory_value_string_serialize(mongory_value *value, mongory_sink *sink) {
+  if (value->data.s == NULL)
+    return mongory_value_serialize_fail(sink);
+  return mongory_sink_write_string(sink, value->data.s, value->len);
+}
+
+typedef struct mongory_value_container_serialize_ctx {
+  mongory_sink *sink; /**< The sink to write to. */
+  bool first;         /**< No item has been written yet. */
+} mongory_value_container_serialize_ctx;
+
+static bool mongory_value_array_serialize_each(mongory_value *value, void *acc) {
+  mongory_value_container_serialize_ctx *ctx = (mongory_value_container_serialize_ctx *)acc;
+  if (!ctx->first)
+    mongory_sink_write(ctx->sink, ",", 1);
+  ctx->first = false;
+  return mongory_value_serialize(value, ctx->sink);
+}
+
+static bool mongory_value_array_serialize(mongory_value *value, mongory_sink *sink) {
+  mongory_array *array = value->data.a;
+  if (array == NULL)
+    return mongory_value_serialize_fail(sink);
+  mongory_value_container_serialize_ctx ctx = {.sink = sink, .first = true};
+  mongory_sink_write(sink, "[", 1);
+  if (!array->each(array, &ctx, mongory_value_array_serialize_each))
     return false;
-  mongory_string_buffer_append(buffer, str);
-  context->count++;
-  if (context->count < context->total) {
-    mongory_string_buffer_append(buffer, ",");
-  }
-  return true;
+  return mongory_sink_write(sink, "]", 1);
 }
 
-static char *mongory_value_table_to_str(mongory_value *value, mongory_memory_pool *pool) {
-  mongory_string_buffer *buffer = mongory_string_buffer_new(pool);
-  if (!buffer)
-    return NULL;
+static bool mongory_value_table_serialize_each(char *key, mongory_value *value, void *acc) {
+  mongory_value_container_serialize_ctx *ctx = (mongory_value_container_serialize_ctx *)acc;
+  if (!ctx->first)
+    mongory_sink_write(ctx->sink, ",", 1);
+  ctx->first = false;
+  if (key == NULL)
+    return mongory_value_serialize_fail(ctx->sink);
+  mongory_sink_write_string(ctx->sink, key, strlen(key));
+  mongory_sink_write(ctx->sink, ":", 1);
+  return mongory_value_serialize(value, ctx->sink);
+}
+
+static bool mongory_value_table_serialize(mongory_value *value, mongory_sink *sink) {
   mongory_table *table = value->data.t;
-  if (!MONGORY_VALIDATE_PTR(pool, table) || !MONGORY_VALIDATE_PTR(pool, table->each) ||
-      !MONGORY_VALIDATE_PTR(pool, &table->count)) {
-    return NULL;
-  }
-  if (pool->error != NULL) {
-    return NULL;
-  }
-  mongory_string_buffer_append(buffer, "{");
-  mongory_value_container_to_str_ctx ctx = {.count = 0, .total = table->count, .buffer = buffer};
-  table->each(table, &ctx, mongory_value_table_to_str_each);
-  mongory_string_buffer_append(buffer, "}");
-  return mongory_string_buffer_cstr(buffer);
+  if (table == NULL)
+    return mongory_value_serialize_fail(sink);
+  mongory_value_container_serialize_ctx ctx = {.sink = sink, .first = true};
+  mongory_sink_write(sink, "{", 1);
+  if (!table->each(table, &ctx, mongory_value_table_serialize_each))
+    return false;
+  return mongory_sink_write(sink, "}", 1);
 }
 
-static char *mongory_value_generic_ptr_to_str(mongory_value *value, mongory_memory_pool *pool) {
-  if (!MONGORY_VALIDATE_PTR(pool, value->data.ptr))
-    return NULL;
-  return mongory_string_cpyf(pool, "%p", value->data.ptr);
+static char *mongory_value_regex_to_str(mongory_value *value, mongory_memory_pool *pool) {
+  return mongory_internal_regex_adapter.stringify_func(pool, value);
+}
+
+static bool mongory_value_regex_serialize(mongory_value *value, mongory_sink *sink) {
+  return mongory_value_serialize_with(value, sink, mongory_value_regex_to_str);
+}
+
+static bool mongory_value_generic_ptr_serialize(mongory_value *value, mongory_sink *sink) {
+  if (value->data.ptr == NULL)
+    return mongory_value_serialize_fail(sink);
+  char address[32];
+  int len = snprintf(address, sizeof(address), "%p", value->data.ptr);
+  return mongory_sink_write(sink, address, (size_t)len);
+}
+
+/**
+ * @brief Splits days since the Unix epoch into a proleptic Gregorian date.
+ */
+static void mongory_value_civil_from_days(int64_t days, int64_t *year, unsigned *month, unsigned *day) {
+  days += 719468; // Days from 0000-03-01 to 1970-01-01.
+  int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+  unsigned day_of_era = (unsigned)(days - era * 146097);
+  unsigned year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+  unsigned day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+  unsigned shifted_month = (5 * day_of_year + 2) / 153; // March is 0.
+  *day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+  *month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+  *year = (int64_t)year_of_era + era * 400 + (*month <= 2);
+}
+
+/** Writes a datetime as a quoted ISO 8601 UTC string. */
+static bool mongory_value_datetime_serialize(mongory_value *value, mongory_sink *sink) {
+  int64_t seconds = value->data.i / 1000000000;
+  int64_t nanos = value->data.i % 1000000000;
+  if (nanos < 0) {
+    nanos += 1000000000;
+    seconds--;
+  }
+  int64_t days = seconds / 86400;
+  int64_t second_of_day = seconds % 86400;
+  if (second_of_day < 0) {
+    second_of_day += 86400;
+    days--;
+  }
+  int64_t year;
+  unsigned month, day;
+  mongory_value_civil_from_days(days, &year, &month, &day);
+  char buffer[48];
+  int len = snprintf(buffer, sizeof(buffer), "\"%04lld-%02u-%02uT%02u:%02u:%02u", (long long)year, month, day,
+                     (unsigned)(second_of_day / 3600), (unsigned)(second_of_day / 60 % 60),
+                     (unsigned)(second_of_day % 60));
+  if (nanos != 0)
+    len += snprintf(buffer + len, sizeof(buffer) - (size_t)len, ".%09u", (unsigned)nanos);
+  memcpy(buffer + len, "Z\"", 2);
+  return mongory_sink_write(sink, buffer, (size_t)len + 2);
+}
+
+/** Writes a binary as a quoted lowercase hex string. */
+static bool mongory_value_binary_serialize(mongory_value *value, mongory_sink *sink) {
+  static const char hex[] = "0123456789abcdef";
+  if (value->data.bin == NULL)
+    return mongory_value_serialize_fail(sink);
+  char chunk[64];
+  size_t size = 0;
+  mongory_sink_write(sink, "\"", 1);
+  for (size_t i = 0; i < value->len; i++) {
+    chunk[size++] = hex[value->data.bin[i] >> 4];
+    chunk[size++] = hex[value->data.bin[i] & 0xF];
+    if (size == sizeof(chunk)) {
+      mongory_sink_write(sink, chunk, size);
+      size = 0;
+    }
+  }
+  mongory_sink_write(sink, chunk, size);
+  return mongory_sink_write(sink, "\"", 1);
 }
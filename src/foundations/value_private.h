@@ -0,0 +1,39 @@
+#ifndef MONGORY_VALUE_PRIVATE_H
+#define MONGORY_VALUE_PRIVATE_H
+
+/**
+ * @file value_private.h
+ * @brief Helpers for building values in place. This is an internal header
+ * for the library.
+ */
+
+#include "mongory-core/foundations/value.h"
+#include <stdbool.h>
+
+/**
+ * @brief Initializes a value in place with the built-in behaviour of its
+ * type. The value belongs to no pool and its payload is left untouched.
+ * @param value The value, typically on the stack.
+ * @param type The type.
+ */
+void mongory_value_init(mongory_value *value, mongory_type type);
+
+/**
+ * @brief Tells whether a value has only the built-in behaviour of its type,
+ * so that rebuilding it from its type and payload loses nothing. Always true
+ * for compact values; otherwise false when `comp` or `to_str` is overridden
+ * or an `origin` is set.
+ * @param value The value.
+ * @return True if the value can be rebuilt from its type and payload.
+ */
+bool mongory_value_is_plain(mongory_value *value);
+
+/**
+ * @brief Tells whether a value compares with the built-in `comp` of its type.
+ * Always true for compact values.
+ * @param value The value.
+ * @return False if `comp` is overridden.
+ */
+bool mongory_value_has_builtin_comp(mongory_value *value);
+
+#endif /* MONGORY_VALUE_PRIVATE_H */
@@ -0,0 +1,251 @@
+/**
+ * @file value_set.c
+ * @brief Implements the type-partitioned value set used by the inclusion
+ * matchers.
+ *
+ * Values are hashed with `mongory_value_hash`, which gives values that
+ * compare equal the same hash; the stored value is still compared on a hash
+ * hit, which keeps int/int comparisons exact. NaN compares equal to every
+ * number, so it is tracked with a flag instead of being hashed. For the same
+ * reason an array or table holding a NaN at any depth cannot be hashed: such
+ * containers are kept in the linear list, and looking one up scans every
+ * stored container.
+ */
+#include "value_set.h"
+#include "array_private.h"
+#include "mongory-core/foundations/error.h"
+#include "mongory-core/foundations/table.h"
+#include <math.h>
+#include <string.h>
+
+/**
+ * @brief Smallest table capacity.
+ */
+#define MONGORY_VALUE_SET_MIN_CAPACITY 8
+
+static inline double mongory_value_set_number(mongory_value *value) {
+  return value->type == MONGORY_TYPE_INT ? (double)value->data.i : value->data.d;
+}
+
+static bool mongory_value_set_contains_nan(mongory_value *value);
+
+static bool mongory_value_set_table_nan_each(char *key, mongory_value *value, void *acc) {
+  (void)key;
+  if (value != NULL && mongory_value_set_contains_nan(value)) {
+    *(bool *)acc = true;
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @brief Tells whether a value is a NaN or a container holding one at any
+ * depth. Such values compare equal to values with a different hash.
+ */
+static bool mongory_value_set_contains_nan(mongory_value *value) {
+  switch (value->type) {
+  case MONGORY_TYPE_INT:
+  case MONGORY_TYPE_DOUBLE:
+    return isnan(mongory_value_set_number(value));
+  case MONGORY_TYPE_ARRAY: {
+    mongory_array *array = value->data.a;
+    if (array == NULL)
+      return false;
+    mongory_value scratch;
+    for (size_t i = 0; i < array->count; i++) {
+      mongory_value *item = mongory_array_peek(array, i, &scratch);
+      if (item != NULL && mongory_value_set_contains_nan(item))
+        return true;
+    }
+    return false;
+  }
+  case MONGORY_TYPE_TABLE: {
+    mongory_table *table = value->data.t;
+    bool found = false;
+    if (table != NULL)
+      table->each(table, &found, mongory_value_set_table_nan_each);
+    return found;
+  }
+  default:
+    return false;
+  }
+}
+
+static bool mongory_value_set_table_init(mongory_memory_pool *pool, mongory_value_set_table *table, size_t capacity) {
+  table->slots = MG_ALLOC_ARY(pool, mongory_value_set_slot, capacity);
+  if (table->slots == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return false;
+  }
+  memset(table->slots, 0, sizeof(mongory_value_set_slot) * capacity);
+  table->capacity = capacity;
+  table->count = 0;
+  return true;
+}
+
+static mongory_value_set_slot *mongory_value_set_table_find(mongory_value_set_table *table, uint64_t hash,
+                                                            mongory_value *value) {
+  size_t mask = table->capacity - 1;
+  for (size_t i = (size_t)hash & mask;; i = (i + 1) & mask) {
+    mongory_value_set_slot *slot = &table->slots[i];
+    if (slot->value == NULL)
+      return slot;
+    if (slot->hash == hash && mongory_value_equal(slot->value, value))
+      return slot;
+  }
+}
+
+static bool mongory_value_set_table_insert(mongory_memory_pool *pool, mongory_value_set_table *table, uint64_t hash,
+                                           mongory_value *value) {
+  if ((table->count + 1) * 2 > table->capacity) {
+    mongory_value_set_table grown;
+    if (!mongory_value_set_table_init(pool, &grown, table->capacity * 2))
+      return false;
+    for (size_t i = 0; i < table->capacity; i++) {
+      mongory_value_set_slot *slot = &table->slots[i];
+      if (slot->value == NULL)
+        continue;
+      *mongory_value_set_table_find(&grown, slot->hash, slot->value) = *slot;
+      grown.count++;
+    }
+    *table = grown;
+  }
+  mongory_value_set_slot *slot = mongory_value_set_table_find(table, hash, value);
+  if (slot->value == NULL) {
+    slot->hash = hash;
+    slot->value = value;
+    table->count++;
+  }
+  return true;
+}
+
+static bool mongory_value_set_table_includes(mongory_value_set_table *table, uint64_t hash, mongory_value *value) {
+  if (table->count == 0)
+    return false;
+  return mongory_value_set_table_find(table, hash, value)->value != NULL;
+}
+
+static bool mongory_value_set_table_scan(mongory_value_set_table *table, mongory_value *value) {
+  for (size_t i = 0; i < table->capacity && table->count > 0; i++) {
+    mongory_value *stored = table->slots[i].value;
+    if (stored != NULL && mongory_value_equal(stored, value))
+      return true;
+  }
+  return false;
+}
+
+mongory_value_set *mongory_value_set_new(mongory_memory_pool *pool) {
+  mongory_value_set *set = MG_ALLOC_PTR(pool, mongory_value_set);
+  if (set == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  set->pool = pool;
+  set->others = mongory_array_new(pool);
+  set->has_null = false;
+  set->has_true = false;
+  set->has_false = false;
+  set->has_nan = false;
+  if (set->others == NULL || !mongory_value_set_table_init(pool, &set->numbers, MONGORY_VALUE_SET_MIN_CAPACITY) ||
+      !mongory_value_set_table_init(pool, &set->strings, MONGORY_VALUE_SET_MIN_CAPACITY) ||
+      !mongory_value_set_table_init(pool, &set->containers, MONGORY_VALUE_SET_MIN_CAPACITY) ||
+      !mongory_value_set_table_init(pool, &set->scalars, MONGORY_VALUE_SET_MIN_CAPACITY)) {
+    return NULL;
+  }
+  return set;
+}
+
+bool mongory_value_set_add(mongory_value_set *set, mongory_value *value) {
+  if (value == NULL)
+    return true;
+  switch (value->type) {
+  case MONGORY_TYPE_NULL:
+    set->has_null = true;
+    return true;
+  case MONGORY_TYPE_BOOL:
+    if (value->data.b)
+      set->has_true = true;
+    else
+      set->has_false = true;
+    return true;
+  case MONGORY_TYPE_INT:
+  case MONGORY_TYPE_DOUBLE: {
+    double number = mongory_value_set_number(value);
+    if (isnan(number)) {
+      set->has_nan = true;
+      return true;
+    }
+    return mongory_value_set_table_insert(set->pool, &set->numbers, mongory_value_hash(value), value);
+  }
+  case MONGORY_TYPE_STRING:
+    if (value->data.s == NULL)
+      return true; // A NULL string never compares equal to anything.
+    return mongory_value_set_table_insert(set->pool, &set->strings, mongory_value_hash(value), value);
+  case MONGORY_TYPE_ARRAY:
+  case MONGORY_TYPE_TABLE:
+    if (value->data.ptr == NULL)
+      return true; // A NULL container never compares equal to anything.
+    if (mongory_value_set_contains_nan(value))
+      return set->others->push(set->others, value);
+    return mongory_value_set_table_insert(set->pool, &set->containers, mongory_value_hash(value), value);
+  case MONGORY_TYPE_BINARY:
+    if (value->data.bin == NULL)
+      return true; // A NULL binary never compares equal to anything.
+    return mongory_value_set_table_insert(set->pool, &set->scalars, mongory_value_hash(value), value);
+  case MONGORY_TYPE_DATETIME:
+    return mongory_value_set_table_insert(set->pool, &set->scalars, mongory_value_hash(value), value);
+  default:
+    return set->others->push(set->others, value);
+  }
+}
+
+static bool mongory_value_set_hashed_includes(mongory_value_set *set, mongory_value *value) {
+  switch (value->type) {
+  case MONGORY_TYPE_NULL:
+    return set->has_null;
+  case MONGORY_TYPE_BOOL:
+    return value->data.b ? set->has_true : set->has_false;
+  case MONGORY_TYPE_INT:
+  case MONGORY_TYPE_DOUBLE: {
+    if (set->has_nan)
+      return true;
+    double number = mongory_value_set_number(value);
+    if (isnan(number))
+      return set->numbers.count > 0;
+    return mongory_value_set_table_includes(&set->numbers, mongory_value_hash(value), value);
+  }
+  case MONGORY_TYPE_STRING:
+    if (value->data.s == NULL)
+      return false;
+    return mongory_value_set_table_includes(&set->strings, mongory_value_hash(value), value);
+  case MONGORY_TYPE_ARRAY:
+  case MONGORY_TYPE_TABLE:
+    if (value->data.ptr == NULL || set->containers.count == 0)
+      return false;
+    if (mongory_value_set_contains_nan(value))
+      return mongory_value_set_table_scan(&set->containers, value);
+    return mongory_value_set_table_includes(&set->containers, mongory_value_hash(value), value);
+  case MONGORY_TYPE_BINARY:
+    if (value->data.bin == NULL)
+      return false;
+    return mongory_value_set_table_includes(&set->scalars, mongory_value_hash(value), value);
+  case MONGORY_TYPE_DATETIME:
+    return mongory_value_set_table_includes(&set->scalars, mongory_value_hash(value), value);
+  default:
+    return false;
+  }
+}
+
+bool mongory_value_set_includes(mongory_value_set *set, mongory_value *value) {
+  if (value == NULL)
+    return false;
+  if (mongory_value_set_hashed_includes(set, value))
+    return true;
+  mongory_array *others = set->others;
+  for (size_t i = 0; i < others->count; i++) {
+    mongory_value *item = others->get(others, i);
+    if (mongory_value_equal(item, value))
+      return true;
+  }
+  return false;
+}
@@ -0,0 +1,84 @@
+#ifndef MONGORY_VALUE_SET_H
+#define MONGORY_VALUE_SET_H
+
+/**
+ * @file value_set.h
+ * @brief A set of `mongory_value` pointers with hashed membership tests. This
+ * is an internal header for the library.
+ *
+ * Membership follows the value comparison semantics: a value is in the set if
+ * it compares equal (`comp() == 0`) to one of the added values. The set is
+ * partitioned by type. Numbers, strings, containers (arrays and tables) and
+ * the other hashable scalars (datetimes and binaries) live in their own
+ * open-addressing tables, null and booleans are plain
+ * flags, and every other type, as well as any container holding a NaN, is
+ * kept in a list that is scanned linearly. Numbers are hashed by their value as a
+ * double, so an int and a double that compare equal share a bucket.
+ */
+
+#include "mongory-core/foundations/array.h"
+#include "mongory-core/foundations/memory_pool.h"
+#include "mongory-core/foundations/value.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief One slot of a value set table. An empty slot has a NULL `value`.
+ */
+typedef struct mongory_value_set_slot {
+  uint64_t hash;         /**< Hash of `value`. */
+  mongory_value *value;  /**< The stored value, or NULL. */
+} mongory_value_set_slot;
+
+/**
+ * @brief An open-addressing table with linear probing.
+ */
+typedef struct mongory_value_set_table {
+  mongory_value_set_slot *slots; /**< Slots, `capacity` of them. */
+  size_t capacity;               /**< Number of slots, a power of two. */
+  size_t count;                  /**< Number of occupied slots. */
+} mongory_value_set_table;
+
+/**
+ * @brief A type-partitioned set of values.
+ */
+typedef struct mongory_value_set {
+  mongory_memory_pool *pool;          /**< Pool owning the tables. */
+  mongory_value_set_table numbers;    /**< Int and double values. */
+  mongory_value_set_table strings;    /**< String values. */
+  mongory_value_set_table containers; /**< Array and table values. */
+  mongory_value_set_table scalars;    /**< Datetime and binary values. */
+  mongory_array *others;              /**< Values of any other type. */
+  bool has_null;                      /**< A null value was added. */
+  bool has_true;                      /**< A true boolean was added. */
+  bool has_false;                     /**< A false boolean was added. */
+  bool has_nan;                       /**< A NaN double was added. */
+} mongory_value_set;
+
+/**
+ * @brief Creates an empty set.
+ * @param pool The pool used for the set and its tables.
+ * @return The new set, or NULL on allocation failure.
+ */
+mongory_value_set *mongory_value_set_new(mongory_memory_pool *pool);
+
+/**
+ * @brief Adds a value to the set. Adding a value that compares equal to one
+ * already in the set is a no-op.
+ * @param set The set.
+ * @param value The value to add. NULL is ignored.
+ * @return False on allocation failure, true otherwise.
+ */
+bool mongory_value_set_add(mongory_value_set *set, mongory_value *value);
+
+/**
+ * @brief Tells whether a value compares equal to a value of the set. Never
+ * allocates.
+ * @param set The set.
+ * @param value The value to look up.
+ * @return True if the value is in the set.
+ */
+bool mongory_value_set_includes(mongory_value_set *set, mongory_value *value);
+
+#endif /* MONGORY_VALUE_SET_H */
@@ -51,11 +51,40 @@ mongory_matcher *mongory_matcher_base_new(mongory_memory_pool *pool, mongory_val
   matcher->match = NULL;                           // Specific match function must be set by derived type.
   matcher->explain = mongory_matcher_base_explain; // Specific explain function must be set by derived type.
   matcher->traverse = mongory_matcher_leaf_traverse;
+  matcher->compile = mongory_matcher_leaf_compile;
+  matcher->match_batch = mongory_matcher_leaf_match_batch;
+  matcher->frozen = false;
   matcher->extern_ctx = extern_ctx;                // Set the external context.
   matcher->priority = 1.0;                         // Set the priority to 1.0.
   return matcher;
 }
 
+size_t mongory_matcher_leaf_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection, size_t count,
+                                        mongory_memory_pool *temp_pool) {
+  (void)temp_pool;
+  size_t matched = 0;
+  for (size_t i = 0; i < count; i++) {
+    size_t row = selection[i];
+    if (matcher->match(matcher, values[row])) {
+      selection[matched++] = row;
+    }
+  }
+  return matched;
+}
+
+size_t mongory_matcher_selection_subtract(size_t *selection, size_t count, size_t *subset, size_t subset_count) {
+  size_t kept = 0;
+  size_t j = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (j < subset_count && subset[j] == selection[i]) {
+      j++;
+      continue;
+    }
+    selection[kept++] = selection[i];
+  }
+  return kept;
+}
+
 /**
  * @brief The match function for a matcher that always returns true.
  * @param matcher Unused.
@@ -84,6 +113,7 @@ mongory_matcher *mongory_matcher_always_true_new(mongory_memory_pool *pool, mong
   matcher->original_match = mongory_matcher_always_true_match;
   matcher->name = mongory_string_cpy(pool, "Always True");
   matcher->explain = mongory_matcher_base_explain;
+  matcher->compile = mongory_matcher_always_true_compile;
   // Optionally set original_match as well if it's a strict policy
   // matcher->context.original_match = mongory_matcher_always_true_match;
   return matcher;
@@ -117,6 +147,7 @@ mongory_matcher *mongory_matcher_always_false_new(mongory_memory_pool *pool, mon
   matcher->original_match = mongory_matcher_always_false_match;
   matcher->name = mongory_string_cpy(pool, "Always False");
   matcher->explain = mongory_matcher_base_explain;
+  matcher->compile = mongory_matcher_always_false_compile;
   // matcher->context.original_match = mongory_matcher_always_false_match;
   return matcher;
 }
@@ -15,6 +15,8 @@
 #include "mongory-core/foundations/memory_pool.h"
 #include "mongory-core/foundations/value.h"
 #include "mongory-core/matchers/matcher.h" // For mongory_matcher structure
+#include "../foundations/utils.h"          // For MONGORY_THREAD_LOCAL
+#include "matcher_compilable.h"
 #include "matcher_explainable.h"
 #include "matcher_traversable.h"
 #include <stdbool.h>
@@ -29,6 +31,22 @@
  */
 typedef bool (*mongory_matcher_match_func)(mongory_matcher *matcher, mongory_value *value);
 
+/**
+ * @brief Function pointer type for a matcher's batch matching logic.
+ *
+ * Evaluates the rows listed in `selection` and compacts `selection` in place
+ * so that it only keeps the matching rows, in their original order.
+ *
+ * @param matcher A pointer to the `mongory_matcher` instance itself.
+ * @param values The batch of values, indexed by row.
+ * @param selection Ascending row indexes into `values` to evaluate.
+ * @param count The number of entries in `selection`.
+ * @param temp_pool Pool for scratch allocations during this batch.
+ * @return size_t The number of matching rows left at the front of `selection`.
+ */
+typedef size_t (*mongory_matcher_match_batch_func)(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                   size_t count, mongory_memory_pool *temp_pool);
+
 /**
  * @struct mongory_matcher
  * @brief Represents a generic matcher in the Mongory system.
@@ -52,8 +70,9 @@ struct mongory_matcher {
                                                 restoration or delegation. */
   size_t sub_count;                          /**< The number of sub-matchers. */
   mongory_matcher_traverse_func traverse;    /**< Function pointer to the traversal logic for this matcher type. */
-  mongory_array *trace_stack;                /**< The trace stack for this matcher. */
-  int trace_level;                           /**< The trace level for this matcher. */
+  mongory_matcher_compile_func compile;      /**< Function pointer lowering this matcher into program instructions. */
+  mongory_matcher_match_batch_func match_batch; /**< Function pointer to the batch matching logic. */
+  bool frozen;                               /**< Set by `mongory_matcher_freeze`; the matcher is read-only. */
   double priority;                           /**< The priority for this matcher. */
   void *extern_ctx;                          /**< External context for the matcher. */
 };
@@ -75,6 +94,77 @@ struct mongory_matcher {
  */
 mongory_matcher *mongory_matcher_base_new(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx);
 
+/**
+ * @brief Batch match function evaluating each selected row with `match`.
+ *
+ * This is the default `match_batch` for matchers without a dedicated batch
+ * implementation.
+ */
+size_t mongory_matcher_leaf_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection, size_t count,
+                                        mongory_memory_pool *temp_pool);
+
+/**
+ * @brief Removes the rows of `subset` from `selection`.
+ *
+ * Both arrays must be ascending and `subset` must be a subsequence of
+ * `selection`.
+ *
+ * @return size_t The number of rows left in `selection`.
+ */
+size_t mongory_matcher_selection_subtract(size_t *selection, size_t count, size_t *subset, size_t subset_count);
+
+/**
+ * @struct mongory_matcher_trace_overlay
+ * @brief Trace recording state of the current thread.
+ *
+ * Tracing never modifies the matcher tree. While an overlay is installed,
+ * `mongory_matcher_dispatch` records every matcher call made on this thread
+ * into the overlay's trace stack.
+ */
+typedef struct mongory_matcher_trace_overlay {
+  mongory_matcher *root;       /**< The matcher the trace was enabled on. */
+  mongory_array *trace_stack;  /**< Recorded trace entries. */
+  int level;                   /**< Nesting level of the next recorded call. */
+} mongory_matcher_trace_overlay;
+
+/**
+ * @brief The trace overlay installed on the current thread, or NULL.
+ */
+extern MONGORY_THREAD_LOCAL mongory_matcher_trace_overlay *mongory_matcher_trace_current;
+
+/**
+ * @brief The scratch pool of the match call running on the current thread,
+ * or NULL outside of `mongory_matcher_match` and the parallel filter.
+ *
+ * Values that only live for the duration of a match, like shallowly converted
+ * fields, are allocated from it. The pool is rewound when the outermost match
+ * call returns.
+ */
+extern MONGORY_THREAD_LOCAL mongory_memory_pool *mongory_matcher_scratch_current;
+
+/**
+ * @brief Runs `matcher` through its `match` function and records the call in
+ * the current trace overlay.
+ */
+bool mongory_matcher_traced_match(mongory_matcher *matcher, mongory_value *value);
+
+/**
+ * @brief Invokes a (sub-)matcher.
+ *
+ * Matchers call their sub-matchers through this function rather than through
+ * `match` directly, so that tracing can observe the calls without patching
+ * the tree.
+ *
+ * @param matcher The matcher to run.
+ * @param value The value to match.
+ * @return The result of the matcher.
+ */
+static inline bool mongory_matcher_dispatch(mongory_matcher *matcher, mongory_value *value) {
+  if (mongory_matcher_trace_current != NULL)
+    return mongory_matcher_traced_match(matcher, value);
+  return matcher->match(matcher, value);
+}
+
 /**
  * @brief Creates a new matcher that always evaluates to true.
  *
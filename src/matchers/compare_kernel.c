@@ -0,0 +1,174 @@
+/**
+ * @file compare_kernel.c
+ * @brief Implements the columnar comparison kernels. This is an internal
+ * implementation file for the matcher module.
+ *
+ * Every implementation computes two bitmasks per 64 rows, `row > operand` and
+ * `row < operand`, and derives the requested comparison from them. Deriving
+ * equality as "neither greater nor less" is what keeps NaN handling identical
+ * to `mongory_value` comparison.
+ *
+ * On x86-64 with GCC or Clang the AVX2 and SSE4.2 variants are compiled with
+ * per-function target attributes and selected with `__builtin_cpu_supports`,
+ * so the library itself still builds for the baseline instruction set.
+ */
+#include "compare_kernel.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MONGORY_COMPARE_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief Derives the requested comparison from the greater/less bitmasks of
+ * up to 64 rows.
+ */
+static inline uint64_t mongory_compare_kernel_combine(mongory_compare_kernel_op op, uint64_t gt, uint64_t lt,
+                                                      uint64_t lanes) {
+  switch (op) {
+  case MONGORY_COMPARE_KERNEL_EQ:
+    return ~(gt | lt) & lanes;
+  case MONGORY_COMPARE_KERNEL_NE:
+    return gt | lt;
+  case MONGORY_COMPARE_KERNEL_GT:
+    return gt;
+  case MONGORY_COMPARE_KERNEL_GTE:
+    return ~lt & lanes;
+  case MONGORY_COMPARE_KERNEL_LT:
+    return lt;
+  default:
+    return ~gt & lanes;
+  }
+}
+
+/**
+ * @brief Scalar loop over the rows [start, count). `start` must be a multiple
+ * of 64 so that every written mask word is owned by this loop.
+ */
+#define MONGORY_COMPARE_KERNEL_SCALAR(op, column, start, count, operand, mask)                                         \
+  do {                                                                                                                 \
+    for (size_t word_start = (start); word_start < (count); word_start += 64) {                                        \
+      size_t rows = (count) - word_start < 64 ? (count) - word_start : 64;                                           \
+      uint64_t gt = 0;                                                                                                 \
+      uint64_t lt = 0;                                                                                                 \
+      for (size_t j = 0; j < rows; j++) {                                                                              \
+        gt |= (uint64_t)(column[word_start + j] > (operand)) << j;                                                     \
+        lt |= (uint64_t)(column[word_start + j] < (operand)) << j;                                                     \
+      }                                                                                                                \
+      uint64_t lanes = rows == 64 ? ~(uint64_t)0 : (((uint64_t)1 << rows) - 1);                                        \
+      mask[word_start >> 6] = mongory_compare_kernel_combine(op, gt, lt, lanes);                                       \
+    }                                                                                                                  \
+  } while (0)
+
+#ifdef MONGORY_COMPARE_KERNEL_X86
+
+__attribute__((target("avx2"))) static size_t mongory_compare_kernel_i64_avx2(mongory_compare_kernel_op op,
+                                                                               const int64_t *column, size_t count,
+                                                                               int64_t operand, uint64_t *mask) {
+  __m256i b = _mm256_set1_epi64x(operand);
+  size_t i = 0;
+  for (; i + 64 <= count; i += 64) {
+    uint64_t gt = 0;
+    uint64_t lt = 0;
+    for (size_t j = 0; j < 64; j += 4) {
+      __m256i a = _mm256_loadu_si256((const __m256i *)(column + i + j));
+      gt |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b))) << j;
+      lt |= (uint64_t)_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(b, a))) << j;
+    }
+    mask[i >> 6] = mongory_compare_kernel_combine(op, gt, lt, ~(uint64_t)0);
+  }
+  return i;
+}
+
+__attribute__((target("sse4.2"))) static size_t mongory_compare_kernel_i64_sse42(mongory_compare_kernel_op op,
+                                                                                 const int64_t *column, size_t count,
+                                                                                 int64_t operand, uint64_t *mask) {
+  __m128i b = _mm_set1_epi64x(operand);
+  size_t i = 0;
+  for (; i + 64 <= count; i += 64) {
+    uint64_t gt = 0;
+    uint64_t lt = 0;
+    for (size_t j = 0; j < 64; j += 2) {
+      __m128i a = _mm_loadu_si128((const __m128i *)(column + i + j));
+      gt |= (uint64_t)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(a, b))) << j;
+      lt |= (uint64_t)_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(b, a))) << j;
+    }
+    mask[i >> 6] = mongory_compare_kernel_combine(op, gt, lt, ~(uint64_t)0);
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) static size_t mongory_compare_kernel_f64_avx2(mongory_compare_kernel_op op,
+                                                                               const double *column, size_t count,
+                                                                               double operand, uint64_t *mask) {
+  __m256d b = _mm256_set1_pd(operand);
+  size_t i = 0;
+  for (; i + 64 <= count; i += 64) {
+    uint64_t gt = 0;
+    uint64_t lt = 0;
+    for (size_t j = 0; j < 64; j += 4) {
+      __m256d a = _mm256_loadu_pd(column + i + j);
+      gt |= (uint64_t)_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)) << j;
+      lt |= (uint64_t)_mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ)) << j;
+    }
+    mask[i >> 6] = mongory_compare_kernel_combine(op, gt, lt, ~(uint64_t)0);
+  }
+  return i;
+}
+
+static size_t mongory_compare_kernel_f64_sse2(mongory_compare_kernel_op op, const double *column, size_t count,
+                                              double operand, uint64_t *mask) {
+  __m128d b = _mm_set1_pd(operand);
+  size_t i = 0;
+  for (; i + 64 <= count; i += 64) {
+    uint64_t gt = 0;
+    uint64_t lt = 0;
+    for (size_t j = 0; j < 64; j += 2) {
+      __m128d a = _mm_loadu_pd(column + i + j);
+      gt |= (uint64_t)_mm_movemask_pd(_mm_cmpgt_pd(a, b)) << j;
+      lt |= (uint64_t)_mm_movemask_pd(_mm_cmplt_pd(a, b)) << j;
+    }
+    mask[i >> 6] = mongory_compare_kernel_combine(op, gt, lt, ~(uint64_t)0);
+  }
+  return i;
+}
+
+#endif /* MONGORY_COMPARE_KERNEL_X86 */
+
+void mongory_compare_kernel_i64(mongory_compare_kernel_op op, const int64_t *column, size_t count, int64_t operand,
+                                uint64_t *mask) {
+  size_t done = 0;
+#ifdef MONGORY_COMPARE_KERNEL_X86
+  if (__builtin_cpu_supports("avx2")) {
+    done = mongory_compare_kernel_i64_avx2(op, column, count, operand, mask);
+  } else if (__builtin_cpu_supports("sse4.2")) {
+    done = mongory_compare_kernel_i64_sse42(op, column, count, operand, mask);
+  }
+#endif
+  MONGORY_COMPARE_KERNEL_SCALAR(op, column, done, count, operand, mask);
+}
+
+void mongory_compare_kernel_f64(mongory_compare_kernel_op op, const double *column, size_t count, double operand,
+                                uint64_t *mask) {
+  size_t done = 0;
+#ifdef MONGORY_COMPARE_KERNEL_X86
+  if (__builtin_cpu_supports("avx2")) {
+    done = mongory_compare_kernel_f64_avx2(op, column, count, operand, mask);
+  } else {
+    done = mongory_compare_kernel_f64_sse2(op, column, count, operand, mask);
+  }
+#endif
+  MONGORY_COMPARE_KERNEL_SCALAR(op, column, done, count, operand, mask);
+}
+
+const char *mongory_compare_kernel_isa(void) {
+#ifdef MONGORY_COMPARE_KERNEL_X86
+  if (__builtin_cpu_supports("avx2"))
+    return "avx2";
+  if (__builtin_cpu_supports("sse4.2"))
+    return "sse4.2";
+  return "sse2";
+#else
+  return "scalar";
+#endif
+}
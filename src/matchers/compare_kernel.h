@@ -0,0 +1,68 @@
+#ifndef MONGORY_COMPARE_KERNEL_H
+#define MONGORY_COMPARE_KERNEL_H
+
+/**
+ * @file compare_kernel.h
+ * @brief Columnar comparison kernels used by the batch path of comparison
+ * matchers. This is an internal header for the matcher module.
+ *
+ * A kernel compares a contiguous column of int64 or double values against a
+ * single operand and writes the result as a bitmask (bit `i % 64` of word
+ * `i / 64` is set when row `i` matches). The implementation is chosen at run
+ * time from AVX2, SSE and a portable scalar loop.
+ *
+ * The results follow `mongory_value` comparison exactly: a row compares as
+ * `(a > b) - (a < b)`, so NaN compares equal to every operand.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief The comparison performed by a kernel.
+ */
+typedef enum mongory_compare_kernel_op {
+  MONGORY_COMPARE_KERNEL_EQ,  /**< row == operand */
+  MONGORY_COMPARE_KERNEL_NE,  /**< row != operand */
+  MONGORY_COMPARE_KERNEL_GT,  /**< row > operand */
+  MONGORY_COMPARE_KERNEL_GTE, /**< row >= operand */
+  MONGORY_COMPARE_KERNEL_LT,  /**< row < operand */
+  MONGORY_COMPARE_KERNEL_LTE, /**< row <= operand */
+} mongory_compare_kernel_op;
+
+/**
+ * @brief Number of 64-bit mask words needed for `count` rows.
+ */
+#define MONGORY_COMPARE_KERNEL_MASK_WORDS(count) (((count) + 63) / 64)
+
+/**
+ * @brief Compares an int64 column against an int64 operand.
+ * @param op The comparison to perform.
+ * @param column The column of `count` values.
+ * @param count The number of rows.
+ * @param operand The value every row is compared with.
+ * @param mask Output bitmask of `MONGORY_COMPARE_KERNEL_MASK_WORDS(count)`
+ * words. It is fully overwritten.
+ */
+void mongory_compare_kernel_i64(mongory_compare_kernel_op op, const int64_t *column, size_t count, int64_t operand,
+                                uint64_t *mask);
+
+/**
+ * @brief Compares a double column against a double operand.
+ * @param op The comparison to perform.
+ * @param column The column of `count` values.
+ * @param count The number of rows.
+ * @param operand The value every row is compared with.
+ * @param mask Output bitmask of `MONGORY_COMPARE_KERNEL_MASK_WORDS(count)`
+ * words. It is fully overwritten.
+ */
+void mongory_compare_kernel_f64(mongory_compare_kernel_op op, const double *column, size_t count, double operand,
+                                uint64_t *mask);
+
+/**
+ * @brief Returns the name of the instruction set the kernels run on
+ * ("avx2", "sse4.2", "sse2" or "scalar"), for diagnostics and benchmarks.
+ */
+const char *mongory_compare_kernel_isa(void);
+
+#endif /* MONGORY_COMPARE_KERNEL_H */
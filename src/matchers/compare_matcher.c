@@ -10,33 +10,133 @@
  */
 #include "compare_matcher.h"
 #include "base_matcher.h" // For mongory_matcher_base_new
+#include "compare_kernel.h"
 #include <mongory-core.h> // For mongory_value, mongory_matcher types
 #include "../foundations/utils.h"
+#include "../foundations/value_private.h"
 
 /**
  * @brief Generic constructor for comparison matchers.
  *
  * Initializes a base matcher and sets its `match` function and
- * `original_match` context field to the provided `match_func`.
+ * `original_match` context field to the provided `match_func`, its
+ * `compile` function to the provided `compile_func` and its `match_batch`
+ * function to the provided `match_batch_func`.
  *
  * @param pool The memory pool for allocation.
  * @param condition The `mongory_value` to be stored as the comparison target.
  * @param match_func The specific comparison logic function (e.g., for equality,
  * greater than).
+ * @param compile_func The program lowering of the same comparison.
+ * @param match_batch_func The columnar batch form of the same comparison.
  * @return mongory_matcher* A pointer to the newly created comparison matcher,
  * or NULL on failure.
  */
 static inline mongory_matcher *mongory_matcher_compare_new(mongory_memory_pool *pool, mongory_value *condition,
-                                                           mongory_matcher_match_func match_func, void *extern_ctx) {
+                                                           mongory_matcher_match_func match_func,
+                                                           mongory_matcher_compile_func compile_func,
+                                                           mongory_matcher_match_batch_func match_batch_func,
+                                                           void *extern_ctx) {
   mongory_matcher *matcher = mongory_matcher_base_new(pool, condition, extern_ctx);
   if (matcher == NULL) {
     return NULL; // Base matcher allocation failed.
   }
   matcher->match = match_func;
   matcher->original_match = match_func; // Store original match function
+  matcher->compile = compile_func;
+  matcher->match_batch = match_batch_func;
   return matcher;
 }
 
+/**
+ * @brief Shared batch logic of the comparison matchers.
+ *
+ * When every selected value is numeric and the comparison is unambiguous for
+ * the whole column (all ints against an int condition, or any numbers against
+ * a double condition), or every value is a datetime against a datetime
+ * condition, the values are gathered into a contiguous column and
+ * compared by a vectorized kernel. Any other batch goes through `match` row by
+ * row, which also keeps the failure semantics of each operator. So does a
+ * batch holding a value with an overridden `comp`: the kernel only sees raw
+ * payloads and could not honour it.
+ *
+ * @param matcher The comparison matcher.
+ * @param values The batch of values.
+ * @param selection Rows to evaluate; compacted to the matching rows.
+ * @param count Number of rows in `selection`.
+ * @param temp_pool Pool for the column and the result mask.
+ * @param op The kernel comparison equivalent to the matcher's operator.
+ * @return Number of matching rows.
+ */
+static size_t mongory_matcher_compare_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                  size_t count, mongory_memory_pool *temp_pool,
+                                                  mongory_compare_kernel_op op) {
+  mongory_value *condition = matcher->condition;
+  if (count == 0 || !condition ||
+      (condition->type != MONGORY_TYPE_INT && condition->type != MONGORY_TYPE_DOUBLE &&
+       condition->type != MONGORY_TYPE_DATETIME)) {
+    return mongory_matcher_leaf_match_batch(matcher, values, selection, count, temp_pool);
+  }
+  bool all_int = true;
+  for (size_t i = 0; i < count; i++) {
+    mongory_value *value = values[selection[i]];
+    if (!value || !mongory_value_has_builtin_comp(value)) {
+      return mongory_matcher_leaf_match_batch(matcher, values, selection, count, temp_pool);
+    }
+    if (condition->type == MONGORY_TYPE_DATETIME) {
+      if (value->type != MONGORY_TYPE_DATETIME)
+        return mongory_matcher_leaf_match_batch(matcher, values, selection, count, temp_pool);
+      continue;
+    }
+    if (value->type != MONGORY_TYPE_INT && value->type != MONGORY_TYPE_DOUBLE) {
+      return mongory_matcher_leaf_match_batch(matcher, values, selection, count, temp_pool);
+    }
+    all_int = all_int && value->type == MONGORY_TYPE_INT;
+  }
+  if (condition->type == MONGORY_TYPE_INT && !all_int) {
+    // Ints compare exactly with an int condition while doubles compare through
+    // a cast; one column type cannot express both.
+    return mongory_matcher_leaf_match_batch(matcher, values, selection, count, temp_pool);
+  }
+
+  uint64_t *mask = MG_ALLOC_ARY(temp_pool, uint64_t, MONGORY_COMPARE_KERNEL_MASK_WORDS(count));
+  if (mask == NULL) {
+    temp_pool->error = &MONGORY_ALLOC_ERROR;
+    return 0;
+  }
+  if (condition->type != MONGORY_TYPE_DOUBLE) {
+    // Ints and datetimes are both int64 columns.
+    int64_t *column = MG_ALLOC_ARY(temp_pool, int64_t, count);
+    if (column == NULL) {
+      temp_pool->error = &MONGORY_ALLOC_ERROR;
+      return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+      column[i] = values[selection[i]]->data.i;
+    }
+    mongory_compare_kernel_i64(op, column, count, condition->data.i, mask);
+  } else {
+    double *column = MG_ALLOC_ARY(temp_pool, double, count);
+    if (column == NULL) {
+      temp_pool->error = &MONGORY_ALLOC_ERROR;
+      return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+      mongory_value *value = values[selection[i]];
+      column[i] = value->type == MONGORY_TYPE_INT ? (double)value->data.i : value->data.d;
+    }
+    mongory_compare_kernel_f64(op, column, count, condition->data.d, mask);
+  }
+
+  size_t matched = 0;
+  for (size_t i = 0; i < count; i++) {
+    if ((mask[i >> 6] >> (i & 63)) & 1) {
+      selection[matched++] = selection[i];
+    }
+  }
+  return matched;
+}
+
 // ============================================================================
 // Static Match Functions
 //
@@ -57,17 +157,21 @@ static inline mongory_matcher *mongory_matcher_compare_new(mongory_memory_pool *
  * if the types are not comparable.
  */
 static inline bool mongory_matcher_equal_match(mongory_matcher *matcher, mongory_value *value) {
-  if (!value || !value->comp || !matcher->condition)
+  if (!value || !matcher->condition)
     return false; // Invalid inputs
-  int result = value->comp(value, matcher->condition);
-  if (result == mongory_value_compare_fail) {
-    return false; // Types are not comparable or other comparison error.
-  }
-  return result == 0; // 0 indicates equality.
+  // Incomparable types are not equal.
+  return mongory_value_equal(value, matcher->condition);
+}
+
+static size_t mongory_matcher_equal_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                size_t count, mongory_memory_pool *temp_pool) {
+  return mongory_matcher_compare_match_batch(matcher, values, selection, count, temp_pool, MONGORY_COMPARE_KERNEL_EQ);
 }
 
 mongory_matcher *mongory_matcher_equal_new(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx) {
-  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_equal_match, extern_ctx);
+  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_equal_match,
+                                                         mongory_matcher_equal_compile,
+                                                         mongory_matcher_equal_match_batch, extern_ctx);
   if (!matcher) {
     return NULL;
   }
@@ -89,17 +193,21 @@ mongory_matcher *mongory_matcher_equal_new(mongory_memory_pool *pool, mongory_va
  * are not comparable.
  */
 static inline bool mongory_matcher_not_equal_match(mongory_matcher *matcher, mongory_value *value) {
-  if (!value || !value->comp || !matcher->condition)
+  if (!value || !matcher->condition)
     return true; // Invalid inputs, treat as "not equal"
-  int result = value->comp(value, matcher->condition);
-  if (result == mongory_value_compare_fail) {
-    return true; // Incomparable types are considered "not equal".
-  }
-  return result != 0; // Non-zero indicates inequality.
+  // Incomparable types are considered "not equal".
+  return !mongory_value_equal(value, matcher->condition);
+}
+
+static size_t mongory_matcher_not_equal_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                    size_t count, mongory_memory_pool *temp_pool) {
+  return mongory_matcher_compare_match_batch(matcher, values, selection, count, temp_pool, MONGORY_COMPARE_KERNEL_NE);
 }
 
 mongory_matcher *mongory_matcher_not_equal_new(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx) {
-  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_not_equal_match, extern_ctx);
+  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_not_equal_match,
+                                                         mongory_matcher_not_equal_compile,
+                                                         mongory_matcher_not_equal_match_batch, extern_ctx);
   if (!matcher) {
     return NULL;
   }
@@ -116,17 +224,24 @@ mongory_matcher *mongory_matcher_not_equal_new(mongory_memory_pool *pool, mongor
  * otherwise or on comparison failure.
  */
 static inline bool mongory_matcher_greater_than_match(mongory_matcher *matcher, mongory_value *value) {
-  if (!value || !value->comp || !matcher->condition)
+  if (!value || !matcher->condition)
     return false;
-  int result = value->comp(value, matcher->condition);
+  int result = mongory_value_compare(value, matcher->condition);
   if (result == mongory_value_compare_fail) {
     return false;
   }
   return result == 1; // 1 indicates value > condition.
 }
 
+static size_t mongory_matcher_greater_than_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                       size_t count, mongory_memory_pool *temp_pool) {
+  return mongory_matcher_compare_match_batch(matcher, values, selection, count, temp_pool, MONGORY_COMPARE_KERNEL_GT);
+}
+
 mongory_matcher *mongory_matcher_greater_than_new(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx) {
-  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_greater_than_match, extern_ctx);
+  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_greater_than_match,
+                                                         mongory_matcher_greater_than_compile,
+                                                         mongory_matcher_greater_than_match_batch, extern_ctx);
   if (!matcher) {
     return NULL;
   }
@@ -143,17 +258,24 @@ mongory_matcher *mongory_matcher_greater_than_new(mongory_memory_pool *pool, mon
  * on comparison failure.
  */
 static inline bool mongory_matcher_less_than_match(mongory_matcher *matcher, mongory_value *value) {
-  if (!value || !value->comp || !matcher->condition)
+  if (!value || !matcher->condition)
     return false;
-  int result = value->comp(value, matcher->condition);
+  int result = mongory_value_compare(value, matcher->condition);
   if (result == mongory_value_compare_fail) {
     return false;
   }
   return result == -1; // -1 indicates value < condition.
 }
 
+static size_t mongory_matcher_less_than_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                    size_t count, mongory_memory_pool *temp_pool) {
+  return mongory_matcher_compare_match_batch(matcher, values, selection, count, temp_pool, MONGORY_COMPARE_KERNEL_LT);
+}
+
 mongory_matcher *mongory_matcher_less_than_new(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx) {
-  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_less_than_match, extern_ctx);
+  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_less_than_match,
+                                                         mongory_matcher_less_than_compile,
+                                                         mongory_matcher_less_than_match_batch, extern_ctx);
   if (!matcher) {
     return NULL;
   }
@@ -170,17 +292,24 @@ mongory_matcher *mongory_matcher_less_than_new(mongory_memory_pool *pool, mongor
  * comparison failure.
  */
 static inline bool mongory_matcher_greater_than_or_equal_match(mongory_matcher *matcher, mongory_value *value) {
-  if (!value || !value->comp || !matcher->condition)
+  if (!value || !matcher->condition)
     return false;
-  int result = value->comp(value, matcher->condition);
+  int result = mongory_value_compare(value, matcher->condition);
   if (result == mongory_value_compare_fail) {
     return false;
   }
   return result >= 0; // 0 or 1 indicates value >= condition.
 }
 
+static size_t mongory_matcher_greater_than_or_equal_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                                size_t count, mongory_memory_pool *temp_pool) {
+  return mongory_matcher_compare_match_batch(matcher, values, selection, count, temp_pool, MONGORY_COMPARE_KERNEL_GTE);
+}
+
 mongory_matcher *mongory_matcher_greater_than_or_equal_new(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx) {
-  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_greater_than_or_equal_match, extern_ctx);
+  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_greater_than_or_equal_match,
+                                                         mongory_matcher_greater_than_or_equal_compile,
+                                                         mongory_matcher_greater_than_or_equal_match_batch, extern_ctx);
   if (!matcher) {
     return NULL;
   }
@@ -197,17 +326,24 @@ mongory_matcher *mongory_matcher_greater_than_or_equal_new(mongory_memory_pool *
  * comparison failure.
  */
 static inline bool mongory_matcher_less_than_or_equal_match(mongory_matcher *matcher, mongory_value *value) {
-  if (!value || !value->comp || !matcher->condition)
+  if (!value || !matcher->condition)
     return false;
-  int result = value->comp(value, matcher->condition);
+  int result = mongory_value_compare(value, matcher->condition);
   if (result == mongory_value_compare_fail) {
     return false;
   }
   return result <= 0; // 0 or -1 indicates value <= condition.
 }
 
+static size_t mongory_matcher_less_than_or_equal_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                             size_t count, mongory_memory_pool *temp_pool) {
+  return mongory_matcher_compare_match_batch(matcher, values, selection, count, temp_pool, MONGORY_COMPARE_KERNEL_LTE);
+}
+
 mongory_matcher *mongory_matcher_less_than_or_equal_new(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx) {
-  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_less_than_or_equal_match, extern_ctx);
+  mongory_matcher *matcher = mongory_matcher_compare_new(pool, condition, mongory_matcher_less_than_or_equal_match,
+                                                         mongory_matcher_less_than_or_equal_compile,
+                                                         mongory_matcher_less_than_or_equal_match_batch, extern_ctx);
   if (!matcher) {
     return NULL;
   }
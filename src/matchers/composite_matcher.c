@@ -7,7 +7,7 @@
 #include "composite_matcher.h"
 #include "external_matcher.h"
 #include "../foundations/config_private.h"  // For mongory_matcher_build_func_get
-#include "../foundations/array_private.h"   // For mongory_array_sort_by
+#include "../foundations/array_private.h"   // For mongory_array_sort_by, mongory_array_peek
 #include "../foundations/string_buffer.h"   // For mongory_string_buffer_new
 #include "base_matcher.h"                   // For mongory_matcher_always_true_new, etc.
 #include "literal_matcher.h"                // For mongory_matcher_field_new
@@ -20,6 +20,7 @@
 #include "../foundations/utils.h"
 #include <mongory-core.h> // General include
 #include <stdio.h>        // For sprintf
+#include <string.h>       // For memcpy
 
 // Forward declaration.
 double mongory_matcher_calculate_priority(mongory_array *sub_matchers);
@@ -58,6 +59,9 @@ mongory_composite_matcher *mongory_matcher_composite_new(mongory_memory_pool *po
   composite->base.sub_count = 0;
   composite->base.condition = condition;
   composite->base.traverse = mongory_matcher_composite_traverse;
+  composite->base.compile = mongory_matcher_leaf_compile;
+  composite->base.match_batch = mongory_matcher_leaf_match_batch;
+  composite->base.frozen = false;
   composite->base.extern_ctx = extern_ctx;
   composite->base.priority = 2.0;
   return composite;
@@ -83,7 +87,7 @@ static inline bool mongory_matcher_and_match(mongory_matcher *matcher, mongory_v
   int total = (int)children->count;
   for (int i = 0; i < total; i++) {
     mongory_matcher *child = (mongory_matcher *)children->get(children, i);
-    if (!child->match(child, value)) {
+    if (!mongory_matcher_dispatch(child, value)) {
       return false;
     }
   }
@@ -107,13 +111,72 @@ bool mongory_matcher_or_match(mongory_matcher *matcher, mongory_value *value) {
   int total = (int)children->count;
   for (int i = 0; i < total; i++) {
     mongory_matcher *child = (mongory_matcher *)children->get(children, i);
-    if (child->match(child, value)) {
+    if (mongory_matcher_dispatch(child, value)) {
       return true;
     }
   }
   return false; // Neither matched (or children didn't exist).
 }
 
+/**
+ * @brief Batch match function for an AND logical operation.
+ *
+ * Each child runs once over the rows still alive, in priority order, and
+ * narrows the selection for the next child.
+ *
+ * @param matcher Pointer to the composite AND matcher.
+ * @param values The batch of values.
+ * @param selection Rows to evaluate; compacted to the matching rows.
+ * @param count Number of rows in `selection`.
+ * @param temp_pool Pool for scratch allocations.
+ * @return Number of matching rows.
+ */
+static size_t mongory_matcher_and_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                              size_t count, mongory_memory_pool *temp_pool) {
+  mongory_array *children = ((mongory_composite_matcher *)matcher)->children;
+  size_t total = children->count;
+  for (size_t i = 0; i < total && count > 0; i++) {
+    mongory_matcher *child = (mongory_matcher *)children->get(children, i);
+    count = child->match_batch(child, values, selection, count, temp_pool);
+  }
+  return count;
+}
+
+/**
+ * @brief Batch match function for an OR logical operation.
+ *
+ * Each child runs once over the rows not yet accepted by an earlier child.
+ * Rows rejected by every child are removed from the selection.
+ *
+ * @param matcher Pointer to the composite OR matcher.
+ * @param values The batch of values.
+ * @param selection Rows to evaluate; compacted to the matching rows.
+ * @param count Number of rows in `selection`.
+ * @param temp_pool Pool for scratch allocations.
+ * @return Number of matching rows.
+ */
+static size_t mongory_matcher_or_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                             size_t count, mongory_memory_pool *temp_pool) {
+  mongory_array *children = ((mongory_composite_matcher *)matcher)->children;
+  size_t *pending = MG_ALLOC_ARY(temp_pool, size_t, count);
+  size_t *accepted = MG_ALLOC_ARY(temp_pool, size_t, count);
+  if (pending == NULL || accepted == NULL) {
+    temp_pool->error = &MONGORY_ALLOC_ERROR;
+    return 0;
+  }
+  memcpy(pending, selection, sizeof(size_t) * count);
+  size_t pending_count = count;
+  size_t total = children->count;
+  for (size_t i = 0; i < total && pending_count > 0; i++) {
+    mongory_matcher *child = (mongory_matcher *)children->get(children, i);
+    memcpy(accepted, pending, sizeof(size_t) * pending_count);
+    size_t accepted_count = child->match_batch(child, values, accepted, pending_count, temp_pool);
+    pending_count = mongory_matcher_selection_subtract(pending, pending_count, accepted, accepted_count);
+  }
+  // Whatever is still pending was rejected by every child.
+  return mongory_matcher_selection_subtract(selection, count, pending, pending_count);
+}
+
 /**
  * @brief Context structure for building sub-matchers from a table.
  */
@@ -236,6 +299,8 @@ mongory_matcher *mongory_matcher_table_cond_new(mongory_memory_pool *pool, mongo
   final_matcher->children = mongory_matcher_sort_matchers(sub_matchers);
   final_matcher->base.match = mongory_matcher_and_match;
   final_matcher->base.original_match = mongory_matcher_and_match;
+  final_matcher->base.compile = mongory_matcher_and_compile;
+  final_matcher->base.match_batch = mongory_matcher_and_match_batch;
   final_matcher->base.sub_count = sub_matchers->count;
   final_matcher->base.name = mongory_string_cpy(pool, "Condition");
   final_matcher->base.priority += mongory_matcher_calculate_priority(sub_matchers);
@@ -255,7 +320,8 @@ static inline bool mongory_matcher_build_and_sub_matcher(mongory_value *and_sub_
   // The 'and_sub_condition' is one of the tables in the $and:[{}, {}, ...] array.
   // We need to build all matchers from this table and add them to the list.
   // The list in 'acc' (ctx->matchers) will then be ANDed together.
-  if (!MONGORY_VALIDATE_TABLE(and_sub_condition->pool, and_sub_condition)) {
+  mongory_memory_pool *pool = ((mongory_matcher_table_build_sub_matcher_context *)acc)->pool;
+  if (!MONGORY_VALIDATE_TABLE(MONGORY_VALUE_POOL(and_sub_condition, pool), and_sub_condition)) {
     return false; // Element in $and array is not a table.
   }
   return and_sub_condition->data.t->each(and_sub_condition->data.t, acc, mongory_matcher_table_build_sub_matcher);
@@ -319,6 +385,8 @@ mongory_matcher *mongory_matcher_and_new(mongory_memory_pool *pool, mongory_valu
   final_matcher->children = mongory_matcher_sort_matchers(sub_matchers);
   final_matcher->base.match = mongory_matcher_and_match;
   final_matcher->base.original_match = mongory_matcher_and_match;
+  final_matcher->base.compile = mongory_matcher_and_compile;
+  final_matcher->base.match_batch = mongory_matcher_and_match_batch;
   final_matcher->base.sub_count = sub_matchers->count;
   final_matcher->base.name = mongory_string_cpy(pool, "And");
   final_matcher->base.priority += mongory_matcher_calculate_priority(sub_matchers);
@@ -400,6 +468,8 @@ mongory_matcher *mongory_matcher_or_new(mongory_memory_pool *pool, mongory_value
   final_matcher->children = mongory_matcher_sort_matchers(sub_matchers);
   final_matcher->base.match = mongory_matcher_or_match;
   final_matcher->base.original_match = mongory_matcher_or_match;
+  final_matcher->base.compile = mongory_matcher_or_compile;
+  final_matcher->base.match_batch = mongory_matcher_or_match_batch;
   final_matcher->base.sub_count = sub_matchers->count;
   final_matcher->base.name = mongory_string_cpy(pool, "Or");
   final_matcher->base.priority += mongory_matcher_calculate_priority(sub_matchers);
@@ -426,9 +496,10 @@ static inline bool mongory_matcher_elem_match_match(mongory_matcher *matcher, mo
   if (target_array->count == 0)
     return false; // Empty array cannot have a matching element.
 
+  mongory_value scratch;
   int total = (int)target_array->count;
   for (int i = 0; i < total; i++) {
-    mongory_value *value = target_array->get(target_array, i);
+    mongory_value *value = mongory_array_peek(target_array, i, &scratch);
     if (mongory_matcher_and_match(matcher, value)) {
       return true;
     }
@@ -465,6 +536,7 @@ mongory_matcher *mongory_matcher_elem_match_new(mongory_memory_pool *pool, mongo
   composite->children = mongory_matcher_sort_matchers(sub_matchers);
   composite->base.match = mongory_matcher_elem_match_match;
   composite->base.original_match = mongory_matcher_elem_match_match;
+  composite->base.compile = mongory_matcher_elem_match_compile;
   composite->base.sub_count = sub_matchers->count;
   composite->base.name = mongory_string_cpy(pool, "ElemMatch");
   composite->base.priority = 3.0 + mongory_matcher_calculate_priority(sub_matchers);
@@ -488,9 +560,10 @@ static inline bool mongory_matcher_every_match(mongory_matcher *matcher, mongory
   if (target_array->count == 0)
     return false; // Non-empty array must have at least one element.
 
+  mongory_value scratch;
   int total = (int)target_array->count;
   for (int i = 0; i < total; i++) {
-    mongory_value *value = target_array->get(target_array, i);
+    mongory_value *value = mongory_array_peek(target_array, i, &scratch);
     if (!mongory_matcher_and_match(matcher, value)) {
       return false;
     }
@@ -527,6 +600,7 @@ mongory_matcher *mongory_matcher_every_new(mongory_memory_pool *pool, mongory_va
   composite->children = mongory_matcher_sort_matchers(sub_matchers);
   composite->base.match = mongory_matcher_every_match;
   composite->base.original_match = mongory_matcher_every_match;
+  composite->base.compile = mongory_matcher_every_compile;
   composite->base.sub_count = sub_matchers->count;
   composite->base.name = mongory_string_cpy(pool, "Every");
   composite->base.priority = 3.0 + mongory_matcher_calculate_priority(sub_matchers);
@@ -556,13 +630,21 @@ static inline size_t mongory_matcher_calc_priority(mongory_value *matcher_value,
   return (size_t)(matcher->priority * 10000);
 }
 
+/**
+ * @def MONGORY_MATCHER_SORT_BUFFER_SIZE
+ * @brief Size of the stack buffer the sort's temporary pool starts in, enough
+ * for the merge buffers of a few dozen sub-matchers.
+ */
+#define MONGORY_MATCHER_SORT_BUFFER_SIZE 1024
+
 /**
  * @brief Sorts the sub-matchers by priority.
  * @param sub_matchers The array of sub-matchers.
  * @return The sorted array of sub-matchers.
  */
 mongory_array *mongory_matcher_sort_matchers(mongory_array *sub_matchers) {
-  mongory_memory_pool *temp_pool = mongory_memory_pool_new();
+  char buffer[MONGORY_MATCHER_SORT_BUFFER_SIZE];
+  mongory_memory_pool *temp_pool = mongory_memory_pool_init_with_buffer(buffer, sizeof(buffer));
   if (temp_pool == NULL) {
     sub_matchers->pool->error = &MONGORY_ALLOC_ERROR;
     return NULL;
@@ -117,6 +117,9 @@ mongory_matcher *mongory_matcher_custom_new(mongory_memory_pool *pool, char *key
   matcher->base.original_match = mongory_matcher_custom_match;
   matcher->base.explain = mongory_matcher_base_explain;
   matcher->base.traverse = mongory_matcher_leaf_traverse;
+  matcher->base.compile = mongory_matcher_leaf_compile;
+  matcher->base.match_batch = mongory_matcher_leaf_match_batch;
+  matcher->base.frozen = false;
   matcher->base.extern_ctx = extern_ctx;
   matcher->external_matcher = context->external_matcher;
   matcher->base.priority = 20.0;
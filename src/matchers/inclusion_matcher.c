@@ -2,16 +2,29 @@
  * @file inclusion_matcher.c
  * @brief Implements $in and $nin matchers for checking value inclusion in an
  * array. This is an internal implementation file for the matcher module.
+ *
+ * The condition array is loaded into a `mongory_value_set` when the matcher is
+ * built, so a membership test costs a hash lookup instead of a scan of the
+ * condition.
  */
 #include "inclusion_matcher.h"
-#include "base_matcher.h"                   // For mongory_matcher_base_new
-#include "../foundations/array_private.h"   // For mongory_array_includes
+#include "base_matcher.h"                   // For mongory_matcher_leaf_* defaults
+#include "../foundations/array_private.h"   // For mongory_array_peek
+#include "../foundations/value_set.h"       // For mongory_value_set
 #include "mongory-core/foundations/array.h" // For mongory_array operations
 #include "mongory-core/foundations/error.h" // For mongory_error
 #include "mongory-core/foundations/value.h" // For mongory_value
 #include <mongory-core.h>                   // General include
 #include "../foundations/utils.h"            // For mongory_string_cpy
 
+/**
+ * @brief An inclusion matcher with the condition array loaded into a set.
+ */
+typedef struct mongory_inclusion_matcher {
+  mongory_matcher base;   /**< Base matcher fields. */
+  mongory_value_set *set; /**< The values of the condition array. */
+} mongory_inclusion_matcher;
+
 /**
  * @brief Validates that the condition for an inclusion matcher is a valid
  * array.
@@ -32,6 +45,53 @@ static inline bool mongory_matcher_validate_array_condition(mongory_value *condi
   return true;
 }
 
+/**
+ * @brief Allocates an inclusion matcher and loads the condition array into its
+ * set. The caller sets the name and match functions.
+ *
+ * The lookup cost no longer grows with the size of the condition, only the
+ * rarely used non-hashable values (arrays, tables, ...) are still compared one
+ * by one, so the priority only grows with those.
+ *
+ * @param pool Memory pool for allocation.
+ * @param condition The validated condition array.
+ * @param extern_ctx External context for the matcher.
+ * @return The new matcher, or NULL on allocation failure.
+ */
+static mongory_matcher *mongory_matcher_inclusion_new(mongory_memory_pool *pool, mongory_value *condition,
+                                                      void *extern_ctx) {
+  mongory_inclusion_matcher *matcher = MG_ALLOC_PTR(pool, mongory_inclusion_matcher);
+  if (matcher == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  matcher->set = mongory_value_set_new(pool);
+  if (matcher->set == NULL) {
+    return NULL;
+  }
+  mongory_array *condition_array = condition->data.a;
+  for (size_t i = 0; i < condition_array->count; i++) {
+    if (!mongory_value_set_add(matcher->set, condition_array->get(condition_array, i))) {
+      return NULL;
+    }
+  }
+
+  matcher->base.pool = pool;
+  matcher->base.name = NULL;
+  matcher->base.match = NULL;
+  matcher->base.explain = mongory_matcher_base_explain;
+  matcher->base.original_match = NULL;
+  matcher->base.sub_count = 0;
+  matcher->base.condition = condition;
+  matcher->base.traverse = mongory_matcher_leaf_traverse;
+  matcher->base.compile = mongory_matcher_leaf_compile;
+  matcher->base.match_batch = mongory_matcher_leaf_match_batch;
+  matcher->base.frozen = false;
+  matcher->base.extern_ctx = extern_ctx;
+  matcher->base.priority = 1.0 + mongory_log((double)matcher->set->others->count + 1.0, 1.5);
+  return &matcher->base;
+}
+
 /**
  * @brief Match function for the $in matcher.
  *
@@ -46,15 +106,14 @@ static inline bool mongory_matcher_validate_array_condition(mongory_value *condi
  * condition array, false otherwise.
  */
 static inline bool mongory_matcher_in_match(mongory_matcher *matcher, mongory_value *value_to_check) {
-  if (!value_to_check || !matcher->condition || !matcher->condition->data.a) {
-    // Invalid inputs or condition is not a proper array.
+  if (!value_to_check) {
     return false;
   }
 
-  mongory_array *condition_array = matcher->condition->data.a;
+  mongory_value_set *set = ((mongory_inclusion_matcher *)matcher)->set;
 
   if (value_to_check->type != MONGORY_TYPE_ARRAY) {
-    return mongory_array_includes(condition_array, value_to_check);
+    return mongory_value_set_includes(set, value_to_check);
   }
 
   mongory_array *input_array = value_to_check->data.a;
@@ -62,9 +121,10 @@ static inline bool mongory_matcher_in_match(mongory_matcher *matcher, mongory_va
     return false;
   }
 
+  mongory_value scratch;
   for (size_t i = 0; i < input_array->count; i++) {
-    mongory_value *input_item = input_array->get(input_array, i);
-    if (mongory_array_includes(condition_array, input_item)) {
+    mongory_value *input_item = mongory_array_peek(input_array, i, &scratch);
+    if (mongory_value_set_includes(set, input_item)) {
       return true;
     }
   }
@@ -81,14 +141,13 @@ mongory_matcher *mongory_matcher_in_new(mongory_memory_pool *pool, mongory_value
     }
     return NULL;
   }
-  mongory_matcher *matcher = mongory_matcher_base_new(pool, condition, extern_ctx);
+  mongory_matcher *matcher = mongory_matcher_inclusion_new(pool, condition, extern_ctx);
   if (!matcher) {
     return NULL;
   }
   matcher->match = mongory_matcher_in_match;
   matcher->original_match = mongory_matcher_in_match;
   matcher->name = mongory_string_cpy(pool, "In");
-  matcher->priority = 1.0 + mongory_log((double)condition->data.a->count + 1.0, 1.5);
   return matcher;
 }
 
@@ -114,13 +173,12 @@ mongory_matcher *mongory_matcher_not_in_new(mongory_memory_pool *pool, mongory_v
     }
     return NULL;
   }
-  mongory_matcher *matcher = mongory_matcher_base_new(pool, condition, extern_ctx);
+  mongory_matcher *matcher = mongory_matcher_inclusion_new(pool, condition, extern_ctx);
   if (!matcher) {
     return NULL;
   }
   matcher->match = mongory_matcher_not_in_match;
   matcher->original_match = mongory_matcher_not_in_match;
   matcher->name = mongory_string_cpy(pool, "Nin");
-  matcher->priority = 1.0 + mongory_log((double)condition->data.a->count + 1.0, 1.5);
   return matcher;
 }
@@ -14,6 +14,7 @@
 #include "../foundations/config_private.h"  // For mongory_internal_value_converter
 #include "../foundations/utils.h"           // For mongory_try_parse_int, mongory_string_cpy
 #include "../foundations/string_buffer.h"   // For mongory_string_buffer_appendf
+#include "../foundations/shape_private.h"   // For shaped table lookups
 #include "array_record_matcher.h"           // For handling array-specific matching logic
 #include "base_matcher.h"                   // For mongory_matcher_base_new
 #include "compare_matcher.h"                // For mongory_matcher_equal_new
@@ -27,6 +28,7 @@
 #include "external_matcher.h"               // For mongory_matcher_regex_new
 #include <mongory-core.h>                   // General include
 #include <stdio.h>                          // For printf
+#include <string.h>                         // For memcpy
 
 /**
  * @brief Core matching logic for literal-based conditions.
@@ -56,20 +58,83 @@ static inline bool mongory_matcher_literal_match(mongory_matcher *matcher, mongo
 
   if (value != NULL && value->type == MONGORY_TYPE_ARRAY) {
     // If the value being matched is an array, there's special handling.
-    // The `right` child of the composite matcher is used for array record matching.
-    // It's created on-demand if not already present.
-    if (literal->array_record_matcher == NULL) {
-      // Lazily create the array_record_matcher if needed.
-      // The condition for array_record_new is the original condition of the literal matcher.
-      literal->array_record_matcher = mongory_matcher_array_record_new(literal->base.pool, literal->base.condition, literal->base.extern_ctx);
-    }
-    // If right child exists (or was successfully created), use it.
-    return literal->array_record_matcher ? literal->array_record_matcher->match(literal->array_record_matcher, value) : false;
+    // The array record matcher is created on-demand if not already present.
+    mongory_matcher *array_record_matcher = mongory_matcher_literal_array_record(literal);
+    return array_record_matcher ? mongory_matcher_dispatch(array_record_matcher, value) : false;
   } else {
     // For non-array values, or if array-specific path wasn't taken.
     // The `left` child handles the general literal condition.
-    return literal->delegate_matcher ? literal->delegate_matcher->match(literal->delegate_matcher, value) : false;
+    return literal->delegate_matcher ? mongory_matcher_dispatch(literal->delegate_matcher, value) : false;
+  }
+}
+
+mongory_matcher *mongory_matcher_literal_array_record(mongory_literal_matcher *literal) {
+  // A frozen matcher built its array record matcher while freezing and is
+  // never modified afterwards.
+  if (literal->array_record_matcher == NULL && !literal->base.frozen) {
+    // Lazily create the array_record_matcher if needed.
+    // The condition for array_record_new is the original condition of the literal matcher.
+    literal->array_record_matcher = mongory_matcher_array_record_new(literal->base.pool, literal->base.condition, literal->base.extern_ctx);
+  }
+  return literal->array_record_matcher;
+}
+
+/**
+ * @brief Batch counterpart of `mongory_matcher_literal_match`.
+ *
+ * Splits the selected rows into array and non-array values, runs the array
+ * record matcher and the delegate matcher once over their respective rows and
+ * merges the survivors back in row order.
+ *
+ * @param matcher The literal matcher.
+ * @param values The batch of values.
+ * @param selection Rows to evaluate; compacted to the matching rows.
+ * @param count Number of rows in `selection`.
+ * @param temp_pool Pool for scratch allocations.
+ * @return Number of matching rows.
+ */
+static size_t mongory_matcher_literal_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                  size_t count, mongory_memory_pool *temp_pool) {
+  mongory_literal_matcher *literal = (mongory_literal_matcher *)matcher;
+  size_t *array_rows = MG_ALLOC_ARY(temp_pool, size_t, count);
+  size_t *other_rows = MG_ALLOC_ARY(temp_pool, size_t, count);
+  if (array_rows == NULL || other_rows == NULL) {
+    temp_pool->error = &MONGORY_ALLOC_ERROR;
+    return 0;
+  }
+  size_t array_count = 0;
+  size_t other_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    mongory_value *value = values[selection[i]];
+    if (value != NULL && value->type == MONGORY_TYPE_ARRAY) {
+      array_rows[array_count++] = selection[i];
+    } else {
+      other_rows[other_count++] = selection[i];
+    }
+  }
+
+  if (other_count > 0) {
+    mongory_matcher *delegate = literal->delegate_matcher;
+    other_count = delegate ? delegate->match_batch(delegate, values, other_rows, other_count, temp_pool) : 0;
+  }
+  if (array_count > 0) {
+    mongory_matcher *array_record_matcher = mongory_matcher_literal_array_record(literal);
+    array_count = array_record_matcher
+                      ? array_record_matcher->match_batch(array_record_matcher, values, array_rows, array_count, temp_pool)
+                      : 0;
   }
+
+  size_t matched = 0;
+  size_t a = 0;
+  size_t o = 0;
+  while (a < array_count || o < other_count) {
+    if (o == other_count || (a < array_count && array_rows[a] < other_rows[o])) {
+      selection[matched++] = array_rows[a++];
+    } else {
+      selection[matched++] = other_rows[o++];
+    }
+  }
+  return matched;
 }
 
 /**
@@ -87,8 +152,8 @@ static inline bool mongory_matcher_literal_match(mongory_matcher *matcher, mongo
  */
 static inline mongory_matcher *mongory_matcher_null_new(mongory_memory_pool *pool, void *extern_ctx) {
   mongory_value *new_or_condition = MG_ARRAY_WRAP(pool, 2,
-    MG_TABLE_WRAP(pool, 1, "$eq", mongory_value_wrap_n(pool, NULL)),
-    MG_TABLE_WRAP(pool, 1, "$exists", mongory_value_wrap_b(pool, false))
+    MG_TABLE_WRAP(pool, 1, "$eq", mongory_value_wrap_n_shared(pool, NULL)),
+    MG_TABLE_WRAP(pool, 1, "$exists", mongory_value_wrap_b_shared(pool, false))
   );
   return mongory_matcher_or_new(pool, new_or_condition, extern_ctx);
 }
@@ -125,19 +190,46 @@ static inline mongory_matcher *mongory_matcher_literal_delegate(mongory_memory_p
 }
 
 /**
- * @brief Match function for a field matcher.
+ * @brief Reads a field of a shaped table through the matcher's inline cache.
  *
- * Extracts the value of `field_matcher->field` from the input `value`
- * (table or array). Then, applies the literal matching logic
- * (`mongory_matcher_literal_match`) using the sub-matcher stored in
- * `composite.left` (which was set up by `literal_delegate` based on the
- * original condition for this field).
+ * A hit costs a pointer comparison per entry and an indexed load. On a miss
+ * the field is searched in the shape and the result, including "not there",
+ * replaces the oldest entry. Frozen matchers may be shared between threads,
+ * so they only read the cache. Entries filled before shapes were last freed
+ * by `mongory_cleanup` are stale and never compared.
  *
- * @param matcher Pointer to the `mongory_matcher` (a `mongory_field_matcher`).
- * @param value The input table or array to extract the field from.
- * @return True if the field's value matches the condition, false otherwise.
+ * @param field_matcher The field matcher.
+ * @param table A shaped table.
+ * @param shape The table's shape.
+ * @return The field's value, or NULL if the table has no such field.
  */
-static inline bool mongory_matcher_field_match(mongory_matcher *matcher, mongory_value *value) {
+static inline mongory_value *mongory_matcher_field_shaped_get(mongory_field_matcher *field_matcher,
+                                                              mongory_table *table, mongory_shape *shape) {
+  if (field_matcher->cache_epoch != mongory_shape_epoch) {
+    if (field_matcher->literal.base.frozen) {
+      return mongory_shaped_table_at(
+          table, mongory_shape_index(shape, field_matcher->field, field_matcher->field_len, field_matcher->field_hash));
+    }
+    for (int i = 0; i < MONGORY_FIELD_CACHE_SIZE; i++) {
+      field_matcher->cache[i].shape = NULL;
+    }
+    field_matcher->cache_epoch = mongory_shape_epoch;
+  }
+  for (int i = 0; i < MONGORY_FIELD_CACHE_SIZE; i++) {
+    if (field_matcher->cache[i].shape == shape)
+      return mongory_shaped_table_at(table, field_matcher->cache[i].index);
+  }
+  size_t index = mongory_shape_index(shape, field_matcher->field, field_matcher->field_len, field_matcher->field_hash);
+  if (!field_matcher->literal.base.frozen) {
+    mongory_field_cache_entry *entry = &field_matcher->cache[field_matcher->cache_next];
+    entry->shape = shape;
+    entry->index = index;
+    field_matcher->cache_next = (field_matcher->cache_next + 1) % MONGORY_FIELD_CACHE_SIZE;
+  }
+  return mongory_shaped_table_at(table, index);
+}
+
+bool mongory_matcher_field_lookup(mongory_matcher *matcher, mongory_value *value, mongory_value **out) {
   if (value == NULL) { // Cannot extract field from NULL.
     return false;
   }
@@ -150,7 +242,13 @@ static inline bool mongory_matcher_field_match(mongory_matcher *matcher, mongory
 
   if (value->type == MONGORY_TYPE_TABLE) {
     if (value->data.t) {
-      field_value = value->data.t->get(value->data.t, field_key);
+      mongory_shape *shape = mongory_table_shape(value->data.t);
+      if (shape) {
+        field_value = mongory_matcher_field_shaped_get(field_matcher, value->data.t, shape);
+      } else {
+        field_value =
+            mongory_table_get_with_hash(value->data.t, field_key, field_matcher->field_len, field_matcher->field_hash);
+      }
     }
   } else if (value->type == MONGORY_TYPE_ARRAY) {
     if (value->data.a) {
@@ -173,16 +271,72 @@ static inline bool mongory_matcher_field_match(mongory_matcher *matcher, mongory
   // If the extracted field value is a pointer type that needs conversion
   // (e.g., from a language binding), convert it.
   if (field_value && field_value->type == MONGORY_TYPE_POINTER && mongory_internal_value_converter.shallow_convert) {
-    // The pool for the converted value should ideally be the field_value's pool
-    // or the matcher's pool.
-    mongory_memory_pool *conversion_pool = field_value->pool ? field_value->pool : matcher->pool;
+    // The converted value only lives for this match: it goes to the match's
+    // scratch pool, or else to the field_value's pool or the matcher's pool.
+    mongory_memory_pool *conversion_pool = mongory_matcher_scratch_current;
+    if (conversion_pool == NULL)
+      conversion_pool = MONGORY_VALUE_POOL(field_value, matcher->pool);
     field_value = mongory_internal_value_converter.shallow_convert(conversion_pool, field_value->data.ptr);
   }
+  *out = field_value;
+  return true;
+}
+
+/**
+ * @brief Match function for a field matcher.
+ *
+ * Extracts the value of `field_matcher->field` from the input `value`
+ * (table or array) with `mongory_matcher_field_lookup`. Then, applies the
+ * literal matching logic (`mongory_matcher_literal_match`) to the extracted
+ * value.
+ *
+ * @param matcher Pointer to the `mongory_matcher` (a `mongory_field_matcher`).
+ * @param value The input table or array to extract the field from.
+ * @return True if the field's value matches the condition, false otherwise.
+ */
+static inline bool mongory_matcher_field_match(mongory_matcher *matcher, mongory_value *value) {
+  mongory_value *field_value = NULL;
+  if (!mongory_matcher_field_lookup(matcher, value, &field_value))
+    return false;
   // Now, use the literal_match logic (which uses composite.left primarily)
   // to match the extracted field_value.
   return mongory_matcher_literal_match(matcher, field_value);
 }
 
+/**
+ * @brief Batch match function for a field matcher.
+ *
+ * Gathers the field of every selected row into a column, runs the literal
+ * logic once over that column and maps the surviving positions back to rows.
+ *
+ * @param matcher Pointer to the `mongory_matcher` (a `mongory_field_matcher`).
+ * @param values The batch of values.
+ * @param selection Rows to evaluate; compacted to the matching rows.
+ * @param count Number of rows in `selection`.
+ * @param temp_pool Pool for scratch allocations.
+ * @return Number of matching rows.
+ */
+static size_t mongory_matcher_field_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                                size_t count, mongory_memory_pool *temp_pool) {
+  mongory_value **field_values = MG_ALLOC_ARY(temp_pool, mongory_value *, count);
+  size_t *positions = MG_ALLOC_ARY(temp_pool, size_t, count);
+  if (field_values == NULL || positions == NULL) {
+    temp_pool->error = &MONGORY_ALLOC_ERROR;
+    return 0;
+  }
+  size_t position_count = 0;
+  for (size_t i = 0; i < count; i++) {
+    if (mongory_matcher_field_lookup(matcher, values[selection[i]], &field_values[i])) {
+      positions[position_count++] = i;
+    }
+  }
+  size_t matched = mongory_matcher_literal_match_batch(matcher, field_values, positions, position_count, temp_pool);
+  for (size_t i = 0; i < matched; i++) {
+    selection[i] = selection[positions[i]];
+  }
+  return matched;
+}
+
 mongory_matcher *mongory_matcher_field_new(mongory_memory_pool *pool, char *field_name,
                                            mongory_value *condition_for_field, void *extern_ctx) {
   mongory_field_matcher *field_m = MG_ALLOC_PTR(pool, mongory_field_matcher);
@@ -196,6 +350,15 @@ mongory_matcher *mongory_matcher_field_new(mongory_memory_pool *pool, char *fiel
     // This indicates an error in string copy, likely pool allocation.
     return NULL;
   }
+  // The key is fixed, so it is hashed once here rather than on every record.
+  field_m->field_len = strlen(field_m->field);
+  field_m->field_hash = mongory_table_hash_key(field_m->field, field_m->field_len);
+  for (int i = 0; i < MONGORY_FIELD_CACHE_SIZE; i++) {
+    field_m->cache[i].shape = NULL;
+    field_m->cache[i].index = MONGORY_SHAPE_NOT_FOUND;
+  }
+  field_m->cache_next = 0;
+  field_m->cache_epoch = mongory_shape_epoch;
 
   // Initialize the base composite matcher part
   field_m->literal.base.pool = pool;
@@ -207,6 +370,9 @@ mongory_matcher *mongory_matcher_field_new(mongory_memory_pool *pool, char *fiel
   field_m->literal.base.name = mongory_string_cpy(pool, "Field");
   field_m->literal.base.explain = mongory_matcher_field_explain;
   field_m->literal.base.traverse = mongory_matcher_literal_traverse;
+  field_m->literal.base.compile = mongory_matcher_field_compile;
+  field_m->literal.base.match_batch = mongory_matcher_field_match_batch;
+  field_m->literal.base.frozen = false;
   // The 'left' child of the composite is the actual matcher for the field's value,
   // determined by the type of 'condition_for_field'.
   field_m->literal.delegate_matcher = mongory_matcher_literal_delegate(pool, condition_for_field, extern_ctx);
@@ -234,6 +400,28 @@ static inline bool mongory_matcher_not_match(mongory_matcher *matcher, mongory_v
   return !mongory_matcher_literal_match(matcher, value);
 }
 
+/**
+ * @brief Batch match function for a NOT matcher.
+ * Keeps the selected rows rejected by the literal logic.
+ * @param matcher The $not matcher.
+ * @param values The batch of values.
+ * @param selection Rows to evaluate; compacted to the matching rows.
+ * @param count Number of rows in `selection`.
+ * @param temp_pool Pool for scratch allocations.
+ * @return Number of matching rows.
+ */
+static size_t mongory_matcher_not_match_batch(mongory_matcher *matcher, mongory_value **values, size_t *selection,
+                                              size_t count, mongory_memory_pool *temp_pool) {
+  size_t *accepted = MG_ALLOC_ARY(temp_pool, size_t, count);
+  if (accepted == NULL) {
+    temp_pool->error = &MONGORY_ALLOC_ERROR;
+    return 0;
+  }
+  memcpy(accepted, selection, sizeof(size_t) * count);
+  size_t accepted_count = mongory_matcher_literal_match_batch(matcher, values, accepted, count, temp_pool);
+  return mongory_matcher_selection_subtract(selection, count, accepted, accepted_count);
+}
+
 mongory_matcher *mongory_matcher_not_new(mongory_memory_pool *pool, mongory_value *condition_to_negate, void *extern_ctx) {
   mongory_literal_matcher *literal = MG_ALLOC_PTR(pool, mongory_literal_matcher);
   if (!literal)
@@ -252,6 +440,9 @@ mongory_matcher *mongory_matcher_not_new(mongory_memory_pool *pool, mongory_valu
   literal->base.condition = condition_to_negate;
   literal->base.match = mongory_matcher_not_match;
   literal->base.original_match = mongory_matcher_not_match;
+  literal->base.compile = mongory_matcher_not_compile;
+  literal->base.match_batch = mongory_matcher_not_match_batch;
+  literal->base.frozen = false;
   literal->base.name = mongory_string_cpy(pool, "Not");
   literal->base.explain = mongory_matcher_literal_explain;
   literal->base.traverse = mongory_matcher_literal_traverse;
@@ -273,15 +464,23 @@ static inline bool mongory_matcher_size_match(mongory_matcher *matcher, mongory_
   if (!value || value->type != MONGORY_TYPE_ARRAY || !value->data.a) {
     return false; // $size only applies to valid arrays.
   }
-  mongory_array *array = value->data.a;
-  // Wrap the array's count as a mongory_value (integer) to be matched.
-  // The pool for this temporary size value should be from the input value or matcher.
+  int64_t count = (int64_t)value->data.a->count;
+  // Wrap the array's count as a mongory_value (integer) to be matched, without
+  // allocating: small counts have a shared value, larger ones are built on
+  // the stack from a shared int. Matchers never keep the value they match.
+  mongory_value *size_value = mongory_value_wrap_i_shared(NULL, count);
+  mongory_value large_size_value;
+  if (size_value == NULL) {
+    large_size_value = *mongory_value_wrap_i_shared(NULL, 0);
+    large_size_value.data.i = count;
+    size_value = &large_size_value;
+  }
 
   // Use literal_match with the matcher's original condition against the size_value.
   // The $size matcher's `composite.left` was set up by literal_delegate
   // based on the condition provided to $size (e.g., if {$size: 5}, left is an
   // equality matcher for 5).
-  return mongory_matcher_literal_match(matcher, mongory_value_wrap_i(value->pool, (int)array->count));
+  return mongory_matcher_literal_match(matcher, size_value);
 }
 
 mongory_matcher *mongory_matcher_size_new(mongory_memory_pool *pool, mongory_value *size_condition, void *extern_ctx) {
@@ -303,6 +502,9 @@ mongory_matcher *mongory_matcher_size_new(mongory_memory_pool *pool, mongory_val
   literal->base.condition = size_condition;
   literal->base.match = mongory_matcher_size_match;
   literal->base.original_match = mongory_matcher_size_match;
+  literal->base.compile = mongory_matcher_leaf_compile;
+  literal->base.match_batch = mongory_matcher_leaf_match_batch;
+  literal->base.frozen = false;
   literal->base.name = mongory_string_cpy(pool, "Size");
   literal->base.explain = mongory_matcher_literal_explain;
   literal->base.traverse = mongory_matcher_literal_traverse;
@@ -24,6 +24,21 @@ typedef struct mongory_literal_matcher {
   mongory_matcher *array_record_matcher;
 } mongory_literal_matcher;
 
+/**
+ * @def MONGORY_FIELD_CACHE_SIZE
+ * @brief Number of shapes a field matcher's inline cache remembers.
+ */
+#define MONGORY_FIELD_CACHE_SIZE 4
+
+/**
+ * @struct mongory_field_cache_entry
+ * @brief One inline cache entry: where the field sits in a shape.
+ */
+typedef struct mongory_field_cache_entry {
+  struct mongory_shape *shape; /**< The shape, or NULL for an unused entry. */
+  size_t index;                /**< The field's index in `shape`, possibly MONGORY_SHAPE_NOT_FOUND. */
+} mongory_field_cache_entry;
+
 /**
  * @struct mongory_field_matcher
  * @brief Specialized composite matcher for matching a specific field.
@@ -32,7 +47,13 @@ typedef struct mongory_literal_matcher {
 typedef struct mongory_field_matcher {
   mongory_literal_matcher literal; /**< Base composite matcher structure. */
   char *field;                         /**< Name/index of the field to match. Copied string. */
+  size_t field_len;                    /**< Length of `field`. */
+  uint64_t field_hash;                 /**< `mongory_table_hash_key(field, field_len)`, computed once. */
+  mongory_field_cache_entry cache[MONGORY_FIELD_CACHE_SIZE]; /**< Inline cache for shaped tables. */
+  size_t cache_next;                   /**< Entry replaced by the next cache miss. */
+  size_t cache_epoch;                  /**< `mongory_shape_epoch` the cache was filled under. */
 } mongory_field_matcher;
+
 /**
  * @brief Creates a "field" matcher.
  *
@@ -94,4 +115,33 @@ mongory_matcher *mongory_matcher_size_new(mongory_memory_pool *pool, mongory_val
  */
 mongory_matcher *mongory_matcher_literal_new(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx);
 
+/**
+ * @brief Returns the array record matcher of a literal matcher, creating it on
+ * first use.
+ *
+ * The array record matcher handles array values (implicit element matching,
+ * whole-array equality) for the literal's condition.
+ *
+ * @param literal The literal matcher (field, $not or $size).
+ * @return The array record matcher, or NULL on failure.
+ */
+mongory_matcher *mongory_matcher_literal_array_record(mongory_literal_matcher *literal);
+
+/**
+ * @brief Extracts the value addressed by a field matcher from a table or
+ * array.
+ *
+ * Tables are looked up by key, arrays by (possibly negative) integer index.
+ * Pointer values are shallow-converted with the configured value converter.
+ * A missing table key is a successful lookup yielding NULL, since conditions
+ * such as `$exists: false` must still be evaluated against it.
+ *
+ * @param matcher The field matcher.
+ * @param value The table or array to extract the field from.
+ * @param out Receives the extracted value (may be NULL).
+ * @return False if `value` cannot hold the field (NULL, not a container, or an
+ * invalid/out of bounds index), true otherwise.
+ */
+bool mongory_matcher_field_lookup(mongory_matcher *matcher, mongory_value *value, mongory_value **out);
+
 #endif /* MONGORY_MATCHER_LITERAL_H */
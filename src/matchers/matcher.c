@@ -11,6 +11,7 @@
 #include "../foundations/utils.h"           // For mongory_string_cpyf
 // Required internal headers for delegation
 #include "../foundations/config_private.h" // Potentially for global settings
+#include "../foundations/memory_pool_private.h" // For mongory_memory_pool_scratch
 #include "base_matcher.h"                  // For mongory_matcher_base_new if used directly
 #include "composite_matcher.h"             // For mongory_matcher_table_cond_new
 #include "literal_matcher.h"               // Potentially for other default constructions
@@ -58,11 +59,111 @@ mongory_matcher *mongory_matcher_new(mongory_memory_pool *pool, mongory_value *c
  * the internal matching functions (e.g., from a compare_matcher or
  * composite_matcher).
  *
+ * The outermost call on a thread runs in a scratch region of the thread's
+ * scratch pool, which it rewinds before returning, so temporary values made
+ * while matching do not accumulate in the matcher's or the record's pool.
+ *
  * @param matcher The matcher to use.
  * @param value The value to check against the matcher's condition.
  * @return True if the value satisfies the matcher's condition, false otherwise.
  */
-bool mongory_matcher_match(mongory_matcher *matcher, mongory_value *value) { return matcher->match(matcher, value); }
+bool mongory_matcher_match(mongory_matcher *matcher, mongory_value *value) {
+  if (mongory_matcher_scratch_current != NULL) {
+    return mongory_matcher_dispatch(matcher, value); // The outer call owns the region.
+  }
+  mongory_memory_pool *scratch = mongory_memory_pool_scratch();
+  if (scratch == NULL) {
+    return mongory_matcher_dispatch(matcher, value);
+  }
+  mongory_memory_pool_mark mark = scratch->mark(scratch);
+  mongory_matcher_scratch_current = scratch;
+  bool matched = mongory_matcher_dispatch(matcher, value);
+  mongory_matcher_scratch_current = NULL;
+  scratch->rewind(scratch, mark);
+  return matched;
+}
+
+/**
+ * @brief Traversal callback building the lazily created parts of a matcher
+ * and marking it read-only.
+ *
+ * The literal traversal only descends into the array record matcher once it
+ * exists, so the delegate branch of a literal matcher is frozen from here.
+ */
+static bool mongory_matcher_freeze_cb(mongory_matcher *matcher, mongory_matcher_traverse_context *ctx) {
+  if (matcher->frozen)
+    return true;
+  if (matcher->traverse == mongory_matcher_literal_traverse) {
+    mongory_literal_matcher *literal = (mongory_literal_matcher *)matcher;
+    if (mongory_matcher_literal_array_record(literal) == NULL)
+      return false;
+    mongory_matcher *delegate = literal->delegate_matcher;
+    if (!MONGORY_VALIDATE_PTR(ctx->pool, delegate) || !delegate->traverse(delegate, ctx))
+      return false;
+  }
+  matcher->frozen = true;
+  return true;
+}
+
+/**
+ * @brief Freezes a matcher tree.
+ *
+ * Every sub-matcher that would otherwise be created on first use is built
+ * now, then every node is marked frozen. Matching a frozen tree never writes
+ * to it or allocates from its pool.
+ *
+ * @param matcher The matcher to freeze.
+ * @return True on success, false if a sub-matcher could not be built (the
+ * error is set on the matcher's pool).
+ */
+bool mongory_matcher_freeze(mongory_matcher *matcher) {
+  if (matcher == NULL)
+    return false;
+  if (matcher->frozen)
+    return true;
+  mongory_matcher_traverse_context ctx = {
+      .pool = matcher->pool,
+      .level = 0,
+      .count = 0,
+      .total = 0,
+      .acc = NULL,
+      .callback = mongory_matcher_freeze_cb,
+  };
+  return matcher->traverse(matcher, &ctx);
+}
+
+/**
+ * @brief Executes the batch matching logic for the given matcher.
+ *
+ * Starts from a selection holding every row and lets the matcher tree narrow
+ * it down. Scratch memory for the batch (gathered field columns, pending row
+ * lists) comes from a temporary pool released before returning.
+ *
+ * @param matcher The matcher to use.
+ * @param values The values to check.
+ * @param count The number of values.
+ * @param selection Receives the indexes of the matching values.
+ * @return The number of matching values.
+ */
+size_t mongory_matcher_match_batch(mongory_matcher *matcher, mongory_value **values, size_t count, size_t *selection) {
+  if (count == 0)
+    return 0;
+  mongory_memory_pool *temp_pool = mongory_memory_pool_new();
+  if (temp_pool == NULL) {
+    matcher->pool->error = &MONGORY_ALLOC_ERROR;
+    return 0;
+  }
+  for (size_t i = 0; i < count; i++) {
+    selection[i] = i;
+  }
+  size_t matched = matcher->match_batch(matcher, values, selection, count, temp_pool);
+  if (temp_pool->error != NULL) {
+    matcher->pool->error = &MONGORY_ALLOC_ERROR;
+    matched = 0;
+  }
+  temp_pool->free(temp_pool);
+  return matched;
+}
 
 static bool mongory_matcher_explain_cb(mongory_matcher *matcher, mongory_matcher_traverse_context *ctx) {
   MONGORY_VALIDATE_PTR(ctx->pool, matcher) && MONGORY_VALIDATE_PTR(ctx->pool, matcher->explain);
@@ -74,27 +175,47 @@ static bool mongory_matcher_explain_cb(mongory_matcher *matcher, mongory_matcher
 }
 
 /**
- * @brief Generates a human-readable explanation of the matcher's criteria.
+ * @brief Writes a human-readable explanation of the matcher's criteria to a
+ * sink.
  *
  * This function is a polymorphic wrapper around the `explain` function pointer,
  * allowing different matcher types to provide their own specific explanations.
  *
  * @param matcher The matcher to explain.
- * @param temp_pool A temporary memory pool for allocating the explanation string(s).
+ * @param sink The sink to write the explanation to.
+ * @param temp_pool A temporary memory pool for the tree prefixes, also used as
+ * the sink's scratch pool if it has none.
  */
-void mongory_matcher_explain(mongory_matcher *matcher, mongory_memory_pool *temp_pool) {
-  MONGORY_VALIDATE_PTR(temp_pool, matcher) && MONGORY_VALIDATE_PTR(temp_pool, matcher->traverse);
+void mongory_matcher_explain_to_sink(mongory_matcher *matcher, mongory_sink *sink, mongory_memory_pool *temp_pool) {
+  MONGORY_VALIDATE_PTR(temp_pool, matcher) && MONGORY_VALIDATE_PTR(temp_pool, matcher->traverse) &&
+      MONGORY_VALIDATE_PTR(temp_pool, sink);
   if (temp_pool->error != NULL) {
     return;
   }
+  mongory_memory_pool *scratch_pool = sink->pool;
+  if (scratch_pool == NULL)
+    sink->pool = temp_pool;
   mongory_matcher_traverse_context ctx = {
       .pool = temp_pool,
       .count = 0,
       .total = 0,
       .acc = "",
+      .sink = sink,
       .callback = mongory_matcher_explain_cb,
   };
   matcher->traverse(matcher, &ctx);
+  sink->pool = scratch_pool;
+}
+
+/**
+ * @brief Prints the explanation of a matcher to stdout.
+ * @param matcher The matcher to explain.
+ * @param temp_pool A temporary memory pool for the explanation.
+ */
+void mongory_matcher_explain(mongory_matcher *matcher, mongory_memory_pool *temp_pool) {
+  mongory_sink sink;
+  mongory_sink_file_init(&sink, stdout);
+  mongory_matcher_explain_to_sink(matcher, &sink, temp_pool);
 }
 
 typedef struct mongory_matcher_traced_match_context {
@@ -102,14 +223,19 @@ typedef struct mongory_matcher_traced_match_context {
   int level;
 } mongory_matcher_traced_match_context;
 
-static bool mongory_matcher_traced_match(mongory_matcher *matcher, mongory_value *value) {
-  bool matched = matcher->original_match(matcher, value);
-  mongory_array *trace_stack = matcher->trace_stack;
+MONGORY_THREAD_LOCAL mongory_matcher_trace_overlay *mongory_matcher_trace_current = NULL;
+MONGORY_THREAD_LOCAL mongory_memory_pool *mongory_matcher_scratch_current = NULL;
+
+bool mongory_matcher_traced_match(mongory_matcher *matcher, mongory_value *value) {
+  mongory_matcher_trace_overlay *overlay = mongory_matcher_trace_current;
+  int level = overlay->level++;
+  bool matched = matcher->match(matcher, value);
+  overlay->level = level;
+  mongory_array *trace_stack = overlay->trace_stack;
   mongory_memory_pool *pool = trace_stack->pool;
   mongory_value *condition = matcher->condition;
-  MONGORY_VALIDATE_PTR(pool, condition) && MONGORY_VALIDATE_PTR(pool, condition->to_str);
+  MONGORY_VALIDATE_PTR(pool, condition);
   MONGORY_VALIDATE_PTR(pool, matcher->name);
-  value && MONGORY_VALIDATE_PTR(pool, value->to_str);
   if (pool->error != NULL) {
     return false;
   }
@@ -119,44 +245,39 @@ static bool mongory_matcher_traced_match(mongory_matcher *matcher, mongory_value
   } else {
     res = matched ? "Matched" : "Dismatch";
   }
-  char *name = matcher->name;
-  char *cdtn = condition->to_str(condition, pool);
-  char *rcd = value == NULL ? "Nothing" : value->to_str(value, pool);
-  char *message;
-
-  if (strcmp(name, "Field") == 0) {
+  mongory_string_buffer *message = mongory_string_buffer_new(pool);
+  mongory_sink sink;
+  mongory_sink_string_buffer_init(&sink, message);
+  mongory_sink_puts(&sink, matcher->name);
+  mongory_sink_write(&sink, ": ", 2);
+  mongory_sink_puts(&sink, res);
+  if (strcmp(matcher->name, "Field") == 0) {
     mongory_field_matcher *field_matcher = (mongory_field_matcher *)matcher;
     if (!MONGORY_VALIDATE_PTR(pool, field_matcher->field)) {
       return false;
     }
-    char *fd = field_matcher->field;
-    message = mongory_string_cpyf(pool, "%s: %s, field: \"%s\", condition: %s, record: %s\n", name, res, fd, cdtn, rcd);
+    mongory_sink_puts(&sink, ", field: \"");
+    mongory_sink_puts(&sink, field_matcher->field);
+    mongory_sink_write(&sink, "\"", 1);
+  }
+  mongory_sink_puts(&sink, ", condition: ");
+  mongory_value_serialize(condition, &sink);
+  mongory_sink_puts(&sink, ", record: ");
+  if (value == NULL) {
+    mongory_sink_puts(&sink, "Nothing");
   } else {
-    message = mongory_string_cpyf(pool, "%s: %s, condition: %s, record: %s\n", name, res, cdtn, rcd);
+    mongory_value_serialize(value, &sink);
   }
+  mongory_sink_write(&sink, "\n", 1);
 
   mongory_matcher_traced_match_context *trace_result = MG_ALLOC_PTR(pool, mongory_matcher_traced_match_context);
-  trace_result->message = message;
-  trace_result->level = matcher->trace_level;
+  trace_result->message = mongory_string_buffer_cstr(message);
+  trace_result->level = level;
   trace_stack->push(trace_stack, mongory_value_wrap_ptr(pool, (void *)trace_result));
 
   return matched;
 }
 
-static bool mongory_matcher_enable_trace_cb(mongory_matcher *matcher, mongory_matcher_traverse_context *ctx) {
-  matcher->trace_stack = (mongory_array *)ctx->acc;
-  matcher->trace_level = ctx->level;
-  matcher->match = mongory_matcher_traced_match;
-  return true;
-}
-
-static bool mongory_matcher_disable_trace_cb(mongory_matcher *matcher, mongory_matcher_traverse_context *ctx) {
-  (void)ctx;
-  matcher->match = matcher->original_match;
-  matcher->trace_stack = NULL;
-  return true;
-}
-
 static mongory_array *mongory_matcher_traces_sort(mongory_array *self, int level) {
   mongory_memory_pool *pool = self->pool;
   MONGORY_VALIDATE_PTR(pool, self) && MONGORY_VALIDATE_PTR(pool, self->get);
@@ -193,59 +314,63 @@ static mongory_array *mongory_matcher_traces_sort(mongory_array *self, int level
 }
 
 void mongory_matcher_enable_trace(mongory_matcher *matcher, mongory_memory_pool *temp_pool) {
-  MONGORY_VALIDATE_PTR(temp_pool, matcher) && MONGORY_VALIDATE_PTR(temp_pool, matcher->traverse);
+  MONGORY_VALIDATE_PTR(temp_pool, matcher);
   if (temp_pool->error != NULL) {
     return;
   }
+  mongory_matcher_trace_overlay *overlay = MG_ALLOC_PTR(temp_pool, mongory_matcher_trace_overlay);
   mongory_array *trace_stack = mongory_array_new(temp_pool);
-  mongory_matcher_traverse_context ctx = {
-      .pool = temp_pool,
-      .level = 0,
-      .count = 0,
-      .total = 0,
-      .acc = (void *)trace_stack,
-      .callback = mongory_matcher_enable_trace_cb,
-  };
-  matcher->traverse(matcher, &ctx);
+  if (overlay == NULL || trace_stack == NULL) {
+    temp_pool->error = &MONGORY_ALLOC_ERROR;
+    return;
+  }
+  overlay->root = matcher;
+  overlay->trace_stack = trace_stack;
+  overlay->level = 0;
+  mongory_matcher_trace_current = overlay;
 }
 
 void mongory_matcher_disable_trace(mongory_matcher *matcher) {
-  MONGORY_VALIDATE_PTR(matcher->pool, matcher) && MONGORY_VALIDATE_PTR(matcher->pool, matcher->traverse);
-  if (matcher->pool->error != NULL) {
-    return;
+  mongory_matcher_trace_overlay *overlay = mongory_matcher_trace_current;
+  if (overlay != NULL && overlay->root == matcher) {
+    mongory_matcher_trace_current = NULL;
   }
-  mongory_matcher_traverse_context ctx = {
-      .level = 0,
-      .count = 0,
-      .total = 0,
-      .callback = mongory_matcher_disable_trace_cb,
-  };
-  matcher->traverse(matcher, &ctx);
 }
 
-void mongory_matcher_print_trace(mongory_matcher *matcher) {
-  if (matcher->trace_stack == NULL)
+void mongory_matcher_print_trace_to_sink(mongory_matcher *matcher, mongory_sink *sink) {
+  static const char spaces[] = "                ";
+  mongory_matcher_trace_overlay *overlay = mongory_matcher_trace_current;
+  if (overlay == NULL || overlay->root != matcher)
+    return;
+  mongory_array *sorted_trace_stack = mongory_matcher_traces_sort(overlay->trace_stack, 0);
+  if (sorted_trace_stack == NULL)
     return;
-  mongory_array *sorted_trace_stack = mongory_matcher_traces_sort(matcher->trace_stack, 0);
   int total = (int)sorted_trace_stack->count;
   for (int i = 0; i < total; i++) {
     mongory_value *item = sorted_trace_stack->get(sorted_trace_stack, i);
     mongory_matcher_traced_match_context *trace = (mongory_matcher_traced_match_context *)item->data.ptr;
-    int indent_size = trace->level * 2;
-    char *indent = MG_ALLOC(sorted_trace_stack->pool, indent_size + 1);
-    memset(indent, ' ', indent_size);
-    indent[indent_size] = '\0';
-    printf("%s%s", indent, trace->message);
+    size_t indent_size = (size_t)trace->level * 2;
+    for (; indent_size > sizeof(spaces) - 1; indent_size -= sizeof(spaces) - 1)
+      mongory_sink_write(sink, spaces, sizeof(spaces) - 1);
+    mongory_sink_write(sink, spaces, indent_size);
+    mongory_sink_puts(sink, trace->message);
   }
 }
 
+void mongory_matcher_print_trace(mongory_matcher *matcher) {
+  mongory_sink sink;
+  mongory_sink_file_init(&sink, stdout);
+  mongory_matcher_print_trace_to_sink(matcher, &sink);
+}
+
 bool mongory_matcher_trace(mongory_matcher *matcher, mongory_value *value) {
-  MONGORY_VALIDATE_PTR(value->pool, matcher) && MONGORY_VALIDATE_PTR(value->pool, matcher->match);
-  if (value->pool->error != NULL) {
+  mongory_memory_pool *pool = MONGORY_VALUE_POOL(value, matcher->pool);
+  MONGORY_VALIDATE_PTR(pool, matcher) && MONGORY_VALIDATE_PTR(pool, matcher->match);
+  if (pool->error != NULL) {
     return false;
   }
-  mongory_matcher_enable_trace(matcher, value->pool);
-  bool matched = matcher->match(matcher, value);
+  mongory_matcher_enable_trace(matcher, pool);
+  bool matched = mongory_matcher_dispatch(matcher, value);
   mongory_matcher_print_trace(matcher);
   mongory_matcher_disable_trace(matcher);
   return matched;
@@ -0,0 +1,178 @@
+#ifndef MONGORY_MATCHER_COMPILABLE_C
+#define MONGORY_MATCHER_COMPILABLE_C
+
+#include "matcher_compilable.h"
+#include "base_matcher.h"
+#include "composite_matcher.h"
+#include "literal_matcher.h"
+#include "program_private.h"
+
+static inline bool mongory_matcher_emit_operand(mongory_program *program, mongory_opcode op, mongory_matcher *matcher) {
+  size_t index = mongory_program_emit(program, op);
+  if (index == MONGORY_PROGRAM_INVALID_INDEX)
+    return false;
+  program->code[index].operand.matcher = matcher;
+  return true;
+}
+
+static inline bool mongory_matcher_emit_compare(mongory_program *program, mongory_opcode op, mongory_matcher *matcher) {
+  size_t index = mongory_program_emit(program, op);
+  if (index == MONGORY_PROGRAM_INVALID_INDEX)
+    return false;
+  program->code[index].operand.condition = matcher->condition;
+  return true;
+}
+
+bool mongory_matcher_leaf_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_emit_operand(program, MONGORY_OP_CALL, matcher);
+}
+
+bool mongory_matcher_always_true_compile(mongory_matcher *matcher, mongory_program *program) {
+  (void)matcher;
+  return mongory_program_emit(program, MONGORY_OP_TRUE) != MONGORY_PROGRAM_INVALID_INDEX;
+}
+
+bool mongory_matcher_always_false_compile(mongory_matcher *matcher, mongory_program *program) {
+  (void)matcher;
+  return mongory_program_emit(program, MONGORY_OP_FALSE) != MONGORY_PROGRAM_INVALID_INDEX;
+}
+
+/**
+ * @brief Lowers the children of a composite matcher into a short-circuit
+ * sequence. Every child but the last is followed by `exit_op`, jumping past
+ * the sequence with the accumulator that decided the result.
+ *
+ * Pending exits are chained through their (not yet meaningful) `jump` fields
+ * and patched once the end of the sequence is known.
+ */
+static bool mongory_matcher_children_compile(mongory_matcher *matcher, mongory_program *program, mongory_opcode exit_op,
+                                             mongory_opcode empty_op) {
+  mongory_array *children = ((mongory_composite_matcher *)matcher)->children;
+  size_t total = children->count;
+  if (total == 0)
+    return mongory_program_emit(program, empty_op) != MONGORY_PROGRAM_INVALID_INDEX;
+
+  size_t pending = MONGORY_PROGRAM_INVALID_INDEX;
+  for (size_t i = 0; i < total; i++) {
+    mongory_matcher *child = (mongory_matcher *)children->get(children, i);
+    if (!mongory_program_compile_matcher(program, child))
+      return false;
+    if (i + 1 == total)
+      break;
+    size_t exit = mongory_program_emit(program, exit_op);
+    if (exit == MONGORY_PROGRAM_INVALID_INDEX)
+      return false;
+    program->code[exit].jump = pending;
+    pending = exit;
+  }
+  while (pending != MONGORY_PROGRAM_INVALID_INDEX) {
+    size_t previous = program->code[pending].jump;
+    mongory_program_patch(program, pending);
+    pending = previous;
+  }
+  return true;
+}
+
+bool mongory_matcher_and_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_children_compile(matcher, program, MONGORY_OP_JUMP_IF_FALSE, MONGORY_OP_TRUE);
+}
+
+bool mongory_matcher_or_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_children_compile(matcher, program, MONGORY_OP_JUMP_IF_TRUE, MONGORY_OP_FALSE);
+}
+
+static inline bool mongory_matcher_loop_compile(mongory_matcher *matcher, mongory_program *program, mongory_opcode op) {
+  size_t loop = mongory_program_emit(program, op);
+  if (loop == MONGORY_PROGRAM_INVALID_INDEX)
+    return false;
+  if (!mongory_matcher_and_compile(matcher, program))
+    return false;
+  mongory_program_patch(program, loop);
+  return true;
+}
+
+bool mongory_matcher_elem_match_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_loop_compile(matcher, program, MONGORY_OP_ELEM_MATCH);
+}
+
+bool mongory_matcher_every_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_loop_compile(matcher, program, MONGORY_OP_EVERY);
+}
+
+/**
+ * @brief Lowers the body shared by literal matchers: array subjects go to the
+ * array record matcher, everything else to the delegate matcher.
+ */
+static bool mongory_matcher_literal_body_compile(mongory_matcher *matcher, mongory_program *program) {
+  mongory_literal_matcher *literal = (mongory_literal_matcher *)matcher;
+  mongory_matcher *array_record_matcher = mongory_matcher_literal_array_record(literal);
+  if (array_record_matcher == NULL || literal->delegate_matcher == NULL)
+    return false;
+
+  size_t to_array = mongory_program_emit(program, MONGORY_OP_JUMP_IF_ARRAY);
+  if (to_array == MONGORY_PROGRAM_INVALID_INDEX || !mongory_program_compile_matcher(program, literal->delegate_matcher))
+    return false;
+  size_t to_end = mongory_program_emit(program, MONGORY_OP_JUMP);
+  if (to_end == MONGORY_PROGRAM_INVALID_INDEX)
+    return false;
+  mongory_program_patch(program, to_array);
+  if (!mongory_program_compile_matcher(program, array_record_matcher))
+    return false;
+  mongory_program_patch(program, to_end);
+  return true;
+}
+
+bool mongory_matcher_field_compile(mongory_matcher *matcher, mongory_program *program) {
+  if (program->depth >= MONGORY_PROGRAM_MAX_DEPTH) {
+    mongory_error *error = MG_ALLOC_PTR(program->pool, mongory_error);
+    if (error) {
+      error->type = MONGORY_ERROR_UNSUPPORTED_OPERATION;
+      error->message = "Field nesting is too deep to compile.";
+    }
+    program->pool->error = error ? error : &MONGORY_ALLOC_ERROR;
+    return false;
+  }
+  size_t load = mongory_program_emit(program, MONGORY_OP_LOAD_FIELD);
+  if (load == MONGORY_PROGRAM_INVALID_INDEX)
+    return false;
+  program->code[load].operand.matcher = matcher;
+  program->depth++;
+  bool compiled = mongory_matcher_literal_body_compile(matcher, program);
+  program->depth--;
+  if (!compiled || mongory_program_emit(program, MONGORY_OP_POP) == MONGORY_PROGRAM_INVALID_INDEX)
+    return false;
+  mongory_program_patch(program, load);
+  return true;
+}
+
+bool mongory_matcher_not_compile(mongory_matcher *matcher, mongory_program *program) {
+  if (!mongory_matcher_literal_body_compile(matcher, program))
+    return false;
+  return mongory_program_emit(program, MONGORY_OP_NOT) != MONGORY_PROGRAM_INVALID_INDEX;
+}
+
+bool mongory_matcher_equal_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_emit_compare(program, MONGORY_OP_EQ, matcher);
+}
+
+bool mongory_matcher_not_equal_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_emit_compare(program, MONGORY_OP_NE, matcher);
+}
+
+bool mongory_matcher_greater_than_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_emit_compare(program, MONGORY_OP_GT, matcher);
+}
+
+bool mongory_matcher_greater_than_or_equal_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_emit_compare(program, MONGORY_OP_GTE, matcher);
+}
+
+bool mongory_matcher_less_than_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_emit_compare(program, MONGORY_OP_LT, matcher);
+}
+
+bool mongory_matcher_less_than_or_equal_compile(mongory_matcher *matcher, mongory_program *program) {
+  return mongory_matcher_emit_compare(program, MONGORY_OP_LTE, matcher);
+}
+
+#endif /* MONGORY_MATCHER_COMPILABLE_C */
@@ -0,0 +1,47 @@
+#ifndef MONGORY_MATCHER_COMPILABLE_H
+#define MONGORY_MATCHER_COMPILABLE_H
+
+#include "mongory-core/matchers/matcher.h"
+#include "mongory-core/matchers/program.h"
+#include <stdbool.h>
+
+/**
+ * @brief Function pointer type for lowering a matcher into program
+ * instructions.
+ * @param matcher The matcher to lower.
+ * @param program The program receiving the instructions.
+ * @return True on success, false on failure.
+ */
+typedef bool (*mongory_matcher_compile_func)(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_leaf_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_always_true_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_always_false_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_and_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_or_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_elem_match_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_every_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_field_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_not_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_equal_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_not_equal_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_greater_than_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_greater_than_or_equal_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_less_than_compile(mongory_matcher *matcher, mongory_program *program);
+
+bool mongory_matcher_less_than_or_equal_compile(mongory_matcher *matcher, mongory_program *program);
+
+#endif /* MONGORY_MATCHER_COMPILABLE_H */
@@ -7,23 +7,19 @@
 #include "composite_matcher.h"
 #include "literal_matcher.h"
 #include "../foundations/utils.h"
-#include <stdio.h>
 
-char *mongory_matcher_title(mongory_matcher *matcher, mongory_memory_pool *pool) {
-  mongory_value *condition = matcher->condition;
-  return mongory_string_cpyf(pool, "%s: %s",
-    matcher->name,
-    condition->to_str(condition, pool)
-  );
+static void mongory_matcher_write_title(mongory_matcher *matcher, mongory_sink *sink) {
+  mongory_sink_puts(sink, matcher->name);
+  mongory_sink_write(sink, ": ", 2);
+  mongory_value_serialize(matcher->condition, sink);
 }
 
-char *mongory_matcher_title_with_field(mongory_matcher *matcher, mongory_memory_pool *pool) {
+static void mongory_matcher_write_title_with_field(mongory_matcher *matcher, mongory_sink *sink) {
   mongory_field_matcher *field_matcher = (mongory_field_matcher *)matcher;
-  mongory_value *condition = matcher->condition;
-  return mongory_string_cpyf(pool, "Field: \"%s\", to match: %s",
-    field_matcher->field,
-    condition->to_str(condition, pool)
-  );
+  mongory_sink_puts(sink, "Field: \"");
+  mongory_sink_puts(sink, field_matcher->field);
+  mongory_sink_puts(sink, "\", to match: ");
+  mongory_value_serialize(matcher->condition, sink);
 }
 
 static inline char *mongory_matcher_tail_connection(int count, int total) {
@@ -47,10 +43,11 @@ static inline char *mongory_matcher_indent_connection(int count, int total) {
 }
 
 bool mongory_matcher_base_explain(mongory_matcher *matcher, mongory_matcher_traverse_context *ctx) {
-  char *connection = mongory_matcher_tail_connection(ctx->count, ctx->total);
-  char *title = mongory_matcher_title(matcher, ctx->pool);
-  char *prefix = (char *)ctx->acc;
-  printf("%s%s%s\n", prefix, connection, title);
+  mongory_sink *sink = ctx->sink;
+  mongory_sink_puts(sink, (char *)ctx->acc);
+  mongory_sink_puts(sink, mongory_matcher_tail_connection(ctx->count, ctx->total));
+  mongory_matcher_write_title(matcher, sink);
+  mongory_sink_write(sink, "\n", 1);
   return true;
 }
 
@@ -67,10 +64,12 @@ bool mongory_matcher_literal_explain(mongory_matcher *matcher, mongory_matcher_t
 }
 
 bool mongory_matcher_field_explain(mongory_matcher *matcher, mongory_matcher_traverse_context *ctx) {
-  char *tail_connection = mongory_matcher_tail_connection(ctx->count, ctx->total);
-  char *title = mongory_matcher_title_with_field(matcher, ctx->pool);
+  mongory_sink *sink = ctx->sink;
   char *prefix = (char *)ctx->acc;
-  printf("%s%s%s\n", prefix, tail_connection, title);
+  mongory_sink_puts(sink, prefix);
+  mongory_sink_puts(sink, mongory_matcher_tail_connection(ctx->count, ctx->total));
+  mongory_matcher_write_title_with_field(matcher, sink);
+  mongory_sink_write(sink, "\n", 1);
   char *indent = mongory_matcher_indent_connection(ctx->count, ctx->total);
   ctx->acc = mongory_string_cpyf(ctx->pool, "%s%s", prefix, indent);
   return true;
@@ -0,0 +1,123 @@
+/**
+ * @file matcher_parallel.c
+ * @brief Implements `mongory_matcher_filter_parallel`, filtering a collection
+ * on several threads. This is an internal implementation file for the matcher
+ * module.
+ *
+ * The collection is cut into fixed-size chunks which are distributed by the
+ * work-stealing executor. A worker runs the matcher's batch path over a chunk
+ * with its own scratch pool and records the matching row indexes in the
+ * chunk's slot of a shared selection buffer. The matcher is frozen first, so
+ * the workers only ever read it. Results are gathered in chunk order
+ * afterwards, so the output order never depends on scheduling.
+ */
+#include "../foundations/executor.h"
+#include "base_matcher.h"
+#include <mongory-core.h>
+
+/**
+ * @brief Number of records evaluated by one task.
+ */
+#define MONGORY_FILTER_CHUNK_SIZE 1024
+
+/**
+ * @brief State shared by the tasks of one parallel filter.
+ */
+typedef struct mongory_filter_job {
+  mongory_matcher *matcher;     /**< The matcher, only read by the workers. */
+  mongory_value **values;       /**< Snapshot of the collection. */
+  size_t count;                 /**< Number of records. */
+  size_t *selection;            /**< Matching rows, one region per chunk. */
+  size_t *matched;              /**< Number of matching rows per chunk. */
+  mongory_memory_pool **pools;  /**< Scratch pool per worker. */
+} mongory_filter_job;
+
+static bool mongory_matcher_filter_chunk(void *ctx, size_t worker, size_t task) {
+  mongory_filter_job *job = (mongory_filter_job *)ctx;
+  mongory_memory_pool *scratch = job->pools[worker];
+  size_t start = task * MONGORY_FILTER_CHUNK_SIZE;
+  size_t end = start + MONGORY_FILTER_CHUNK_SIZE < job->count ? start + MONGORY_FILTER_CHUNK_SIZE : job->count;
+  size_t *selection = job->selection + start;
+  for (size_t row = start; row < end; row++) {
+    selection[row - start] = row;
+  }
+  mongory_matcher *matcher = job->matcher;
+  mongory_matcher_scratch_current = scratch;
+  job->matched[task] = matcher->match_batch(matcher, job->values, selection, end - start, scratch);
+  mongory_matcher_scratch_current = NULL;
+  if (scratch->error != NULL)
+    return false;
+  scratch->reset(scratch);
+  return true;
+}
+
+bool mongory_matcher_filter_parallel(mongory_matcher *matcher, mongory_array *array, int nthreads, mongory_array *out) {
+  if (!matcher || !array || !out)
+    return false;
+  size_t count = array->count;
+  if (count == 0)
+    return true;
+  size_t chunks = (count + MONGORY_FILTER_CHUNK_SIZE - 1) / MONGORY_FILTER_CHUNK_SIZE;
+  size_t workers = nthreads > 1 ? (size_t)nthreads : 1;
+  if (workers > chunks)
+    workers = chunks;
+
+  mongory_memory_pool *job_pool = mongory_memory_pool_new();
+  if (job_pool == NULL) {
+    out->pool->error = &MONGORY_ALLOC_ERROR;
+    return false;
+  }
+  mongory_filter_job job = {
+      .matcher = matcher,
+      .values = MG_ALLOC_ARY(job_pool, mongory_value *, count),
+      .count = count,
+      .selection = MG_ALLOC_ARY(job_pool, size_t, count),
+      .matched = MG_ALLOC_ARY(job_pool, size_t, chunks),
+      .pools = MG_ALLOC_ARY(job_pool, mongory_memory_pool *, workers),
+  };
+  // Pool memory is not zeroed: only the first `pool_count` entries of
+  // `job.pools` are ever written, and only those are freed.
+  size_t pool_count = 0;
+  bool ok = job.values && job.selection && job.matched && job.pools;
+  while (ok && pool_count < workers) {
+    job.pools[pool_count] = mongory_memory_pool_new();
+    ok = job.pools[pool_count] != NULL;
+    if (ok)
+      pool_count++;
+  }
+
+  if (ok) {
+    // Reading through the array vtable may convert lazily, so the snapshot is
+    // taken on the calling thread.
+    for (size_t i = 0; i < count; i++) {
+      job.values[i] = array->get(array, i);
+    }
+    if (!matcher->frozen) {
+      // Frozen matchers no longer fill their inline caches, so one record is
+      // matched first to warm them for the collection's shape.
+      matcher->match(matcher, job.values[0]);
+    }
+    if (!mongory_matcher_freeze(matcher)) {
+      out->pool->error = matcher->pool->error;
+      ok = false;
+    } else {
+      ok = mongory_executor_run(workers, chunks, mongory_matcher_filter_chunk, &job);
+    }
+  }
+
+  for (size_t chunk = 0; ok && chunk < chunks; chunk++) {
+    size_t *selection = job.selection + chunk * MONGORY_FILTER_CHUNK_SIZE;
+    for (size_t i = 0; ok && i < job.matched[chunk]; i++) {
+      ok = out->push(out, job.values[selection[i]]);
+    }
+  }
+  if (!ok && out->pool->error == NULL) {
+    out->pool->error = &MONGORY_ALLOC_ERROR;
+  }
+
+  for (size_t i = 0; i < pool_count; i++) {
+    job.pools[i]->free(job.pools[i]);
+  }
+  job_pool->free(job_pool);
+  return ok;
+}
@@ -27,6 +27,7 @@ bool mongory_matcher_composite_traverse(mongory_matcher *matcher, mongory_matche
       .count = 0,
       .total = total,
       .acc = ctx->acc,
+      .sink = ctx->sink,
       .callback = ctx->callback,
   };
 
@@ -51,6 +52,7 @@ bool mongory_matcher_literal_traverse(mongory_matcher *matcher, mongory_matcher_
       .count = 0,
       .total = 1,
       .acc = ctx->acc,
+      .sink = ctx->sink,
       .callback = ctx->callback,
   };
   bool result = next_matcher->traverse(next_matcher, &child_ctx);
@@ -11,6 +11,7 @@ struct mongory_matcher_traverse_context {
   int count;
   int total;
   void *acc;
+  mongory_sink *sink; /**< Output of the traversal, if it writes any. */
   mongory_matcher_traverse_func callback;
 } ;
 
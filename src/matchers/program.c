@@ -0,0 +1,211 @@
+/**
+ * @file program.c
+ * @brief Implements compilation of matcher trees into flat programs and the
+ * program interpreter. This is an internal implementation file for the
+ * matcher module.
+ *
+ * Each matcher lowers itself through its `compile` function (see
+ * matcher_compilable.c). Composite matchers become short-circuit jump
+ * sequences, field matchers become LOAD_FIELD/POP pairs around the lowered
+ * condition and comparison matchers become single compare instructions, so
+ * evaluating a document is a single loop over a contiguous array.
+ */
+#include "program_private.h"
+#include "../foundations/array_private.h"
+#include "../foundations/utils.h"
+#include "base_matcher.h"
+#include "literal_matcher.h"
+#include "mongory-core/foundations/array.h"
+#include "mongory-core/foundations/error.h"
+#include <string.h>
+
+#define MONGORY_PROGRAM_INIT_SIZE 16
+
+size_t mongory_program_emit(mongory_program *program, mongory_opcode op) {
+  if (program->count >= program->capacity) {
+    size_t capacity = program->capacity * 2;
+    mongory_instruction *code = MG_ALLOC_ARY(program->pool, mongory_instruction, capacity);
+    if (code == NULL) {
+      program->pool->error = &MONGORY_ALLOC_ERROR;
+      return MONGORY_PROGRAM_INVALID_INDEX;
+    }
+    memcpy(code, program->code, sizeof(mongory_instruction) * program->count);
+    program->code = code;
+    program->capacity = capacity;
+  }
+  size_t index = program->count++;
+  mongory_instruction *instruction = &program->code[index];
+  instruction->op = op;
+  instruction->jump = 0;
+  instruction->operand.matcher = NULL;
+  return index;
+}
+
+void mongory_program_patch(mongory_program *program, size_t index) { program->code[index].jump = program->count; }
+
+bool mongory_program_compile_matcher(mongory_program *program, mongory_matcher *matcher) {
+  if (!MONGORY_VALIDATE_PTR(program->pool, matcher))
+    return false;
+  if (matcher->compile == NULL) {
+    // Matchers without a lowering are evaluated through their match function.
+    return mongory_matcher_leaf_compile(matcher, program);
+  }
+  return matcher->compile(matcher, program);
+}
+
+mongory_program *mongory_program_compile(mongory_memory_pool *pool, mongory_matcher *matcher) {
+  if (!pool || !pool->alloc)
+    return NULL;
+  if (!MONGORY_VALIDATE_PTR(pool, matcher))
+    return NULL;
+
+  mongory_program *program = MG_ALLOC_PTR(pool, mongory_program);
+  mongory_instruction *code = MG_ALLOC_ARY(pool, mongory_instruction, MONGORY_PROGRAM_INIT_SIZE);
+  if (program == NULL || code == NULL) {
+    pool->error = &MONGORY_ALLOC_ERROR;
+    return NULL;
+  }
+  program->pool = pool;
+  program->code = code;
+  program->count = 0;
+  program->capacity = MONGORY_PROGRAM_INIT_SIZE;
+  program->depth = 0;
+
+  if (!mongory_program_compile_matcher(program, matcher) ||
+      mongory_program_emit(program, MONGORY_OP_HALT) == MONGORY_PROGRAM_INVALID_INDEX) {
+    if (pool->error == NULL) {
+      // The failure happened while building sub-matchers in the matcher's pool.
+      pool->error = matcher->pool->error ? matcher->pool->error : &MONGORY_ALLOC_ERROR;
+    }
+    return NULL;
+  }
+  return program;
+}
+
+/**
+ * @brief Evaluates a comparison instruction with the same semantics as the
+ * comparison matchers: incomparable values only satisfy `$ne`.
+ */
+static inline bool mongory_program_compare(mongory_opcode op, mongory_value *value, mongory_value *condition) {
+  if (!value || !condition)
+    return op == MONGORY_OP_NE;
+  if (op == MONGORY_OP_EQ || op == MONGORY_OP_NE)
+    return mongory_value_equal(value, condition) == (op == MONGORY_OP_EQ);
+  int result = mongory_value_compare(value, condition);
+  if (result == mongory_value_compare_fail)
+    return op == MONGORY_OP_NE;
+  switch (op) {
+  case MONGORY_OP_EQ:
+    return result == 0;
+  case MONGORY_OP_NE:
+    return result != 0;
+  case MONGORY_OP_GT:
+    return result == 1;
+  case MONGORY_OP_GTE:
+    return result >= 0;
+  case MONGORY_OP_LT:
+    return result == -1;
+  default:
+    return result <= 0;
+  }
+}
+
+/**
+ * @brief Runs the instructions in [pc, end) against `value`.
+ *
+ * Element loops re-enter the interpreter for their body, so each run only
+ * needs a stack for the field loads of its own range.
+ */
+static bool mongory_program_run(mongory_program *program, size_t pc, size_t end, mongory_value *value) {
+  mongory_instruction *code = program->code;
+  mongory_value *stack[MONGORY_PROGRAM_MAX_DEPTH];
+  size_t sp = 0;
+  bool acc = false;
+
+  while (pc < end) {
+    mongory_instruction *instruction = &code[pc];
+    switch (instruction->op) {
+    case MONGORY_OP_HALT:
+      return acc;
+    case MONGORY_OP_TRUE:
+      acc = true;
+      pc++;
+      break;
+    case MONGORY_OP_FALSE:
+      acc = false;
+      pc++;
+      break;
+    case MONGORY_OP_NOT:
+      acc = !acc;
+      pc++;
+      break;
+    case MONGORY_OP_JUMP:
+      pc = instruction->jump;
+      break;
+    case MONGORY_OP_JUMP_IF_FALSE:
+      pc = acc ? pc + 1 : instruction->jump;
+      break;
+    case MONGORY_OP_JUMP_IF_TRUE:
+      pc = acc ? instruction->jump : pc + 1;
+      break;
+    case MONGORY_OP_JUMP_IF_ARRAY:
+      pc = value != NULL && value->type == MONGORY_TYPE_ARRAY ? instruction->jump : pc + 1;
+      break;
+    case MONGORY_OP_LOAD_FIELD: {
+      mongory_value *field_value = NULL;
+      if (!mongory_matcher_field_lookup(instruction->operand.matcher, value, &field_value)) {
+        acc = false;
+        pc = instruction->jump;
+        break;
+      }
+      stack[sp++] = value;
+      value = field_value;
+      pc++;
+      break;
+    }
+    case MONGORY_OP_POP:
+      value = stack[--sp];
+      pc++;
+      break;
+    case MONGORY_OP_EQ:
+    case MONGORY_OP_NE:
+    case MONGORY_OP_GT:
+    case MONGORY_OP_GTE:
+    case MONGORY_OP_LT:
+    case MONGORY_OP_LTE:
+      acc = mongory_program_compare(instruction->op, value, instruction->operand.condition);
+      pc++;
+      break;
+    case MONGORY_OP_ELEM_MATCH:
+    case MONGORY_OP_EVERY: {
+      bool every = instruction->op == MONGORY_OP_EVERY;
+      acc = false;
+      if (value != NULL && value->type == MONGORY_TYPE_ARRAY && value->data.a->count > 0) {
+        mongory_array *array = value->data.a;
+        size_t total = array->count;
+        mongory_value scratch;
+        acc = every;
+        for (size_t i = 0; i < total; i++) {
+          if (mongory_program_run(program, pc + 1, instruction->jump, mongory_array_peek(array, i, &scratch)) != every) {
+            acc = !every;
+            break;
+          }
+        }
+      }
+      pc = instruction->jump;
+      break;
+    }
+    case MONGORY_OP_CALL: {
+      mongory_matcher *matcher = instruction->operand.matcher;
+      acc = matcher->original_match(matcher, value);
+      pc++;
+      break;
+    }
+    }
+  }
+  return acc;
+}
+
+bool mongory_program_match(mongory_program *program, mongory_value *value) {
+  return mongory_program_run(program, 0, program->count, value);
+}
@@ -0,0 +1,110 @@
+#ifndef MONGORY_PROGRAM_PRIVATE_H
+#define MONGORY_PROGRAM_PRIVATE_H
+
+/**
+ * @file program_private.h
+ * @brief Internal layout of compiled matcher programs and the emitter API used
+ * by the matcher compile functions. This is an internal header for the
+ * matcher module.
+ */
+
+#include "mongory-core/foundations/memory_pool.h"
+#include "mongory-core/foundations/value.h"
+#include "mongory-core/matchers/program.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Maximum nesting of field loads inside a single program.
+ */
+#define MONGORY_PROGRAM_MAX_DEPTH 64
+
+/**
+ * @brief Index returned by `mongory_program_emit` when emission fails.
+ */
+#define MONGORY_PROGRAM_INVALID_INDEX ((size_t)-1)
+
+/**
+ * @brief Operation codes of the program interpreter.
+ *
+ * The interpreter keeps a current value (the subject) and a boolean
+ * accumulator holding the result of the last evaluated instruction.
+ */
+typedef enum mongory_opcode {
+  MONGORY_OP_HALT,          /**< Stops evaluation; the accumulator is the result. */
+  MONGORY_OP_TRUE,          /**< Sets the accumulator to true. */
+  MONGORY_OP_FALSE,         /**< Sets the accumulator to false. */
+  MONGORY_OP_NOT,           /**< Negates the accumulator. */
+  MONGORY_OP_JUMP,          /**< Jumps unconditionally. */
+  MONGORY_OP_JUMP_IF_FALSE, /**< Jumps when the accumulator is false. */
+  MONGORY_OP_JUMP_IF_TRUE,  /**< Jumps when the accumulator is true. */
+  MONGORY_OP_JUMP_IF_ARRAY, /**< Jumps when the subject is an array. */
+  MONGORY_OP_LOAD_FIELD,    /**< Pushes the subject and loads a field of it;
+                                 jumps with a false accumulator when the subject
+                                 has no such field slot. */
+  MONGORY_OP_POP,           /**< Restores the subject saved by LOAD_FIELD. */
+  MONGORY_OP_EQ,            /**< Compares the subject with a condition. */
+  MONGORY_OP_NE,
+  MONGORY_OP_GT,
+  MONGORY_OP_GTE,
+  MONGORY_OP_LT,
+  MONGORY_OP_LTE,
+  MONGORY_OP_ELEM_MATCH,    /**< Runs the body up to `jump` on each element
+                                 until one matches. */
+  MONGORY_OP_EVERY,         /**< Runs the body up to `jump` on each element
+                                 until one fails. */
+  MONGORY_OP_CALL,          /**< Delegates to a matcher's match function. */
+} mongory_opcode;
+
+/**
+ * @struct mongory_instruction
+ * @brief A single program instruction.
+ */
+typedef struct mongory_instruction {
+  mongory_opcode op; /**< Operation code. */
+  size_t jump;       /**< Jump target (instruction index) for branching ops. */
+  union {
+    mongory_matcher *matcher;  /**< Field matcher (LOAD_FIELD) or callee (CALL). */
+    mongory_value *condition;  /**< Comparison operand (EQ..LTE). */
+  } operand;
+} mongory_instruction;
+
+/**
+ * @struct mongory_program
+ * @brief A compiled matcher tree.
+ */
+struct mongory_program {
+  mongory_memory_pool *pool;  /**< Pool owning the instruction stream. */
+  mongory_instruction *code;  /**< Contiguous instruction stream. */
+  size_t count;               /**< Number of emitted instructions. */
+  size_t capacity;            /**< Capacity of `code`. */
+  size_t depth;               /**< Current field nesting while compiling. */
+};
+
+/**
+ * @brief Appends an instruction to the program.
+ * @param program The program being compiled.
+ * @param op The operation code.
+ * @return The index of the emitted instruction, or
+ * `MONGORY_PROGRAM_INVALID_INDEX` on allocation failure.
+ */
+size_t mongory_program_emit(mongory_program *program, mongory_opcode op);
+
+/**
+ * @brief Points the jump of a previously emitted instruction at the next
+ * instruction to be emitted.
+ * @param program The program being compiled.
+ * @param index The instruction to patch.
+ */
+void mongory_program_patch(mongory_program *program, size_t index);
+
+/**
+ * @brief Compiles a sub-matcher into the program through its `compile`
+ * function.
+ * @param program The program being compiled.
+ * @param matcher The sub-matcher.
+ * @return True on success, false on failure.
+ */
+bool mongory_program_compile_matcher(mongory_program *program, mongory_matcher *matcher);
+
+#endif /* MONGORY_PROGRAM_PRIVATE_H */
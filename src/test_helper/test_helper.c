@@ -16,9 +16,46 @@
 
 static mongory_memory_pool *test_pool = NULL;
 
+static inline int hex_digit(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+/**
+ * Converts the Extended JSON wrappers `{"$date": <epoch milliseconds>}` and
+ * `{"$oid": "<24 hex digits>"}` into datetime and binary values. Returns NULL
+ * for any other object.
+ */
+static inline mongory_value *cjson_to_mongory_extended_value(mongory_memory_pool *pool, cJSON *root) {
+  cJSON *item = root->child;
+  if (item == NULL || item->next != NULL || item->string == NULL)
+    return NULL;
+  if (strcmp(item->string, "$date") == 0 && item->type == cJSON_Number) {
+    return mongory_value_wrap_datetime(pool, (int64_t)item->valuedouble * 1000000);
+  }
+  if (strcmp(item->string, "$oid") == 0 && item->type == cJSON_String && strlen(item->valuestring) == 24) {
+    unsigned char oid[12];
+    for (int i = 0; i < 12; i++) {
+      int high = hex_digit(item->valuestring[i * 2]);
+      int low = hex_digit(item->valuestring[i * 2 + 1]);
+      if (high < 0 || low < 0)
+        return NULL;
+      oid[i] = (unsigned char)(high << 4 | low);
+    }
+    return mongory_value_wrap_binary(pool, oid, sizeof(oid));
+  }
+  return NULL;
+}
+
 static inline mongory_value *
 cjson_to_mongory_value_convert_recursive(mongory_memory_pool *pool, cJSON *root,
-                                         mongory_value *(*convert_func)(mongory_memory_pool *pool, cJSON *root)) {
+                                         mongory_value *(*convert_func)(mongory_memory_pool *pool, cJSON *root),
+                                         bool borrow_strings) {
   if (!root) {
     return NULL;
   }
@@ -26,41 +63,58 @@ cjson_to_mongory_value_convert_recursive(mongory_memory_pool *pool, cJSON *root,
   mongory_value *value = NULL;
   mongory_array *array = NULL;
   mongory_table *table = NULL;
+  size_t child_count = 0;
 
   switch (root->type) {
   case cJSON_Array:
+    for (cJSON *item = root->child; item; item = item->next) {
+      child_count++;
+    }
     array = mongory_array_new(pool);
+    mongory_array_reserve(array, child_count);
     value = mongory_value_wrap_a(pool, array);
     for (cJSON *item = root->child; item; item = item->next) {
       array->push(array, convert_func(pool, item));
     }
     break;
   case cJSON_Object:
-    table = mongory_table_new(pool);
+    value = cjson_to_mongory_extended_value(pool, root);
+    if (value != NULL)
+      break;
+    for (cJSON *item = root->child; item; item = item->next) {
+      child_count++;
+    }
+    table = mongory_table_new_with_capacity(pool, child_count);
     value = mongory_value_wrap_t(pool, table);
     for (cJSON *item = root->child; item; item = item->next) {
       table->set(table, item->string, convert_func(pool, item));
     }
     break;
   case cJSON_String: {
-    value = mongory_value_wrap_s(pool, root->valuestring);
+    // A shallow conversion lives no longer than the cJSON tree, so it can
+    // point into it instead of copying.
+    if (borrow_strings) {
+      value = mongory_value_wrap_s_borrowed(pool, root->valuestring, strlen(root->valuestring));
+    } else {
+      value = mongory_value_wrap_s(pool, root->valuestring);
+    }
     break;
   }
   case cJSON_Number:
     if (root->valuedouble == (double)root->valueint) {
-      value = mongory_value_wrap_i(pool, root->valueint);
+      value = mongory_value_wrap_i_shared(pool, root->valueint);
     } else {
       value = mongory_value_wrap_d(pool, root->valuedouble);
     }
     break;
   case cJSON_True:
-    value = mongory_value_wrap_b(pool, true);
+    value = mongory_value_wrap_b_shared(pool, true);
     break;
   case cJSON_False:
-    value = mongory_value_wrap_b(pool, false);
+    value = mongory_value_wrap_b_shared(pool, false);
     break;
   case cJSON_NULL:
-    value = mongory_value_wrap_n(pool, NULL);
+    value = mongory_value_wrap_n_shared(pool, NULL);
     break;
   default:
     fprintf(stderr, "Unsupported JSON type: %d\n", root->type);
@@ -70,7 +124,7 @@ cjson_to_mongory_value_convert_recursive(mongory_memory_pool *pool, cJSON *root,
 }
 
 mongory_value *cjson_to_mongory_value_deep_convert(mongory_memory_pool *pool, cJSON *root) {
-  return cjson_to_mongory_value_convert_recursive(pool, root, cjson_to_mongory_value_deep_convert);
+  return cjson_to_mongory_value_convert_recursive(pool, root, cjson_to_mongory_value_deep_convert, false);
 }
 
 static inline mongory_value *cjson_to_mongory_value_ptr(mongory_memory_pool *pool, cJSON *root) {
@@ -78,7 +132,7 @@ static inline mongory_value *cjson_to_mongory_value_ptr(mongory_memory_pool *poo
 }
 
 mongory_value *cjson_to_mongory_value_shallow_convert(mongory_memory_pool *pool, cJSON *root) {
-  return cjson_to_mongory_value_convert_recursive(pool, root, cjson_to_mongory_value_ptr);
+  return cjson_to_mongory_value_convert_recursive(pool, root, cjson_to_mongory_value_ptr, true);
 }
 
 mongory_value *json_string_to_mongory_value(mongory_memory_pool *pool, const char *json) {
@@ -128,6 +182,7 @@ mongory_value *json_to_mongory_value_from_file(mongory_memory_pool *pool, const
 
 typedef struct mongory_test_execute_context {
   mongory_matcher *matcher;
+  mongory_program *program;
   int index;
   bool enable_trace;
   bool enable_explain;
@@ -136,8 +191,9 @@ typedef struct mongory_test_execute_context {
 
 bool execute_test_record(mongory_value *test_record, void *acc) {
   mongory_test_execute_context *context = (mongory_test_execute_context *)acc;
-  mongory_string_buffer *record_buffer = mongory_string_buffer_new(test_record->pool);
-  mongory_string_buffer_append(record_buffer, test_record->to_str(test_record, test_record->pool));
+  mongory_memory_pool *pool = MONGORY_VALUE_POOL(test_record, test_pool);
+  mongory_string_buffer *record_buffer = mongory_string_buffer_new(pool);
+  mongory_string_buffer_append(record_buffer, mongory_value_to_str(test_record, pool));
   if (context->show_progress) {
     printf("Running test record: %d -> %s\n", context->index, mongory_string_buffer_cstr(record_buffer));
   }
@@ -151,6 +207,8 @@ bool execute_test_record(mongory_value *test_record, void *acc) {
   bool result;
   if (context->enable_trace) {
     result = mongory_matcher_trace(matcher, data_value);
+  } else if (context->program) {
+    result = mongory_program_match(context->program, data_value);
   } else {
     result = matcher->match(matcher, data_value);
   }
@@ -162,6 +220,35 @@ bool execute_test_record(mongory_value *test_record, void *acc) {
   return true;
 }
 
+static void execute_test_batch(mongory_matcher *matcher, mongory_array *records) {
+  mongory_memory_pool *pool = records->pool;
+  size_t total = records->count;
+  mongory_value **values = MG_ALLOC_ARY(pool, mongory_value *, total + 1);
+  size_t *selection = MG_ALLOC_ARY(pool, size_t, total + 1);
+  TEST_ASSERT_NOT_NULL(values);
+  TEST_ASSERT_NOT_NULL(selection);
+  for (size_t i = 0; i < total; i++) {
+    mongory_value *test_record = records->get(records, i);
+    values[i] = test_record->data.t->get(test_record->data.t, "data");
+    TEST_ASSERT_NOT_NULL(values[i]);
+  }
+  size_t matched = mongory_matcher_match_batch(matcher, values, total, selection);
+  size_t cursor = 0;
+  for (size_t i = 0; i < total; i++) {
+    mongory_value *test_record = records->get(records, i);
+    mongory_value *expected_value = test_record->data.t->get(test_record->data.t, "expected");
+    TEST_ASSERT_NOT_NULL(expected_value);
+    bool result = cursor < matched && selection[cursor] == i;
+    if (result)
+      cursor++;
+    if (expected_value->data.b != result) {
+      printf("Batch test failed at record %zu\n", i);
+    }
+    TEST_ASSERT_EQUAL(expected_value->data.b, result);
+  }
+  TEST_ASSERT_EQUAL(matched, cursor);
+}
+
 bool execute_each_test_case(mongory_value *test_case, void *acc) {
   mongory_test_context *context = (mongory_test_context *)acc;
   mongory_value *description_value = test_case->data.t->get(test_case->data.t, "description");
@@ -178,9 +265,19 @@ bool execute_each_test_case(mongory_value *test_case, void *acc) {
   mongory_matcher *matcher = context->matcher_build_func(matcher_pool, condition_value, NULL);
   TEST_ASSERT_NOT_NULL(matcher);
   TEST_ASSERT_NULL(matcher_pool->error);
+  mongory_program *program = NULL;
+  if (context->use_program) {
+    program = mongory_program_compile(matcher_pool, matcher);
+    TEST_ASSERT_NOT_NULL(program);
+    TEST_ASSERT_NULL(matcher_pool->error);
+  }
   mongory_array *records = records_value->data.a;
-  mongory_test_execute_context execute_context = {matcher, 0, context->enable_trace, context->enable_explain, context->show_progress};
-  records->each(records, &execute_context, execute_test_record);
+  mongory_test_execute_context execute_context = {matcher, program, 0, context->enable_trace, context->enable_explain, context->show_progress};
+  if (context->use_batch) {
+    execute_test_batch(matcher, records);
+  } else {
+    records->each(records, &execute_context, execute_test_record);
+  }
   if (context->enable_explain) {
     mongory_memory_pool *stdout_pool = mongory_memory_pool_new();
     mongory_matcher_explain(matcher, stdout_pool);
@@ -217,13 +314,13 @@ mongory_memory_pool *get_test_pool(void) { return test_pool; }
 void assert_value_equals(mongory_value *expected, mongory_value *actual) {
   TEST_ASSERT_NOT_NULL(expected);
   TEST_ASSERT_NOT_NULL(actual);
-  TEST_ASSERT_EQUAL_INT(0, actual->comp(actual, expected));
+  TEST_ASSERT_EQUAL_INT(0, mongory_value_compare(actual, expected));
 }
 
 void assert_value_not_equals(mongory_value *expected, mongory_value *actual) {
   TEST_ASSERT_NOT_NULL(expected);
   TEST_ASSERT_NOT_NULL(actual);
-  TEST_ASSERT_NOT_EQUAL(0, actual->comp(actual, expected));
+  TEST_ASSERT_NOT_EQUAL(0, mongory_value_compare(actual, expected));
 }
 
 void assert_value_is_null(mongory_value *value) { TEST_ASSERT_NULL(value); }
@@ -21,6 +21,8 @@ typedef struct mongory_test_context {
   bool enable_trace;
   bool enable_explain;
   bool show_progress;
+  bool use_program;
+  bool use_batch;
 } mongory_test_context;
 
 void execute_test_case(char *file_name, mongory_test_context *context);
@@ -114,6 +114,154 @@ void test_array_sort_by(void) {
   TEST_ASSERT_EQUAL(10, *(int *)mongory_value_extract(sorted_array->get(sorted_array, 9)));
 }
 
+void test_typed_array_push_and_accessors(void) {
+  mongory_array *ints = mongory_array_new_typed(pool, MONGORY_TYPE_INT);
+  for (int64_t i = 0; i < 20; i++) {
+    TEST_ASSERT_TRUE(mongory_array_push_i(ints, i * 3));
+  }
+  TEST_ASSERT_TRUE(ints->push(ints, mongory_value_wrap_i(pool, 60)));
+  TEST_ASSERT_EQUAL(21, ints->count);
+  const int64_t *items = mongory_array_ints(ints);
+  TEST_ASSERT_NOT_NULL(items);
+  TEST_ASSERT_TRUE(items[19] == 57);
+  TEST_ASSERT_TRUE(items[20] == 60);
+  TEST_ASSERT_NULL(mongory_array_doubles(ints));
+  TEST_ASSERT_NULL(mongory_array_ints(array));
+
+  mongory_array *strings = mongory_array_new_typed(pool, MONGORY_TYPE_STRING);
+  char word[] = "apple";
+  TEST_ASSERT_TRUE(mongory_array_push_sn(strings, word, 5));
+  word[0] = 'X'; // The bytes were copied.
+  TEST_ASSERT_TRUE(mongory_array_push_sn(strings, "kiwi", 4));
+  TEST_ASSERT_EQUAL_STRING("apple", mongory_array_strings(strings)[0].s);
+  TEST_ASSERT_EQUAL(4, mongory_array_strings(strings)[1].len);
+
+  TEST_ASSERT_NULL(mongory_array_new_typed(pool, MONGORY_TYPE_TABLE));
+  TEST_ASSERT_TRUE(mongory_array_push_d(array, 1.5)); // Boxed arrays box the item.
+  TEST_ASSERT_EQUAL_DOUBLE(1.5, array->get(array, 0)->data.d);
+}
+
+void test_typed_array_boxes_lazily(void) {
+  mongory_array *doubles = mongory_array_new_typed(pool, MONGORY_TYPE_DOUBLE);
+  mongory_array_push_d(doubles, 0.5);
+  mongory_array_push_d(doubles, 2.5);
+
+  mongory_value scratch;
+  mongory_value *peeked = mongory_array_peek(doubles, 1, &scratch);
+  TEST_ASSERT_EQUAL_PTR(&scratch, peeked);
+  TEST_ASSERT_EQUAL_DOUBLE(2.5, peeked->data.d);
+  TEST_ASSERT_NULL(mongory_array_peek(doubles, 2, &scratch));
+
+  mongory_value *box = doubles->get(doubles, 1);
+  TEST_ASSERT_EQUAL(MONGORY_TYPE_DOUBLE, box->type);
+  TEST_ASSERT_EQUAL_DOUBLE(2.5, box->data.d);
+  TEST_ASSERT_EQUAL_PTR(box, doubles->get(doubles, 1));
+  TEST_ASSERT_EQUAL_PTR(box, mongory_array_peek(doubles, 1, &scratch));
+  TEST_ASSERT_NULL(doubles->get(doubles, 2));
+
+  TEST_ASSERT_TRUE(doubles->set(doubles, 1, mongory_value_wrap_d(pool, 4.0)));
+  TEST_ASSERT_EQUAL_DOUBLE(4.0, mongory_array_doubles(doubles)[1]);
+  TEST_ASSERT_EQUAL_DOUBLE(4.0, doubles->get(doubles, 1)->data.d);
+}
+
+void test_typed_array_deoptimizes(void) {
+  mongory_array *ints = mongory_array_new_typed(pool, MONGORY_TYPE_INT);
+  mongory_array_push_i(ints, 1);
+  mongory_array_push_i(ints, 2);
+  TEST_ASSERT_TRUE(ints->push(ints, mongory_value_wrap_s(pool, "three")));
+  TEST_ASSERT_NULL(mongory_array_ints(ints));
+  TEST_ASSERT_EQUAL(3, ints->count);
+  TEST_ASSERT_EQUAL(2, ints->get(ints, 1)->data.i);
+  TEST_ASSERT_EQUAL_STRING("three", ints->get(ints, 2)->data.s);
+
+  mongory_array *gapped = mongory_array_new_typed(pool, MONGORY_TYPE_INT);
+  mongory_array_push_i(gapped, 1);
+  TEST_ASSERT_TRUE(gapped->set(gapped, 3, mongory_value_wrap_i(pool, 4)));
+  TEST_ASSERT_NULL(mongory_array_ints(gapped));
+  TEST_ASSERT_EQUAL(4, gapped->count);
+  TEST_ASSERT_NULL(gapped->get(gapped, 2));
+  TEST_ASSERT_EQUAL(4, gapped->get(gapped, 3)->data.i);
+}
+
+void test_typed_array_matching(void) {
+  mongory_array *tags = mongory_array_new_typed(pool, MONGORY_TYPE_STRING);
+  mongory_array_push_sn(tags, "red", 3);
+  mongory_array_push_sn(tags, "blue", 4);
+  mongory_array *scores = mongory_array_new_typed(pool, MONGORY_TYPE_INT);
+  mongory_array_push_i(scores, 70);
+  mongory_array_push_i(scores, 95);
+
+  mongory_table *record_table = mongory_table_new(pool);
+  record_table->set(record_table, "tags", mongory_value_wrap_a(pool, tags));
+  record_table->set(record_table, "scores", mongory_value_wrap_a(pool, scores));
+  mongory_value *record = mongory_value_wrap_t(pool, record_table);
+
+  mongory_table *in_condition = mongory_table_new(pool);
+  in_condition->set(in_condition, "$in", MG_ARRAY_WRAP(pool, 2, mongory_value_wrap_s(pool, "blue"),
+                                                       mongory_value_wrap_s(pool, "green")));
+  mongory_table *elem_condition = mongory_table_new(pool);
+  elem_condition->set(elem_condition, "$gt", mongory_value_wrap_i(pool, 90));
+  mongory_table *elem_match = mongory_table_new(pool);
+  elem_match->set(elem_match, "$elemMatch", mongory_value_wrap_t(pool, elem_condition));
+  mongory_table *condition = mongory_table_new(pool);
+  condition->set(condition, "tags", mongory_value_wrap_t(pool, in_condition));
+  condition->set(condition, "scores", mongory_value_wrap_t(pool, elem_match));
+
+  mongory_matcher *matcher = mongory_matcher_new(pool, mongory_value_wrap_t(pool, condition), NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+  TEST_ASSERT_TRUE(mongory_matcher_match(matcher, record));
+  TEST_ASSERT_NOT_NULL(mongory_array_ints(scores));
+  TEST_ASSERT_TRUE(mongory_array_push_i(scores, 99));
+
+  mongory_array *boxed = mongory_array_nested_wrap(pool, 3, mongory_value_wrap_i(pool, 70),
+                                                   mongory_value_wrap_i(pool, 95), mongory_value_wrap_i(pool, 99));
+  mongory_value *typed_value = mongory_value_wrap_a(pool, scores);
+  mongory_value *boxed_value = mongory_value_wrap_a(pool, boxed);
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(typed_value, boxed_value));
+  TEST_ASSERT_TRUE(mongory_value_hash(boxed_value) == mongory_value_hash(typed_value));
+}
+
+void test_array_reserve_and_push_many(void) {
+  TEST_ASSERT_TRUE(mongory_array_reserve(array, 100));
+  TEST_ASSERT_EQUAL(100, ((mongory_array_private *)array)->capacity);
+  mongory_value **items = ((mongory_array_private *)array)->items;
+
+  mongory_value *values[100];
+  for (int i = 0; i < 100; i++) {
+    values[i] = mongory_value_wrap_i(pool, i);
+  }
+  TEST_ASSERT_TRUE(mongory_array_push_many(array, values, 100));
+  TEST_ASSERT_EQUAL(100, array->count);
+  TEST_ASSERT_EQUAL_PTR(items, ((mongory_array_private *)array)->items); // No regrowth.
+  TEST_ASSERT_EQUAL(99, array->get(array, 99)->data.i);
+
+  mongory_array *ints = mongory_array_new_typed(pool, MONGORY_TYPE_INT);
+  TEST_ASSERT_TRUE(mongory_array_push_many(ints, values, 100));
+  const int64_t *vector = mongory_array_ints(ints);
+  TEST_ASSERT_NOT_NULL(vector);
+  TEST_ASSERT_TRUE(vector[42] == 42);
+}
+
+void test_array_grows_in_place_at_pool_tail(void) {
+  mongory_memory_pool *fresh = mongory_memory_pool_new();
+  mongory_array *grown = mongory_array_new(fresh);
+  mongory_value *value = mongory_value_wrap_i(fresh, 7); // Allocated before the items grow.
+  mongory_value **items = ((mongory_array_private *)grown)->items;
+  TEST_ASSERT_TRUE(mongory_array_reserve(grown, 4));
+  grown->push(grown, value);
+  TEST_ASSERT_TRUE(mongory_array_reserve(grown, 64)); // Items are no longer the tail.
+  mongory_value **moved = ((mongory_array_private *)grown)->items;
+  TEST_ASSERT_TRUE(moved != items);
+  for (int i = 1; i < 64; i++) {
+    grown->push(grown, value);
+  }
+  TEST_ASSERT_TRUE(grown->push(grown, value)); // Now the tail: extends in place.
+  TEST_ASSERT_EQUAL_PTR(moved, ((mongory_array_private *)grown)->items);
+  TEST_ASSERT_EQUAL(65, grown->count);
+  TEST_ASSERT_EQUAL_PTR(value, grown->get(grown, 64));
+  fresh->free(fresh);
+}
+
 int main(void) {
   UNITY_BEGIN();
   mongory_init();
@@ -123,6 +271,12 @@ int main(void) {
   RUN_TEST(test_array_each);
   RUN_TEST(test_array_out_of_bounds);
   RUN_TEST(test_array_sort_by);
+  RUN_TEST(test_typed_array_push_and_accessors);
+  RUN_TEST(test_typed_array_boxes_lazily);
+  RUN_TEST(test_typed_array_deoptimizes);
+  RUN_TEST(test_typed_array_matching);
+  RUN_TEST(test_array_reserve_and_push_many);
+  RUN_TEST(test_array_grows_in_place_at_pool_tail);
   mongory_cleanup();
   return UNITY_END();
 }
@@ -0,0 +1,109 @@
+#include "../src/matchers/compare_kernel.h"
+#include "../src/matchers/compare_matcher.h"
+#include "../src/test_helper/test_helper.h"
+#include "mongory-core.h"
+#include "unity.h"
+#include <math.h>
+
+#define ROWS 150
+
+typedef mongory_matcher *(*compare_new_func)(mongory_memory_pool *pool, mongory_value *condition, void *extern_ctx);
+
+static compare_new_func compare_constructors[] = {
+    mongory_matcher_equal_new,     mongory_matcher_not_equal_new,         mongory_matcher_greater_than_new,
+    mongory_matcher_less_than_new, mongory_matcher_greater_than_or_equal_new, mongory_matcher_less_than_or_equal_new,
+};
+
+void setUp(void) { setup_test_environment(); }
+
+void tearDown(void) { teardown_test_environment(); }
+
+static void assert_batch_matches_rows(mongory_value **values, size_t count, mongory_value *condition) {
+  mongory_memory_pool *pool = get_test_pool();
+  size_t selection[ROWS];
+  for (size_t k = 0; k < sizeof(compare_constructors) / sizeof(compare_constructors[0]); k++) {
+    mongory_matcher *matcher = compare_constructors[k](pool, condition, NULL);
+    TEST_ASSERT_NOT_NULL(matcher);
+    size_t matched = mongory_matcher_match_batch(matcher, values, count, selection);
+    size_t cursor = 0;
+    for (size_t i = 0; i < count; i++) {
+      bool selected = cursor < matched && selection[cursor] == i;
+      if (selected)
+        cursor++;
+      TEST_ASSERT_EQUAL(matcher->match(matcher, values[i]), selected);
+    }
+    TEST_ASSERT_EQUAL(matched, cursor);
+  }
+}
+
+void test_int_column_against_int(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *values[ROWS];
+  for (size_t i = 0; i < ROWS; i++) {
+    values[i] = mongory_value_wrap_i(pool, (int64_t)(i % 7) - 3);
+  }
+  values[5] = mongory_value_wrap_i(pool, INT64_MAX);
+  values[70] = mongory_value_wrap_i(pool, INT64_MIN);
+  assert_batch_matches_rows(values, ROWS, mongory_value_wrap_i(pool, 1));
+  assert_batch_matches_rows(values, ROWS, mongory_value_wrap_i(pool, INT64_MAX));
+}
+
+void test_double_column_with_nan(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *values[ROWS];
+  for (size_t i = 0; i < ROWS; i++) {
+    values[i] = mongory_value_wrap_d(pool, (double)(i % 11) / 2.0 - 2.5);
+  }
+  values[3] = mongory_value_wrap_d(pool, NAN);
+  values[64] = mongory_value_wrap_d(pool, INFINITY);
+  values[149] = mongory_value_wrap_d(pool, -INFINITY);
+  assert_batch_matches_rows(values, ROWS, mongory_value_wrap_d(pool, 0.5));
+  assert_batch_matches_rows(values, ROWS, mongory_value_wrap_d(pool, NAN));
+}
+
+void test_mixed_numbers_against_double(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *values[ROWS];
+  for (size_t i = 0; i < ROWS; i++) {
+    values[i] = i % 2 ? mongory_value_wrap_i(pool, (int64_t)i) : mongory_value_wrap_d(pool, (double)i + 0.5);
+  }
+  assert_batch_matches_rows(values, ROWS, mongory_value_wrap_d(pool, 75.0));
+  assert_batch_matches_rows(values, ROWS, mongory_value_wrap_i(pool, 75));
+}
+
+void test_non_numeric_rows_fall_back(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *values[ROWS];
+  for (size_t i = 0; i < ROWS; i++) {
+    values[i] = mongory_value_wrap_i(pool, (int64_t)i);
+  }
+  values[10] = NULL;
+  values[20] = mongory_value_wrap_s(pool, "20");
+  values[30] = mongory_value_wrap_n(pool, NULL);
+  assert_batch_matches_rows(values, ROWS, mongory_value_wrap_i(pool, 20));
+}
+
+void test_kernel_tail_rows(void) {
+  int64_t column[67];
+  for (size_t i = 0; i < 67; i++) {
+    column[i] = (int64_t)i;
+  }
+  uint64_t mask[MONGORY_COMPARE_KERNEL_MASK_WORDS(67)];
+  mongory_compare_kernel_i64(MONGORY_COMPARE_KERNEL_GTE, column, 67, 62, mask);
+  TEST_ASSERT_EQUAL_HEX64((uint64_t)3 << 62, mask[0]);
+  TEST_ASSERT_EQUAL_HEX64(7, mask[1]);
+  mongory_compare_kernel_i64(MONGORY_COMPARE_KERNEL_EQ, column, 67, 100, mask);
+  TEST_ASSERT_EQUAL_HEX64(0, mask[0]);
+  TEST_ASSERT_EQUAL_HEX64(0, mask[1]);
+  TEST_ASSERT_NOT_NULL(mongory_compare_kernel_isa());
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_int_column_against_int);
+  RUN_TEST(test_double_column_with_nan);
+  RUN_TEST(test_mixed_numbers_against_double);
+  RUN_TEST(test_non_numeric_rows_fall_back);
+  RUN_TEST(test_kernel_tail_rows);
+  return UNITY_END();
+}
@@ -105,6 +105,41 @@ void test_compare_less_than_or_equal(void) {
   TEST_ASSERT_FALSE(matcher->match(matcher, value_string));
 }
 
+void test_compare_datetime_range(void) {
+  int64_t day = 86400LL * 1000000000LL;
+  mongory_matcher *after = mongory_matcher_greater_than_or_equal_new(pool, mongory_value_wrap_datetime(pool, 10 * day), NULL);
+  mongory_matcher *before = mongory_matcher_less_than_new(pool, mongory_value_wrap_datetime(pool, 20 * day), NULL);
+
+  TEST_ASSERT_TRUE(after->match(after, mongory_value_wrap_datetime(pool, 10 * day)));
+  TEST_ASSERT_FALSE(after->match(after, mongory_value_wrap_datetime(pool, 10 * day - 1)));
+  TEST_ASSERT_TRUE(before->match(before, mongory_value_wrap_datetime(pool, 20 * day - 1)));
+  TEST_ASSERT_FALSE(before->match(before, mongory_value_wrap_datetime(pool, 20 * day)));
+  // Datetimes are not numbers.
+  TEST_ASSERT_FALSE(after->match(after, mongory_value_wrap_i(pool, 15 * day)));
+
+  mongory_value *values[4] = {
+      mongory_value_wrap_datetime(pool, 5 * day),
+      mongory_value_wrap_datetime(pool, 12 * day),
+      mongory_value_wrap_datetime(pool, 25 * day),
+      mongory_value_wrap_datetime(pool, 10 * day),
+  };
+  size_t selection[4];
+  TEST_ASSERT_EQUAL(3, mongory_matcher_match_batch(after, values, 4, selection));
+  TEST_ASSERT_EQUAL(1, selection[0]);
+  TEST_ASSERT_EQUAL(2, selection[1]);
+  TEST_ASSERT_EQUAL(3, selection[2]);
+}
+
+void test_compare_binary(void) {
+  unsigned char oid[12] = {0x65, 0x0f, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1};
+  mongory_matcher *matcher = mongory_matcher_equal_new(pool, mongory_value_wrap_binary(pool, oid, sizeof(oid)), NULL);
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_binary_borrowed(pool, oid, sizeof(oid))));
+  oid[11] = 2;
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_binary(pool, oid, sizeof(oid))));
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_binary(pool, oid, 11)));
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_sn(pool, (char *)oid, sizeof(oid))));
+}
+
 int main(void) {
   UNITY_BEGIN();
   mongory_init();
@@ -114,6 +149,8 @@ int main(void) {
   RUN_TEST(test_compare_less_than);
   RUN_TEST(test_compare_greater_than_or_equal);
   RUN_TEST(test_compare_less_than_or_equal);
+  RUN_TEST(test_compare_datetime_range);
+  RUN_TEST(test_compare_binary);
   mongory_cleanup();
   return UNITY_END();
 }
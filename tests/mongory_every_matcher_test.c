@@ -8,7 +8,7 @@ void setUp(void) { setup_test_environment(); }
 void tearDown(void) { teardown_test_environment(); }
 
 void test_every_matcher(void) {
-  mongory_test_context context = {mongory_matcher_every_new, false, false, false};
+  mongory_test_context context = {mongory_matcher_every_new, false, false, false, false, false};
   execute_test_case("tests/jsons/every_matcher_test.json", &context);
 }
 
@@ -2,6 +2,8 @@
 #include "../src/matchers/inclusion_matcher.h"
 #include "mongory-core.h"
 #include "unity.h"
+#include <math.h>
+#include <stdio.h>
 
 mongory_memory_pool *pool;
 mongory_array *condition_array;
@@ -125,12 +127,128 @@ void test_not_in_matcher_invalid_condition(void) {
   TEST_ASSERT_EQUAL_STRING("$nin condition must be a valid array.", pool->error->message);
 }
 
+void test_in_matcher_numbers_match_across_types(void) {
+  condition_array->push(condition_array, mongory_value_wrap_i(pool, 1));
+  condition_array->push(condition_array, mongory_value_wrap_d(pool, 2.5));
+  condition_array->push(condition_array, mongory_value_wrap_d(pool, -0.0));
+
+  mongory_matcher *matcher = mongory_matcher_in_new(pool, mongory_value_wrap_a(pool, condition_array), NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_d(pool, 1.0)));
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_i(pool, 0)));
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_d(pool, 2.5)));
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_i(pool, 2)));
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_s(pool, "1")));
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_b(pool, true)));
+}
+
+void test_in_matcher_mixed_types(void) {
+  condition_array->push(condition_array, mongory_value_wrap_s(pool, "alpha"));
+  condition_array->push(condition_array, mongory_value_wrap_b(pool, false));
+  condition_array->push(condition_array, mongory_value_wrap_n(pool, NULL));
+  mongory_array *nested = mongory_array_new(pool);
+  nested->push(nested, mongory_value_wrap_i(pool, 7));
+  condition_array->push(condition_array, mongory_value_wrap_a(pool, nested));
+
+  mongory_matcher *matcher = mongory_matcher_in_new(pool, mongory_value_wrap_a(pool, condition_array), NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_s(pool, "alpha")));
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_s(pool, "alphabet")));
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_b(pool, false)));
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_b(pool, true)));
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_n(pool, NULL)));
+
+  value_array->push(value_array, mongory_value_wrap_d(pool, 7.0));
+  mongory_value *wrapped = mongory_value_wrap_a(pool, value_array);
+  TEST_ASSERT_FALSE(matcher->match(matcher, wrapped));
+  mongory_array *outer = mongory_array_new(pool);
+  outer->push(outer, wrapped);
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_a(pool, outer)));
+}
+
+static mongory_value *document(int a, char *b) {
+  mongory_table *table = mongory_table_new(pool);
+  table->set(table, "a", mongory_value_wrap_i(pool, a));
+  if (b != NULL) {
+    mongory_array *tags = mongory_array_new(pool);
+    tags->push(tags, mongory_value_wrap_s(pool, b));
+    table->set(table, "b", mongory_value_wrap_a(pool, tags));
+  }
+  return mongory_value_wrap_t(pool, table);
+}
+
+void test_in_matcher_embedded_documents(void) {
+  condition_array->push(condition_array, document(1, "x"));
+  condition_array->push(condition_array, document(2, NULL));
+  mongory_matcher *matcher = mongory_matcher_in_new(pool, mongory_value_wrap_a(pool, condition_array), NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+
+  // Same pairs in another order, with an equal double.
+  mongory_table *reordered = mongory_table_new(pool);
+  mongory_array *tags = mongory_array_new(pool);
+  tags->push(tags, mongory_value_wrap_s(pool, "x"));
+  reordered->set(reordered, "b", mongory_value_wrap_a(pool, tags));
+  reordered->set(reordered, "a", mongory_value_wrap_d(pool, 1.0));
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_t(pool, reordered)));
+
+  TEST_ASSERT_TRUE(matcher->match(matcher, document(2, NULL)));
+  TEST_ASSERT_FALSE(matcher->match(matcher, document(1, NULL)));
+  TEST_ASSERT_FALSE(matcher->match(matcher, document(1, "y")));
+  value_array->push(value_array, document(3, NULL));
+  value_array->push(value_array, document(2, NULL));
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_a(pool, value_array)));
+
+  // NaN compares equal to every number, including inside containers, though
+  // it hashes apart from them.
+  mongory_array *nan_condition = mongory_array_new(pool);
+  mongory_array *nan_item = mongory_array_new(pool);
+  nan_item->push(nan_item, mongory_value_wrap_d(pool, NAN));
+  nan_condition->push(nan_condition, mongory_value_wrap_a(pool, nan_item));
+  mongory_matcher *nan_matcher = mongory_matcher_in_new(pool, mongory_value_wrap_a(pool, nan_condition), NULL);
+  TEST_ASSERT_NOT_NULL(nan_matcher);
+  mongory_array *one = mongory_array_new(pool);
+  one->push(one, mongory_value_wrap_i(pool, 1));
+  mongory_value *one_wrapper = mongory_value_wrap_a(pool, mongory_array_new(pool));
+  one_wrapper->data.a->push(one_wrapper->data.a, mongory_value_wrap_a(pool, one));
+  TEST_ASSERT_TRUE(nan_matcher->match(nan_matcher, one_wrapper));
+
+  mongory_table *nan_document = mongory_table_new(pool);
+  nan_document->set(nan_document, "a", mongory_value_wrap_d(pool, NAN));
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_t(pool, nan_document)));
+}
+
+void test_in_matcher_large_condition(void) {
+  char key[32];
+  for (int i = 0; i < 20000; i++) {
+    condition_array->push(condition_array, mongory_value_wrap_i(pool, i * 3));
+    snprintf(key, sizeof(key), "id-%d", i);
+    condition_array->push(condition_array, mongory_value_wrap_s(pool, key));
+  }
+
+  mongory_matcher *matcher = mongory_matcher_in_new(pool, mongory_value_wrap_a(pool, condition_array), NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+  TEST_ASSERT_NULL(pool->error);
+
+  for (int i = 0; i < 60000; i++) {
+    TEST_ASSERT_EQUAL(i % 3 == 0, matcher->match(matcher, mongory_value_wrap_i(pool, i)));
+  }
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_s(pool, "id-19999")));
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_s(pool, "id-20000")));
+  TEST_ASSERT_TRUE(matcher->priority < 2.0);
+}
+
 int main(void) {
   UNITY_BEGIN();
   mongory_init();
   RUN_TEST(test_in_matcher);
   RUN_TEST(test_in_matcher_with_array_target);
   RUN_TEST(test_in_matcher_invalid_condition);
+  RUN_TEST(test_in_matcher_numbers_match_across_types);
+  RUN_TEST(test_in_matcher_mixed_types);
+  RUN_TEST(test_in_matcher_embedded_documents);
+  RUN_TEST(test_in_matcher_large_condition);
   RUN_TEST(test_not_in_matcher);
   RUN_TEST(test_not_in_matcher_with_array_target);
   RUN_TEST(test_not_in_matcher_invalid_condition);
@@ -0,0 +1,113 @@
+#include "../src/matchers/composite_matcher.h"
+#include "../src/test_helper/test_helper.h"
+#include "mongory-core.h"
+#include "unity.h"
+
+void setUp(void) { setup_test_environment(); }
+
+void tearDown(void) { teardown_test_environment(); }
+
+void test_batch_and_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_and_new, .use_batch = true};
+  execute_test_case("tests/jsons/and_matcher_test.json", &context);
+}
+
+void test_batch_or_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_or_new, .use_batch = true};
+  execute_test_case("tests/jsons/or_matcher_test.json", &context);
+}
+
+void test_batch_elem_match_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_elem_match_new, .use_batch = true};
+  execute_test_case("tests/jsons/elem_match_matcher_test.json", &context);
+}
+
+void test_batch_every_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_every_new, .use_batch = true};
+  execute_test_case("tests/jsons/every_matcher_test.json", &context);
+}
+
+void test_batch_table_cond_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_table_cond_new, .use_batch = true};
+  execute_test_case("tests/jsons/table_condition_matcher_test.json", &context);
+}
+
+void test_batch_selection_is_ascending(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *condition =
+      json_string_to_mongory_value(pool, "{\"$or\": [{\"age\": {\"$gt\": 30}}, {\"tags\": \"b\"}], \"name\": {\"$ne\": \"x\"}}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+
+  mongory_value *values[] = {
+      json_string_to_mongory_value(pool, "{\"age\": 40, \"name\": \"a\"}"),
+      json_string_to_mongory_value(pool, "{\"age\": 20, \"tags\": [\"a\", \"b\"]}"),
+      json_string_to_mongory_value(pool, "{\"age\": 50, \"name\": \"x\"}"),
+      NULL,
+      json_string_to_mongory_value(pool, "{\"age\": 10, \"tags\": \"c\"}"),
+      json_string_to_mongory_value(pool, "{\"tags\": \"b\"}"),
+  };
+  size_t selection[6];
+  size_t matched = mongory_matcher_match_batch(matcher, values, 6, selection);
+  TEST_ASSERT_EQUAL(3, matched);
+  TEST_ASSERT_EQUAL(0, selection[0]);
+  TEST_ASSERT_EQUAL(1, selection[1]);
+  TEST_ASSERT_EQUAL(5, selection[2]);
+
+  for (size_t i = 0; i < 6; i++) {
+    bool selected = false;
+    for (size_t j = 0; j < matched; j++) {
+      selected = selected || selection[j] == i;
+    }
+    TEST_ASSERT_EQUAL(matcher->match(matcher, values[i]), selected);
+  }
+}
+
+void test_batch_empty_input(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *condition = json_string_to_mongory_value(pool, "{\"age\": 1}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+  size_t selection[1];
+  TEST_ASSERT_EQUAL(0, mongory_matcher_match_batch(matcher, NULL, 0, selection));
+}
+
+#ifndef MONGORY_COMPACT_VALUE
+static int reversed_compare(mongory_value *a, mongory_value *b) {
+  return (a->data.i < b->data.i) - (a->data.i > b->data.i);
+}
+
+void test_batch_honours_comp_override(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *condition = json_string_to_mongory_value(pool, "{\"$gt\": 5}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+
+  mongory_value *values[4];
+  for (int i = 0; i < 4; i++) {
+    values[i] = mongory_value_wrap_i(pool, i * 3);
+  }
+  values[1]->comp = reversed_compare;
+  size_t selection[4];
+  size_t matched = mongory_matcher_match_batch(matcher, values, 4, selection);
+  TEST_ASSERT_EQUAL(3, matched);
+  TEST_ASSERT_EQUAL(1, selection[0]);
+  TEST_ASSERT_EQUAL(2, selection[1]);
+  TEST_ASSERT_EQUAL(3, selection[2]);
+}
+#endif
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_batch_and_matcher);
+  RUN_TEST(test_batch_or_matcher);
+  RUN_TEST(test_batch_elem_match_matcher);
+  RUN_TEST(test_batch_every_matcher);
+  RUN_TEST(test_batch_table_cond_matcher);
+  RUN_TEST(test_batch_selection_is_ascending);
+  RUN_TEST(test_batch_empty_input);
+#ifndef MONGORY_COMPACT_VALUE
+  RUN_TEST(test_batch_honours_comp_override);
+#endif
+  return UNITY_END();
+}
@@ -0,0 +1,151 @@
+#include "../src/foundations/memory_pool_private.h"
+#include "../src/matchers/base_matcher.h"
+#include "../src/test_helper/test_helper.h"
+#include "mongory-core.h"
+#include "unity.h"
+
+static size_t frozen_alloc_calls = 0;
+
+void setUp(void) { setup_test_environment(); }
+
+void tearDown(void) { teardown_test_environment(); }
+
+static void *mongory_test_counting_alloc(mongory_memory_pool *pool, size_t size) {
+  (void)pool;
+  (void)size;
+  frozen_alloc_calls++;
+  return NULL;
+}
+
+static const char *condition_json =
+    "{\"tags\": \"a\", \"meta\": {\"n\": {\"$gt\": 1}}, \"scores\": {\"$not\": {\"$lt\": 0}}, \"$or\": [{\"x\": [1, 2]}, "
+    "{\"x\": {\"$elemMatch\": {\"y\": 3}}}]}";
+
+static const char *records_json[] = {
+    "{\"tags\": [\"b\", \"a\"], \"meta\": [{\"n\": 0}, {\"n\": 2}], \"scores\": [1, 2], \"x\": [1, 2]}",
+    "{\"tags\": \"a\", \"meta\": {\"n\": 5}, \"scores\": 3, \"x\": [{\"y\": 3}]}",
+    "{\"tags\": [\"b\"], \"meta\": {\"n\": 5}, \"x\": [1, 2]}",
+    "{\"tags\": \"a\", \"meta\": {\"n\": [0, 9]}, \"scores\": [-1], \"x\": [[1, 2]]}",
+};
+
+void test_frozen_matcher_does_not_allocate(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_memory_pool *matcher_pool = mongory_memory_pool_new();
+  mongory_matcher *reference = mongory_matcher_new(pool, json_string_to_mongory_value(pool, condition_json), NULL);
+  mongory_matcher *matcher =
+      mongory_matcher_new(matcher_pool, json_string_to_mongory_value(matcher_pool, condition_json), NULL);
+  TEST_ASSERT_NOT_NULL(reference);
+  TEST_ASSERT_NOT_NULL(matcher);
+  TEST_ASSERT_TRUE(mongory_matcher_freeze(matcher));
+  TEST_ASSERT_TRUE(matcher->frozen);
+
+  void *(*alloc)(mongory_memory_pool *pool, size_t size) = matcher_pool->alloc;
+  matcher_pool->alloc = mongory_test_counting_alloc;
+  frozen_alloc_calls = 0;
+  size_t matched = 0;
+  for (size_t i = 0; i < sizeof(records_json) / sizeof(records_json[0]); i++) {
+    mongory_value *record = json_string_to_mongory_value(pool, records_json[i]);
+    bool result = mongory_matcher_match(matcher, record);
+    TEST_ASSERT_EQUAL(mongory_matcher_match(reference, record), result);
+    matched += result;
+  }
+  matcher_pool->alloc = alloc;
+
+  TEST_ASSERT_EQUAL(0, frozen_alloc_calls);
+  TEST_ASSERT_EQUAL(2, matched);
+  matcher_pool->free(matcher_pool);
+}
+
+void test_size_match_does_not_allocate(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_memory_pool *record_pool = mongory_memory_pool_new();
+  mongory_matcher *small = mongory_matcher_new(pool, json_string_to_mongory_value(pool, "{\"a\": {\"$size\": 3}}"), NULL);
+  mongory_matcher *large =
+      mongory_matcher_new(pool, json_string_to_mongory_value(pool, "{\"a\": {\"$size\": {\"$gt\": 1500}}}"), NULL);
+  mongory_array *items = mongory_array_new(record_pool);
+  mongory_table *table = mongory_table_new(record_pool);
+  table->set(table, "a", mongory_value_wrap_a(record_pool, items));
+  mongory_value *record = mongory_value_wrap_t(record_pool, table);
+
+  void *(*alloc)(mongory_memory_pool *pool, size_t size) = record_pool->alloc;
+  for (int i = 0; i < 2000; i++) {
+    items->push(items, mongory_value_wrap_i(record_pool, i));
+    if (i == 2 || i == 1999) {
+      record_pool->alloc = mongory_test_counting_alloc;
+      frozen_alloc_calls = 0;
+      TEST_ASSERT_EQUAL(i == 2, mongory_matcher_match(small, record));
+      TEST_ASSERT_EQUAL(i == 1999, mongory_matcher_match(large, record));
+      TEST_ASSERT_EQUAL(0, frozen_alloc_calls);
+      record_pool->alloc = alloc;
+    }
+  }
+  record_pool->free(record_pool);
+}
+
+void test_freeze_is_idempotent(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_matcher *matcher = mongory_matcher_new(pool, json_string_to_mongory_value(pool, condition_json), NULL);
+  TEST_ASSERT_TRUE(mongory_matcher_freeze(matcher));
+  TEST_ASSERT_TRUE(mongory_matcher_freeze(matcher));
+  TEST_ASSERT_FALSE(mongory_matcher_freeze(NULL));
+}
+
+void test_trace_leaves_matcher_untouched(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_matcher *matcher = mongory_matcher_new(pool, json_string_to_mongory_value(pool, condition_json), NULL);
+  TEST_ASSERT_TRUE(mongory_matcher_freeze(matcher));
+  mongory_matcher_match_func match = matcher->match;
+
+  mongory_value *record = json_string_to_mongory_value(pool, records_json[1]);
+  TEST_ASSERT_TRUE(mongory_matcher_trace(matcher, record));
+  TEST_ASSERT_EQUAL_PTR(match, matcher->match);
+  TEST_ASSERT_NULL(mongory_matcher_trace_current);
+
+  mongory_matcher_enable_trace(matcher, pool);
+  TEST_ASSERT_NOT_NULL(mongory_matcher_trace_current);
+  TEST_ASSERT_FALSE(mongory_matcher_match(matcher, json_string_to_mongory_value(pool, records_json[2])));
+  TEST_ASSERT_TRUE(mongory_matcher_trace_current->trace_stack->count > 1);
+  TEST_ASSERT_EQUAL(0, mongory_matcher_trace_current->level);
+  mongory_matcher_disable_trace(matcher);
+  TEST_ASSERT_NULL(mongory_matcher_trace_current);
+}
+
+void test_shallow_fields_convert_into_scratch(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_memory_pool *record_pool = mongory_memory_pool_new();
+  mongory_value_converter_shallow_convert_set((mongory_shallow_convert_func)cjson_to_mongory_value_shallow_convert);
+  mongory_value *condition = json_string_to_mongory_value(pool, "{\"tags\": \"a\", \"meta\": {\"n\": {\"$gt\": 1}}}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  TEST_ASSERT_TRUE(mongory_matcher_freeze(matcher));
+  cJSON *json = cJSON_Parse(records_json[1]);
+  mongory_value *record = cjson_to_mongory_value_shallow_convert(record_pool, json);
+
+  mongory_memory_pool *scratch = mongory_memory_pool_scratch();
+  mongory_memory_pool_mark before = scratch->mark(scratch);
+  void *(*alloc)(mongory_memory_pool *pool, size_t size) = record_pool->alloc;
+  record_pool->alloc = mongory_test_counting_alloc;
+  frozen_alloc_calls = 0;
+  for (int i = 0; i < 100; i++) {
+    TEST_ASSERT_TRUE(mongory_matcher_match(matcher, record));
+  }
+  record_pool->alloc = alloc;
+  mongory_memory_pool_mark after = scratch->mark(scratch);
+
+  TEST_ASSERT_EQUAL(0, frozen_alloc_calls);
+  TEST_ASSERT_EQUAL_PTR(before.chunk, after.chunk);
+  TEST_ASSERT_EQUAL(before.offset, after.offset);
+  TEST_ASSERT_NULL(mongory_matcher_scratch_current);
+  mongory_value_converter_shallow_convert_set(NULL);
+  cJSON_Delete(json);
+  record_pool->free(record_pool);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_frozen_matcher_does_not_allocate);
+  RUN_TEST(test_size_match_does_not_allocate);
+  RUN_TEST(test_freeze_is_idempotent);
+  RUN_TEST(test_trace_leaves_matcher_untouched);
+  RUN_TEST(test_shallow_fields_convert_into_scratch);
+  return UNITY_END();
+}
@@ -0,0 +1,81 @@
+#include "../src/test_helper/test_helper.h"
+#include "mongory-core.h"
+#include "unity.h"
+
+#define RECORDS 5000
+
+static char *statuses[] = {"active", "inactive", "banned"};
+
+void setUp(void) { setup_test_environment(); }
+
+void tearDown(void) { teardown_test_environment(); }
+
+static mongory_array *build_records(mongory_memory_pool *pool) {
+  mongory_array *records = mongory_array_new(pool);
+  for (int i = 0; i < RECORDS; i++) {
+    mongory_value *tags = i % 3 ? MG_ARRAY_WRAP(pool, 2, mongory_value_wrap_s(pool, "a"), mongory_value_wrap_i(pool, i % 5))
+                                : mongory_value_wrap_s(pool, "b");
+    mongory_value *record = MG_TABLE_WRAP(pool, 3, "age", mongory_value_wrap_i(pool, i % 97), "status",
+                                          mongory_value_wrap_s(pool, statuses[i % 3]), "tags", tags);
+    records->push(records, record);
+  }
+  return records;
+}
+
+static void assert_filter_matches_serial(const char *condition_json, int nthreads) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *condition = json_string_to_mongory_value(pool, condition_json);
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+  mongory_array *records = build_records(pool);
+  mongory_array *out = mongory_array_new(pool);
+
+  TEST_ASSERT_TRUE(mongory_matcher_filter_parallel(matcher, records, nthreads, out));
+  TEST_ASSERT_NULL(out->pool->error);
+
+  size_t cursor = 0;
+  for (size_t i = 0; i < records->count; i++) {
+    mongory_value *record = records->get(records, i);
+    if (!matcher->match(matcher, record))
+      continue;
+    TEST_ASSERT_TRUE(cursor < out->count);
+    TEST_ASSERT_EQUAL_PTR(record, out->get(out, cursor));
+    cursor++;
+  }
+  TEST_ASSERT_EQUAL(out->count, cursor);
+}
+
+void test_filter_parallel_single_thread(void) {
+  assert_filter_matches_serial("{\"age\": {\"$gte\": 50}}", 1);
+}
+
+void test_filter_parallel_numeric_range(void) {
+  assert_filter_matches_serial("{\"age\": {\"$gte\": 20, \"$lt\": 60}}", 4);
+}
+
+void test_filter_parallel_array_fields(void) {
+  assert_filter_matches_serial("{\"$or\": [{\"age\": {\"$gt\": 90}}, {\"tags\": 3}], \"status\": {\"$ne\": \"banned\"}}",
+                               7);
+}
+
+void test_filter_parallel_more_threads_than_chunks(void) {
+  assert_filter_matches_serial("{\"tags\": {\"$in\": [\"b\", 1]}, \"status\": \"active\"}", 64);
+}
+
+void test_filter_parallel_empty_array(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_matcher *matcher = mongory_matcher_new(pool, json_string_to_mongory_value(pool, "{\"age\": 1}"), NULL);
+  mongory_array *out = mongory_array_new(pool);
+  TEST_ASSERT_TRUE(mongory_matcher_filter_parallel(matcher, mongory_array_new(pool), 4, out));
+  TEST_ASSERT_EQUAL(0, out->count);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_filter_parallel_single_thread);
+  RUN_TEST(test_filter_parallel_numeric_range);
+  RUN_TEST(test_filter_parallel_array_fields);
+  RUN_TEST(test_filter_parallel_more_threads_than_chunks);
+  RUN_TEST(test_filter_parallel_empty_array);
+  return UNITY_END();
+}
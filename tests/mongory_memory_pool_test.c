@@ -58,6 +58,7 @@ void test_double_free_prevention(void) {
     char *string = (char *)MG_ALLOC(pool, 6);
     pool->free(pool);
     pool = NULL; // Prevent tearDown from freeing the pool again
+    mongory_memory_pool_cache_clear(); // Freed pools keep their chunks cached.
     free(string);
     TEST_FAIL_MESSAGE("Double free should have been prevented");
   } else {
@@ -143,6 +144,173 @@ void test_reset_does_not_clear_traced_memory(void) {
   TEST_ASSERT_EQUAL_PTR(extra_before, pool_ctx->extra);
 }
 
+void test_try_extend_grows_last_allocation_in_place(void) {
+  void *first = MG_ALLOC(pool, 32);
+  void *last = MG_ALLOC(pool, 20);
+  size_t used = pool_ctx->current->used;
+
+  TEST_ASSERT_FALSE(pool->try_extend(pool, first, 32, 64)); // Not the last block.
+  TEST_ASSERT_TRUE(pool->try_extend(pool, last, 20, 100));
+  TEST_ASSERT_EQUAL(used + 80, pool_ctx->current->used);
+  TEST_ASSERT_EQUAL_PTR((char *)last + 104, MG_ALLOC(pool, 8));
+
+  // A block cannot grow past the end of its chunk.
+  void *tail = MG_ALLOC(pool, 8);
+  TEST_ASSERT_FALSE(pool->try_extend(pool, tail, 8, pool_ctx->current->size));
+}
+
+void test_freed_pools_are_reused_by_the_thread(void) {
+  (void)MG_ALLOC(pool, 4000); // Grows a second, 4 KB chunk.
+  void *first_chunk = pool_ctx->head->ptr;
+  void *second_chunk = pool_ctx->head->next->ptr;
+  pool->free(pool);
+
+  pool = mongory_memory_pool_new();
+  pool_ctx = (mongory_memory_pool_ctx *)pool->ctx;
+  TEST_ASSERT_EQUAL_PTR(first_chunk, pool_ctx->head->ptr);
+  TEST_ASSERT_EQUAL(0, (int)pool_ctx->head->used);
+  TEST_ASSERT_EQUAL_PTR(first_chunk, MG_ALLOC(pool, 16));
+  TEST_ASSERT_EQUAL_PTR(second_chunk, MG_ALLOC(pool, 4000));
+
+  mongory_memory_pool_cache_clear();
+  TEST_ASSERT_NULL(mongory_chunk_cache_local.shells);
+  TEST_ASSERT_NULL(mongory_chunk_cache_local.chunks[0]);
+}
+
+void test_mark_and_rewind(void) {
+  void *kept = MG_ALLOC(pool, 64);
+  mongory_memory_pool_mark mark = pool->mark(pool);
+  void *scratch = MG_ALLOC(pool, 100);
+  (void)MG_ALLOC(pool, 5000); // Moves on to a new chunk.
+  TEST_ASSERT_NOT_EQUAL(pool_ctx->head, pool_ctx->current);
+
+  pool->rewind(pool, mark);
+  TEST_ASSERT_EQUAL_PTR(pool_ctx->head, pool_ctx->current);
+  TEST_ASSERT_EQUAL_PTR(scratch, MG_ALLOC(pool, 100));
+  TEST_ASSERT_TRUE((char *)kept < (char *)scratch);
+
+  // Growing again reuses the chunk given up by the rewind, from its start.
+  mongory_memory_node *second = pool_ctx->head->next;
+  TEST_ASSERT_EQUAL_PTR(second->ptr, MG_ALLOC(pool, 5000));
+  TEST_ASSERT_NULL(second->next);
+}
+
+void test_released_blocks_are_reused_by_size_class(void) {
+  void *a = MG_ALLOC(pool, 24);
+  void *b = MG_ALLOC(pool, 24);
+  void *big = MG_ALLOC(pool, 600);
+  (void)MG_ALLOC(pool, 8);
+  TEST_ASSERT_NULL(pool_ctx->slab);
+
+  // The last block of the chunk goes straight back to the chunk.
+  void *tail = MG_ALLOC(pool, 40);
+  size_t used = pool_ctx->current->used;
+  pool->release(pool, tail, 40);
+  TEST_ASSERT_EQUAL(used - 40, pool_ctx->current->used);
+  TEST_ASSERT_NULL(pool_ctx->slab);
+
+  pool->release(pool, a, 24);
+  pool->release(pool, b, 20); // Same 24-byte class once aligned.
+  pool->release(pool, big, 600);
+  TEST_ASSERT_NOT_NULL(pool_ctx->slab);
+  TEST_ASSERT_EQUAL_PTR(b, MG_ALLOC(pool, 24));
+  TEST_ASSERT_EQUAL_PTR(a, MG_ALLOC(pool, 17));
+  TEST_ASSERT_NOT_EQUAL(a, MG_ALLOC(pool, 24)); // The class is empty again.
+  TEST_ASSERT_NOT_EQUAL(big, MG_ALLOC(pool, 600)); // 600 bytes only serve requests up to 512.
+  TEST_ASSERT_EQUAL_PTR(big, MG_ALLOC(pool, 500));
+
+  // A reset forgets released blocks.
+  pool->release(pool, a, 24);
+  pool->reset(pool);
+  TEST_ASSERT_NULL(pool_ctx->slab);
+  TEST_ASSERT_EQUAL_PTR(pool_ctx->head->ptr, MG_ALLOC(pool, 24));
+}
+
+void test_large_chunks_are_mapped_and_sizes_capped(void) {
+  char *big = MG_ALLOC(pool, MONGORY_CHUNK_MMAP_THRESHOLD);
+  TEST_ASSERT_NOT_NULL(big);
+  TEST_ASSERT_TRUE(pool_ctx->current->size >= MONGORY_CHUNK_MMAP_THRESHOLD);
+  big[0] = 'a';
+  big[MONGORY_CHUNK_MMAP_THRESHOLD - 1] = 'z';
+
+  // A request beyond the cap gets a chunk of its own; growth resumes at the cap.
+  (void)MG_ALLOC(pool, MONGORY_MAX_CHUNK_SIZE + 8);
+  TEST_ASSERT_EQUAL(MONGORY_MAX_CHUNK_SIZE + 8, pool_ctx->current->size);
+  TEST_ASSERT_EQUAL(MONGORY_MAX_CHUNK_SIZE, pool_ctx->chunk_size);
+  (void)MG_ALLOC(pool, 16);
+  TEST_ASSERT_EQUAL(MONGORY_MAX_CHUNK_SIZE, pool_ctx->current->size);
+  TEST_ASSERT_EQUAL(MONGORY_MAX_CHUNK_SIZE, pool_ctx->chunk_size);
+}
+
+typedef struct counting_allocator_stats {
+  int allocs;
+  int frees;
+  size_t live_bytes;
+} counting_allocator_stats;
+
+static void *counting_alloc(void *ctx, size_t size) {
+  counting_allocator_stats *stats = ctx;
+  stats->allocs++;
+  stats->live_bytes += size;
+  return malloc(size);
+}
+
+static void counting_free(void *ctx, void *ptr, size_t size) {
+  counting_allocator_stats *stats = ctx;
+  stats->frees++;
+  stats->live_bytes -= size;
+  free(ptr);
+}
+
+void test_pool_with_custom_allocator(void) {
+  counting_allocator_stats stats = {0, 0, 0};
+  mongory_allocator allocator = {counting_alloc, counting_free, &stats};
+  mongory_memory_pool *custom = mongory_memory_pool_new_with_allocator(&allocator);
+  TEST_ASSERT_NOT_NULL(custom);
+  TEST_ASSERT_EQUAL(3, stats.allocs); // Pool structure, chunk node and chunk.
+  (void)MG_ALLOC(custom, 64);
+  (void)MG_ALLOC(custom, MONGORY_CHUNK_MMAP_THRESHOLD); // Not mapped: the allocator provides it.
+  custom->trace(custom, malloc(16), 16);
+  TEST_ASSERT_EQUAL(6, stats.allocs);
+  custom->free(custom);
+  TEST_ASSERT_EQUAL(stats.allocs, stats.frees);
+  TEST_ASSERT_EQUAL(0, (int)stats.live_bytes);
+
+  // The default allocator backs pools created without one.
+  mongory_allocator_set(&allocator);
+  custom = mongory_memory_pool_new();
+  TEST_ASSERT_EQUAL_PTR(&allocator, ((mongory_memory_pool_ctx *)custom->ctx)->allocator);
+  mongory_allocator_set(NULL);
+  custom->free(custom);
+  TEST_ASSERT_EQUAL(stats.allocs, stats.frees);
+  TEST_ASSERT_EQUAL(0, (int)stats.live_bytes);
+}
+
+void test_pool_in_caller_buffer(void) {
+  char buffer[512];
+  mongory_memory_pool *local = mongory_memory_pool_init_with_buffer(buffer + 1, sizeof(buffer) - 1);
+  TEST_ASSERT_NOT_NULL(local);
+  TEST_ASSERT_TRUE((char *)local >= buffer && (char *)local < buffer + sizeof(buffer));
+  mongory_memory_pool_ctx *local_ctx = (mongory_memory_pool_ctx *)local->ctx;
+  size_t room = local_ctx->head->size;
+  TEST_ASSERT_TRUE(room > 256);
+
+  char *small = MG_ALLOC(local, 64);
+  TEST_ASSERT_TRUE(small > buffer && small + 64 <= buffer + sizeof(buffer));
+  TEST_ASSERT_EQUAL(0, (uintptr_t)small % 8);
+  TEST_ASSERT_NULL(local_ctx->head->next);
+
+  // Overflowing the buffer moves on to a heap chunk.
+  char *spill = MG_ALLOC(local, room);
+  TEST_ASSERT_NOT_NULL(local_ctx->head->next);
+  TEST_ASSERT_TRUE(spill < buffer || spill >= buffer + sizeof(buffer));
+  local->reset(local);
+  TEST_ASSERT_EQUAL_PTR(small, MG_ALLOC(local, 64));
+  local->free(local);
+
+  TEST_ASSERT_NULL(mongory_memory_pool_init_with_buffer(buffer, 64));
+}
+
 int main(void) {
   UNITY_BEGIN();
   mongory_init();
@@ -155,6 +323,13 @@ int main(void) {
   RUN_TEST(test_reset_allows_reuse_from_start);
   RUN_TEST(test_multiple_resets_are_idempotent);
   RUN_TEST(test_reset_does_not_clear_traced_memory);
+  RUN_TEST(test_try_extend_grows_last_allocation_in_place);
+  RUN_TEST(test_freed_pools_are_reused_by_the_thread);
+  RUN_TEST(test_mark_and_rewind);
+  RUN_TEST(test_released_blocks_are_reused_by_size_class);
+  RUN_TEST(test_large_chunks_are_mapped_and_sizes_capped);
+  RUN_TEST(test_pool_with_custom_allocator);
+  RUN_TEST(test_pool_in_caller_buffer);
   mongory_cleanup();
   return UNITY_END();
 }
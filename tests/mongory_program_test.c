@@ -0,0 +1,70 @@
+#include "../src/matchers/composite_matcher.h"
+#include "../src/test_helper/test_helper.h"
+#include "mongory-core.h"
+#include "unity.h"
+
+void setUp(void) { setup_test_environment(); }
+
+void tearDown(void) { teardown_test_environment(); }
+
+void test_program_and_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_and_new, .use_program = true};
+  execute_test_case("tests/jsons/and_matcher_test.json", &context);
+}
+
+void test_program_or_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_or_new, .use_program = true};
+  execute_test_case("tests/jsons/or_matcher_test.json", &context);
+}
+
+void test_program_elem_match_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_elem_match_new, .use_program = true};
+  execute_test_case("tests/jsons/elem_match_matcher_test.json", &context);
+}
+
+void test_program_every_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_every_new, .use_program = true};
+  execute_test_case("tests/jsons/every_matcher_test.json", &context);
+}
+
+void test_program_table_cond_matcher(void) {
+  mongory_test_context context = {.matcher_build_func = mongory_matcher_table_cond_new, .use_program = true};
+  execute_test_case("tests/jsons/table_condition_matcher_test.json", &context);
+}
+
+void test_program_call_fallback(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *condition =
+      json_string_to_mongory_value(pool, "{\"tags\": {\"$in\": [\"a\", \"b\"]}, \"age\": {\"$exists\": true}}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+  mongory_program *program = mongory_program_compile(pool, matcher);
+  TEST_ASSERT_NOT_NULL(program);
+
+  mongory_value *hit = json_string_to_mongory_value(pool, "{\"tags\": [\"x\", \"b\"], \"age\": 3}");
+  mongory_value *miss = json_string_to_mongory_value(pool, "{\"tags\": [\"x\"], \"age\": 3}");
+  mongory_value *missing = json_string_to_mongory_value(pool, "{\"tags\": \"a\"}");
+  TEST_ASSERT_TRUE(mongory_program_match(program, hit));
+  TEST_ASSERT_FALSE(mongory_program_match(program, miss));
+  TEST_ASSERT_FALSE(mongory_program_match(program, missing));
+  TEST_ASSERT_FALSE(mongory_program_match(program, NULL));
+}
+
+void test_program_compile_null_matcher(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  TEST_ASSERT_NULL(mongory_program_compile(pool, NULL));
+  TEST_ASSERT_NOT_NULL(pool->error);
+  TEST_ASSERT_EQUAL(MONGORY_ERROR_INVALID_ARGUMENT, pool->error->type);
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_program_and_matcher);
+  RUN_TEST(test_program_or_matcher);
+  RUN_TEST(test_program_elem_match_matcher);
+  RUN_TEST(test_program_every_matcher);
+  RUN_TEST(test_program_table_cond_matcher);
+  RUN_TEST(test_program_call_fallback);
+  RUN_TEST(test_program_compile_null_matcher);
+  return UNITY_END();
+}
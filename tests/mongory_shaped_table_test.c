@@ -0,0 +1,157 @@
+#include "../src/foundations/shape_private.h"
+#include "../src/foundations/string_buffer.h"
+#include "../src/matchers/literal_matcher.h"
+#include "../src/test_helper/test_helper.h"
+#include "mongory-core.h"
+#include "unity.h"
+#include <stdio.h>
+
+void setUp(void) { setup_test_environment(); }
+
+void tearDown(void) { teardown_test_environment(); }
+
+static mongory_table *shaped_person(mongory_memory_pool *pool, int age, char *name) {
+  mongory_table *table = mongory_table_new_shaped(pool);
+  table->set(table, "age", mongory_value_wrap_i(pool, age));
+  table->set(table, "name", mongory_value_wrap_s(pool, name));
+  return table;
+}
+
+static bool collect_keys(char *key, mongory_value *value, void *acc) {
+  (void)value;
+  mongory_string_buffer_append((mongory_string_buffer *)acc, key);
+  mongory_string_buffer_append((mongory_string_buffer *)acc, ",");
+  return true;
+}
+
+void test_shaped_tables_share_shapes(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_table *a = shaped_person(pool, 1, "a");
+  mongory_table *b = shaped_person(pool, 2, "b");
+  mongory_table *c = mongory_table_new_shaped(pool);
+  c->set(c, "name", mongory_value_wrap_s(pool, "c"));
+  c->set(c, "age", mongory_value_wrap_i(pool, 3));
+
+  TEST_ASSERT_NOT_NULL(mongory_table_shape(a));
+  TEST_ASSERT_EQUAL_PTR(mongory_table_shape(a), mongory_table_shape(b));
+  TEST_ASSERT_TRUE(mongory_table_shape(a) != mongory_table_shape(c));
+  TEST_ASSERT_EQUAL(2, mongory_table_shape(c)->count);
+  TEST_ASSERT_NULL(mongory_table_shape(mongory_table_new(pool)));
+}
+
+void test_shaped_table_operations(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_table *table = shaped_person(pool, 30, "John");
+  TEST_ASSERT_EQUAL(2, table->count);
+  TEST_ASSERT_EQUAL(30, table->get(table, "age")->data.i);
+  TEST_ASSERT_EQUAL_STRING("John", table->get(table, "name")->data.s);
+  TEST_ASSERT_NULL(table->get(table, "missing"));
+
+  mongory_shape *before = mongory_table_shape(table);
+  TEST_ASSERT_TRUE(table->set(table, "age", mongory_value_wrap_i(pool, 31)));
+  TEST_ASSERT_EQUAL_PTR(before, mongory_table_shape(table));
+  TEST_ASSERT_EQUAL(31, table->get(table, "age")->data.i);
+
+  TEST_ASSERT_TRUE(table->del(table, "age"));
+  TEST_ASSERT_FALSE(table->del(table, "age"));
+  TEST_ASSERT_NULL(table->get(table, "age"));
+  TEST_ASSERT_EQUAL(1, table->count);
+
+  for (int i = 0; i < 20; i++) {
+    char key[16];
+    snprintf(key, sizeof(key), "k%d", i);
+    TEST_ASSERT_TRUE(table->set(table, key, mongory_value_wrap_i(pool, i)));
+  }
+  TEST_ASSERT_TRUE(table->set(table, "age", mongory_value_wrap_i(pool, 32)));
+  TEST_ASSERT_EQUAL(22, table->count);
+  TEST_ASSERT_EQUAL(19, table->get(table, "k19")->data.i);
+
+  mongory_string_buffer *keys = mongory_string_buffer_new(pool);
+  mongory_table *small = shaped_person(pool, 1, "x");
+  small->set(small, "city", mongory_value_wrap_s(pool, "y"));
+  small->del(small, "name");
+  TEST_ASSERT_TRUE(small->each(small, keys, collect_keys));
+  TEST_ASSERT_EQUAL_STRING("age,city,", mongory_string_buffer_cstr(keys));
+}
+
+void test_field_matcher_inline_cache(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_matcher *matcher = mongory_matcher_field_new(pool, "name", mongory_value_wrap_s(pool, "b"), NULL);
+  mongory_field_matcher *field_matcher = (mongory_field_matcher *)matcher;
+  mongory_table *a = shaped_person(pool, 1, "a");
+  mongory_table *b = shaped_person(pool, 2, "b");
+
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_t(pool, a)));
+  TEST_ASSERT_EQUAL_PTR(mongory_table_shape(a), field_matcher->cache[0].shape);
+  TEST_ASSERT_EQUAL(1, field_matcher->cache[0].index);
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_t(pool, b)));
+  TEST_ASSERT_EQUAL(1, field_matcher->cache_next);
+
+  // A shape without the field is cached as a miss.
+  mongory_table *other = mongory_table_new_shaped(pool);
+  other->set(other, "title", mongory_value_wrap_s(pool, "b"));
+  TEST_ASSERT_FALSE(matcher->match(matcher, mongory_value_wrap_t(pool, other)));
+  TEST_ASSERT_EQUAL(MONGORY_SHAPE_NOT_FOUND, field_matcher->cache[1].index);
+
+  // Frozen matchers keep answering correctly without filling the cache.
+  TEST_ASSERT_TRUE(mongory_matcher_freeze(matcher));
+  mongory_table *reordered = mongory_table_new_shaped(pool);
+  reordered->set(reordered, "name", mongory_value_wrap_s(pool, "b"));
+  reordered->set(reordered, "age", mongory_value_wrap_i(pool, 3));
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_t(pool, reordered)));
+  TEST_ASSERT_EQUAL(2, field_matcher->cache_next);
+}
+
+void test_matcher_on_shaped_records(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *condition = json_string_to_mongory_value(pool, "{\"age\": {\"$gte\": 18}, \"name\": {\"$in\": [\"a\", \"c\"]}}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+
+  char *names[] = {"a", "b", "c"};
+  size_t matched = 0;
+  for (int i = 0; i < 60; i++) {
+    mongory_table *record = shaped_person(pool, i, names[i % 3]);
+    if (i % 2)
+      record->set(record, "extra", mongory_value_wrap_b(pool, true));
+    bool expected = i >= 18 && i % 3 != 1;
+    TEST_ASSERT_EQUAL(expected, matcher->match(matcher, mongory_value_wrap_t(pool, record)));
+    matched += expected;
+  }
+  TEST_ASSERT_EQUAL(28, matched);
+}
+
+void test_shaped_table_falls_back_past_key_limit(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_table *table = mongory_table_new_shaped(pool);
+  char key[16];
+  for (int i = 0; i < 100; i++) {
+    snprintf(key, sizeof(key), "k%d", i);
+    table->set(table, key, mongory_value_wrap_i(pool, i));
+  }
+  TEST_ASSERT_NULL(mongory_table_shape(table));
+  TEST_ASSERT_EQUAL(100, table->count);
+  for (int i = 0; i < 100; i++) {
+    snprintf(key, sizeof(key), "k%d", i);
+    mongory_value *value = table->get(table, key);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL(i, value->data.i);
+  }
+  TEST_ASSERT_TRUE(table->del(table, "k0"));
+  TEST_ASSERT_NULL(table->get(table, "k0"));
+  TEST_ASSERT_EQUAL(99, table->count);
+
+  mongory_value *condition = json_string_to_mongory_value(pool, "{\"k99\": 99}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  TEST_ASSERT_TRUE(matcher->match(matcher, mongory_value_wrap_t(pool, table)));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_shaped_tables_share_shapes);
+  RUN_TEST(test_shaped_table_operations);
+  RUN_TEST(test_field_matcher_inline_cache);
+  RUN_TEST(test_matcher_on_shaped_records);
+  RUN_TEST(test_shaped_table_falls_back_past_key_limit);
+  return UNITY_END();
+}
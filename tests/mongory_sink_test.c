@@ -0,0 +1,124 @@
+#include "../src/test_helper/test_helper.h"
+#include "mongory-core.h"
+#include "unity.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+void setUp(void) { setup_test_environment(); }
+
+void tearDown(void) { teardown_test_environment(); }
+
+static bool count_chunks(mongory_sink *sink, const char *data, size_t len) {
+  (void)data;
+  (void)len;
+  (*(int *)sink->ctx)++;
+  return true;
+}
+
+void test_buffer_sink_truncates(void) {
+  char buffer[8];
+  mongory_sink sink;
+  mongory_sink_buffer_init(&sink, buffer, sizeof(buffer));
+  TEST_ASSERT_TRUE(mongory_sink_puts(&sink, "abc"));
+  TEST_ASSERT_FALSE(mongory_sink_puts(&sink, "defghij"));
+  TEST_ASSERT_TRUE(sink.failed);
+  TEST_ASSERT_EQUAL_STRING("abcdefg", buffer);
+  TEST_ASSERT_EQUAL(7, sink.size);
+  TEST_ASSERT_FALSE(mongory_sink_puts(&sink, "k"));
+  TEST_ASSERT_EQUAL_STRING("abcdefg", buffer);
+}
+
+void test_callback_sink(void) {
+  int chunks = 0;
+  mongory_sink sink;
+  mongory_sink_init(&sink, count_chunks, &chunks);
+  mongory_sink_puts(&sink, "a");
+  mongory_sink_puts(&sink, "");
+  mongory_sink_write_int(&sink, 42);
+  TEST_ASSERT_EQUAL(2, chunks);
+  TEST_ASSERT_EQUAL(3, sink.size);
+}
+
+void test_number_formatting(void) {
+  char buffer[64];
+  mongory_sink sink;
+  struct {
+    double d;
+    const char *expected;
+  } doubles[] = {{1.5, "1.5"}, {3.0, "3.0"}, {-0.0, "-0.0"}, {0.1, "0.1"}, {-2.25, "-2.25"},
+                 {1e300, "1e+300"}, {0.30000000000000004, "0.30000000000000004"}, {NAN, "null"}, {INFINITY, "null"}};
+  for (size_t i = 0; i < sizeof(doubles) / sizeof(doubles[0]); i++) {
+    mongory_sink_buffer_init(&sink, buffer, sizeof(buffer));
+    TEST_ASSERT_TRUE(mongory_sink_write_double(&sink, doubles[i].d));
+    TEST_ASSERT_EQUAL_STRING(doubles[i].expected, buffer);
+  }
+
+  mongory_sink_buffer_init(&sink, buffer, sizeof(buffer));
+  mongory_sink_write_int(&sink, INT64_MIN);
+  mongory_sink_write(&sink, " ", 1);
+  mongory_sink_write_int(&sink, 0);
+  mongory_sink_write(&sink, " ", 1);
+  mongory_sink_write_int(&sink, INT64_MAX);
+  TEST_ASSERT_EQUAL_STRING("-9223372036854775808 0 9223372036854775807", buffer);
+}
+
+void test_string_escaping(void) {
+  char buffer[64];
+  mongory_sink sink;
+  mongory_sink_buffer_init(&sink, buffer, sizeof(buffer));
+  TEST_ASSERT_TRUE(mongory_sink_write_string(&sink, "a\"b\\c\nd\x01\0e", 10));
+  TEST_ASSERT_EQUAL_STRING("\"a\\\"b\\\\c\\nd\\u0001\\u0000e\"", buffer);
+}
+
+void test_value_serialize(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *value = json_string_to_mongory_value(pool, "{\"a\": [1, 2.5, \"x\\ty\", null, {\"b\": true}]}");
+  char buffer[128];
+  mongory_sink sink;
+  mongory_sink_buffer_init(&sink, buffer, sizeof(buffer));
+  TEST_ASSERT_TRUE(mongory_value_serialize(value, &sink));
+  TEST_ASSERT_EQUAL_STRING("{\"a\":[1,2.5,\"x\\ty\",null,{\"b\":true}]}", buffer);
+  TEST_ASSERT_EQUAL_STRING(buffer, mongory_value_to_str(value, pool));
+
+  // A value that does not fit fails the sink but leaves a terminated prefix.
+  char small[6];
+  mongory_sink_buffer_init(&sink, small, sizeof(small));
+  TEST_ASSERT_FALSE(mongory_value_serialize(value, &sink));
+  TEST_ASSERT_EQUAL_STRING("{\"a\":", small);
+}
+
+void test_explain_and_trace_to_sink(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *condition = json_string_to_mongory_value(pool, "{\"age\": {\"$gt\": 18}}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  char buffer[512];
+  mongory_sink sink;
+
+  mongory_sink_buffer_init(&sink, buffer, sizeof(buffer));
+  mongory_matcher_explain_to_sink(matcher, &sink, pool);
+  TEST_ASSERT_FALSE(sink.failed);
+  TEST_ASSERT_NOT_NULL(strstr(buffer, "Field: \"age\", to match: {\"$gt\":18}\n"));
+  TEST_ASSERT_NULL(sink.pool);
+
+  mongory_value *record = json_string_to_mongory_value(pool, "{\"age\": 20}");
+  mongory_matcher_enable_trace(matcher, pool);
+  TEST_ASSERT_TRUE(mongory_matcher_match(matcher, record));
+  mongory_sink_buffer_init(&sink, buffer, sizeof(buffer));
+  mongory_matcher_print_trace_to_sink(matcher, &sink);
+  mongory_matcher_disable_trace(matcher);
+  TEST_ASSERT_FALSE(sink.failed);
+  TEST_ASSERT_NOT_NULL(strstr(buffer, ", field: \"age\", condition: {\"$gt\":18}, record: {\"age\":20}\n"));
+  TEST_ASSERT_NOT_NULL(strstr(buffer, "\n  Gt: "));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_buffer_sink_truncates);
+  RUN_TEST(test_callback_sink);
+  RUN_TEST(test_number_formatting);
+  RUN_TEST(test_string_escaping);
+  RUN_TEST(test_value_serialize);
+  RUN_TEST(test_explain_and_trace_to_sink);
+  return UNITY_END();
+}
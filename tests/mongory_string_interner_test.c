@@ -0,0 +1,93 @@
+#include "../src/test_helper/test_helper.h"
+#include "mongory-core.h"
+#include "unity.h"
+#include <stdio.h>
+#include <string.h>
+
+void setUp(void) { setup_test_environment(); }
+
+void tearDown(void) { teardown_test_environment(); }
+
+void test_interner_keeps_one_copy(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_string_interner *interner = mongory_string_interner_new(pool);
+  char buffer[] = "active,inactive";
+  mongory_value *a = mongory_string_interner_wrap(interner, pool, buffer, 6);
+  mongory_value *b = mongory_string_interner_wrap(interner, pool, "active", 6);
+  mongory_value *c = mongory_string_interner_wrap(interner, pool, buffer + 7, 8);
+
+  TEST_ASSERT_TRUE(a->interned);
+  TEST_ASSERT_EQUAL_PTR(a->data.s, b->data.s);
+  TEST_ASSERT_TRUE(a->data.s != buffer);
+  TEST_ASSERT_EQUAL_STRING("active", a->data.s);
+  TEST_ASSERT_EQUAL_STRING("inactive", c->data.s);
+  TEST_ASSERT_EQUAL(2, mongory_string_interner_count(interner));
+
+  TEST_ASSERT_TRUE(mongory_value_equal(a, b));
+  TEST_ASSERT_FALSE(mongory_value_equal(a, c));
+  TEST_ASSERT_EQUAL(-1, mongory_value_compare(a, c));
+}
+
+void test_interner_grows(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_string_interner *interner = mongory_string_interner_new(pool);
+  mongory_value *first[200];
+  for (int i = 0; i < 200; i++) {
+    char key[16];
+    int len = snprintf(key, sizeof(key), "code-%d", i);
+    first[i] = mongory_string_interner_wrap(interner, pool, key, (size_t)len);
+  }
+  TEST_ASSERT_EQUAL(200, mongory_string_interner_count(interner));
+  for (int i = 0; i < 200; i++) {
+    char key[16];
+    int len = snprintf(key, sizeof(key), "code-%d", i);
+    mongory_value *again = mongory_string_interner_wrap(interner, pool, key, (size_t)len);
+    TEST_ASSERT_EQUAL_PTR(first[i]->data.s, again->data.s);
+  }
+  TEST_ASSERT_EQUAL(200, mongory_string_interner_count(interner));
+}
+
+void test_interned_strings_mix_with_plain_strings(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_string_interner *interner = mongory_string_interner_new(pool);
+  mongory_string_interner *other = mongory_string_interner_new(pool);
+  mongory_value *interned = mongory_string_interner_wrap(interner, pool, "US", 2);
+  mongory_value *plain = mongory_value_wrap_s(pool, "US");
+
+  TEST_ASSERT_FALSE(plain->interned);
+  TEST_ASSERT_TRUE(mongory_value_equal(interned, plain));
+  TEST_ASSERT_TRUE(mongory_value_equal(plain, interned));
+  // Equal strings from two interners are still equal.
+  TEST_ASSERT_TRUE(mongory_value_equal(interned, mongory_string_interner_wrap(other, pool, "US", 2)));
+  TEST_ASSERT_FALSE(mongory_value_equal(interned, mongory_string_interner_wrap(other, pool, "TW", 2)));
+}
+
+void test_matchers_on_interned_strings(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_string_interner *interner = mongory_string_interner_new(pool);
+  mongory_value *condition = json_string_to_mongory_value(pool, "{\"status\": \"active\", \"country\": {\"$in\": [\"US\", \"TW\"]}}");
+  mongory_matcher *matcher = mongory_matcher_new(pool, condition, NULL);
+  TEST_ASSERT_NOT_NULL(matcher);
+
+  char *statuses[] = {"active", "inactive"};
+  char *countries[] = {"US", "JP", "TW"};
+  for (int i = 0; i < 6; i++) {
+    char *status = statuses[i % 2];
+    char *country = countries[i % 3];
+    mongory_table *record = mongory_table_new(pool);
+    record->set(record, "status", mongory_string_interner_wrap(interner, pool, status, strlen(status)));
+    record->set(record, "country", mongory_string_interner_wrap(interner, pool, country, strlen(country)));
+    bool expected = i % 2 == 0 && i % 3 != 1;
+    TEST_ASSERT_EQUAL(expected, matcher->match(matcher, mongory_value_wrap_t(pool, record)));
+  }
+  TEST_ASSERT_EQUAL(5, mongory_string_interner_count(interner));
+}
+
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_interner_keeps_one_copy);
+  RUN_TEST(test_interner_grows);
+  RUN_TEST(test_interned_strings_mix_with_plain_strings);
+  RUN_TEST(test_matchers_on_interned_strings);
+  return UNITY_END();
+}
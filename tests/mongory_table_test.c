@@ -2,6 +2,7 @@
 #include <mongory-core.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 mongory_memory_pool *pool;
 mongory_table *table;
@@ -85,6 +86,152 @@ void test_table_get_nonexistent(void) {
   TEST_ASSERT_NULL(retrieved);
 }
 
+void test_table_grows_and_deletes(void) {
+  char key[32];
+  for (int i = 0; i < 5000; i++) {
+    snprintf(key, sizeof(key), "key-%d", i);
+    TEST_ASSERT_TRUE(table->set(table, key, mongory_value_wrap_i(pool, i)));
+  }
+  TEST_ASSERT_EQUAL(5000, table->count);
+  for (int i = 0; i < 5000; i += 2) {
+    snprintf(key, sizeof(key), "key-%d", i);
+    TEST_ASSERT_TRUE(table->del(table, key));
+  }
+  TEST_ASSERT_EQUAL(2500, table->count);
+  for (int i = 0; i < 5000; i++) {
+    snprintf(key, sizeof(key), "key-%d", i);
+    mongory_value *value = table->get(table, key);
+    if (i % 2 == 0) {
+      TEST_ASSERT_NULL(value);
+    } else {
+      TEST_ASSERT_NOT_NULL(value);
+      TEST_ASSERT_EQUAL(i, value->data.i);
+    }
+  }
+  // Reinserting reuses the deleted slots.
+  for (int i = 0; i < 5000; i += 2) {
+    snprintf(key, sizeof(key), "key-%d", i);
+    TEST_ASSERT_TRUE(table->set(table, key, mongory_value_wrap_i(pool, -i)));
+  }
+  int count = 0;
+  TEST_ASSERT_TRUE(table->each(table, &count, test_table_each_callback));
+  TEST_ASSERT_EQUAL(5000, count);
+  TEST_ASSERT_EQUAL(-4998, table->get(table, "key-4998")->data.i);
+}
+
+void test_table_keys_sharing_prefixes(void) {
+  table->set(table, "customer.billing_address_line_1", mongory_value_wrap_i(pool, 1));
+  table->set(table, "customer.billing_address_line_2", mongory_value_wrap_i(pool, 2));
+  table->set(table, "customer.billing_address_line", mongory_value_wrap_i(pool, 3));
+  table->set(table, "", mongory_value_wrap_i(pool, 4));
+
+  TEST_ASSERT_EQUAL(1, table->get(table, "customer.billing_address_line_1")->data.i);
+  TEST_ASSERT_EQUAL(2, table->get(table, "customer.billing_address_line_2")->data.i);
+  TEST_ASSERT_EQUAL(3, table->get(table, "customer.billing_address_line")->data.i);
+  TEST_ASSERT_EQUAL(4, table->get(table, "")->data.i);
+  TEST_ASSERT_NULL(table->get(table, "customer.billing_address_line_"));
+}
+
+void test_table_new_with_capacity(void) {
+  mongory_table *presized = mongory_table_new_with_capacity(pool, 1000);
+  TEST_ASSERT_NOT_NULL(presized);
+  TEST_ASSERT_EQUAL(0, presized->count);
+  char key[32];
+  for (int i = 0; i < 1000; i++) {
+    snprintf(key, sizeof(key), "k%d", i);
+    TEST_ASSERT_TRUE(presized->set(presized, key, mongory_value_wrap_i(pool, i)));
+  }
+  TEST_ASSERT_EQUAL(1000, presized->count);
+  TEST_ASSERT_EQUAL(999, presized->get(presized, "k999")->data.i);
+  TEST_ASSERT_NULL(pool->error);
+}
+
+void test_table_get_hashed(void) {
+  mongory_value *value = mongory_value_wrap_i(pool, 7);
+  table->set(table, "customer.billing_address_line_1", value);
+  char *key = "customer.billing_address_line_1";
+  uint64_t hash = mongory_table_hash_key(key, strlen(key));
+
+  TEST_ASSERT_NOT_NULL(table->get_hashed);
+  TEST_ASSERT_EQUAL_PTR(value, table->get_hashed(table, key, strlen(key), hash));
+  TEST_ASSERT_EQUAL_PTR(value, mongory_table_get_with_hash(table, key, strlen(key), hash));
+  TEST_ASSERT_NULL(table->get_hashed(table, "missing", 7, mongory_table_hash_key("missing", 7)));
+}
+
+static mongory_value *test_table_fixed_get(mongory_table *self, char *key) {
+  (void)self;
+  return strcmp(key, "only") == 0 ? mongory_value_wrap_i(pool, 1) : NULL;
+}
+
+void test_table_get_with_hash_falls_back_to_get(void) {
+  mongory_table external = *table;
+  external.get = test_table_fixed_get;
+  external.get_hashed = NULL;
+  TEST_ASSERT_NOT_NULL(mongory_table_get_with_hash(&external, "only", 4, mongory_table_hash_key("only", 4)));
+  TEST_ASSERT_NULL(mongory_table_get_with_hash(&external, "other", 5, mongory_table_hash_key("other", 5)));
+}
+
+static bool test_table_collect_keys(char *key, mongory_value *value, void *acc) {
+  (void)value;
+  strcat((char *)acc, key);
+  return true;
+}
+
+void test_small_table_keeps_insertion_order(void) {
+  table->set(table, "c", mongory_value_wrap_i(pool, 1));
+  table->set(table, "a", mongory_value_wrap_i(pool, 2));
+  table->set(table, "d", mongory_value_wrap_i(pool, 3));
+  table->set(table, "b", mongory_value_wrap_i(pool, 4));
+  table->set(table, "e", mongory_value_wrap_i(pool, 5)); // Grows the flat array.
+  table->set(table, "a", mongory_value_wrap_i(pool, 6)); // Updates in place.
+  TEST_ASSERT_TRUE(table->del(table, "d"));
+  TEST_ASSERT_FALSE(table->del(table, "d"));
+
+  char keys[16] = "";
+  TEST_ASSERT_TRUE(table->each(table, keys, test_table_collect_keys));
+  TEST_ASSERT_EQUAL_STRING("cabe", keys);
+  TEST_ASSERT_EQUAL(4, table->count);
+  TEST_ASSERT_EQUAL(6, table->get(table, "a")->data.i);
+  TEST_ASSERT_NULL(table->get(table, "d"));
+}
+
+void test_small_table_promotes_to_hash_table(void) {
+  char key[8];
+  mongory_table_get_func small_get = table->get;
+  for (int i = 0; i < 8; i++) {
+    snprintf(key, sizeof(key), "k%d", i);
+    TEST_ASSERT_TRUE(table->set(table, key, mongory_value_wrap_i(pool, i)));
+  }
+  TEST_ASSERT_TRUE(table->get == small_get);
+  TEST_ASSERT_TRUE(table->set(table, "k8", mongory_value_wrap_i(pool, 8)));
+  TEST_ASSERT_TRUE(table->get != small_get);
+  TEST_ASSERT_EQUAL(9, table->count);
+  for (int i = 0; i < 9; i++) {
+    snprintf(key, sizeof(key), "k%d", i);
+    TEST_ASSERT_EQUAL(i, mongory_table_get_with_hash(table, key, strlen(key), mongory_table_hash_key(key, strlen(key)))->data.i);
+  }
+  int count = 0;
+  TEST_ASSERT_TRUE(table->each(table, &count, test_table_each_callback));
+  TEST_ASSERT_EQUAL(9, count);
+}
+
+void test_deleted_keys_are_reused(void) {
+  table->set(table, "kept", mongory_value_wrap_i(pool, 0));
+  mongory_value *value = mongory_value_wrap_i(pool, 1);
+  table->set(table, "churn", value);
+  TEST_ASSERT_TRUE(table->del(table, "churn"));
+  table->set(table, "churn", value);
+  mongory_memory_pool_mark before = pool->mark(pool);
+  for (int i = 0; i < 100; i++) {
+    TEST_ASSERT_TRUE(table->del(table, "churn"));
+    TEST_ASSERT_TRUE(table->set(table, "churn", value));
+  }
+  mongory_memory_pool_mark after = pool->mark(pool);
+  TEST_ASSERT_EQUAL_PTR(before.chunk, after.chunk);
+  TEST_ASSERT_EQUAL(before.offset, after.offset);
+  TEST_ASSERT_EQUAL(2, table->count);
+}
+
 int main(void) {
   UNITY_BEGIN();
   mongory_init();
@@ -92,6 +239,14 @@ int main(void) {
   RUN_TEST(test_table_delete);
   RUN_TEST(test_table_each);
   RUN_TEST(test_table_get_nonexistent);
+  RUN_TEST(test_table_grows_and_deletes);
+  RUN_TEST(test_table_keys_sharing_prefixes);
+  RUN_TEST(test_table_new_with_capacity);
+  RUN_TEST(test_table_get_hashed);
+  RUN_TEST(test_table_get_with_hash_falls_back_to_get);
+  RUN_TEST(test_small_table_keeps_insertion_order);
+  RUN_TEST(test_small_table_promotes_to_hash_table);
+  RUN_TEST(test_deleted_keys_are_reused);
   mongory_cleanup();
   return UNITY_END();
 }
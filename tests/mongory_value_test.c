@@ -13,7 +13,9 @@ void test_boolean_value(void) {
   mongory_memory_pool *pool = get_test_pool();
   mongory_value *value_b = mongory_value_wrap_b(pool, true);
   TEST_ASSERT_NOT_NULL(value_b);
+#ifndef MONGORY_COMPACT_VALUE
   TEST_ASSERT_EQUAL(pool, value_b->pool);
+#endif
   TEST_ASSERT_EQUAL_STRING("Bool", mongory_type_to_string(value_b));
   TEST_ASSERT_TRUE(*(bool *)mongory_value_extract(value_b));
 }
@@ -22,7 +24,9 @@ void test_integer_value(void) {
   mongory_memory_pool *pool = get_test_pool();
   mongory_value *value_i = mongory_value_wrap_i(pool, 123);
   TEST_ASSERT_NOT_NULL(value_i);
+#ifndef MONGORY_COMPACT_VALUE
   TEST_ASSERT_EQUAL(pool, value_i->pool);
+#endif
   TEST_ASSERT_EQUAL_STRING("Int", mongory_type_to_string(value_i));
   TEST_ASSERT_EQUAL(123, *(int *)mongory_value_extract(value_i));
 }
@@ -32,7 +36,9 @@ void test_double_value(void) {
   double test_value = 0.123;
   mongory_value *value_d = mongory_value_wrap_d(pool, test_value);
   TEST_ASSERT_NOT_NULL(value_d);
+#ifndef MONGORY_COMPACT_VALUE
   TEST_ASSERT_EQUAL(pool, value_d->pool);
+#endif
   TEST_ASSERT_EQUAL_STRING("Double", mongory_type_to_string(value_d));
   double extracted_value = *(double *)mongory_value_extract(value_d);
   TEST_ASSERT_TRUE(extracted_value >= test_value - 0.0001 && extracted_value <= test_value + 0.0001);
@@ -42,7 +48,9 @@ void test_string_value(void) {
   mongory_memory_pool *pool = get_test_pool();
   mongory_value *value_s = mongory_value_wrap_s(pool, "Hello");
   TEST_ASSERT_NOT_NULL(value_s);
+#ifndef MONGORY_COMPACT_VALUE
   TEST_ASSERT_EQUAL(pool, value_s->pool);
+#endif
   TEST_ASSERT_EQUAL_STRING("String", mongory_type_to_string(value_s));
   TEST_ASSERT_EQUAL_STRING("Hello", *(char **)mongory_value_extract(value_s));
 }
@@ -51,11 +59,15 @@ void test_array_value(void) {
   mongory_memory_pool *pool = get_test_pool();
   mongory_array *array = mongory_array_new(pool);
   TEST_ASSERT_NOT_NULL(array);
+#ifndef MONGORY_COMPACT_VALUE
   TEST_ASSERT_EQUAL(pool, array->pool);
+#endif
 
   mongory_value *value_a = mongory_value_wrap_a(pool, array);
   TEST_ASSERT_NOT_NULL(value_a);
+#ifndef MONGORY_COMPACT_VALUE
   TEST_ASSERT_EQUAL(pool, value_a->pool);
+#endif
   TEST_ASSERT_EQUAL_STRING("Array", mongory_type_to_string(value_a));
 }
 
@@ -66,7 +78,9 @@ void test_table_value(void) {
 
   mongory_value *value_t = mongory_value_wrap_t(pool, table);
   TEST_ASSERT_NOT_NULL(value_t);
+#ifndef MONGORY_COMPACT_VALUE
   TEST_ASSERT_EQUAL(pool, value_t->pool);
+#endif
   TEST_ASSERT_EQUAL_STRING("Table", mongory_type_to_string(value_t));
 }
 
@@ -74,19 +88,23 @@ void test_null_value(void) {
   mongory_memory_pool *pool = get_test_pool();
   mongory_value *null_val = mongory_value_wrap_n(pool, NULL);
   TEST_ASSERT_NOT_NULL(null_val);
+#ifndef MONGORY_COMPACT_VALUE
   TEST_ASSERT_EQUAL(pool, null_val->pool);
+#endif
   TEST_ASSERT_EQUAL_STRING("Null", mongory_type_to_string(null_val));
-  TEST_ASSERT_EQUAL(0, null_val->comp(null_val, null_val));
-  TEST_ASSERT_EQUAL(mongory_value_compare_fail, null_val->comp(null_val, mongory_value_wrap_b(pool, true)));
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(null_val, null_val));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(null_val, mongory_value_wrap_b(pool, true)));
 }
 
 void test_unsupported_value(void) {
   mongory_memory_pool *pool = get_test_pool();
   mongory_value *unsupported_val = mongory_value_wrap_u(pool, NULL);
   TEST_ASSERT_NOT_NULL(unsupported_val);
+#ifndef MONGORY_COMPACT_VALUE
   TEST_ASSERT_EQUAL(pool, unsupported_val->pool);
+#endif
   TEST_ASSERT_EQUAL_STRING("Unsupported", mongory_type_to_string(unsupported_val));
-  TEST_ASSERT_EQUAL(mongory_value_compare_fail, unsupported_val->comp(unsupported_val, unsupported_val));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(unsupported_val, unsupported_val));
 }
 
 void test_boolean_comparison(void) {
@@ -96,10 +114,10 @@ void test_boolean_comparison(void) {
   mongory_value *another_true = mongory_value_wrap_b(pool, true);
   mongory_value *int_val = mongory_value_wrap_i(pool, 1);
 
-  TEST_ASSERT_EQUAL(0, true_val->comp(true_val, another_true));
-  TEST_ASSERT_NOT_EQUAL(0, true_val->comp(true_val, false_val));
-  TEST_ASSERT_NOT_EQUAL(0, false_val->comp(false_val, true_val));
-  TEST_ASSERT_EQUAL(mongory_value_compare_fail, true_val->comp(true_val, int_val));
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(true_val, another_true));
+  TEST_ASSERT_NOT_EQUAL(0, mongory_value_compare(true_val, false_val));
+  TEST_ASSERT_NOT_EQUAL(0, mongory_value_compare(false_val, true_val));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(true_val, int_val));
 }
 
 void test_integer_comparison(void) {
@@ -110,11 +128,11 @@ void test_integer_comparison(void) {
   mongory_value *double_val = mongory_value_wrap_d(pool, 1.5);
   mongory_value *bool_val = mongory_value_wrap_b(pool, true);
 
-  TEST_ASSERT_EQUAL(0, val_1->comp(val_1, val_1_again));
-  TEST_ASSERT_EQUAL(-1, val_1->comp(val_1, val_2));
-  TEST_ASSERT_EQUAL(1, val_2->comp(val_2, val_1));
-  TEST_ASSERT_EQUAL(-1, val_1->comp(val_1, double_val));
-  TEST_ASSERT_EQUAL(mongory_value_compare_fail, val_1->comp(val_1, bool_val));
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(val_1, val_1_again));
+  TEST_ASSERT_EQUAL(-1, mongory_value_compare(val_1, val_2));
+  TEST_ASSERT_EQUAL(1, mongory_value_compare(val_2, val_1));
+  TEST_ASSERT_EQUAL(-1, mongory_value_compare(val_1, double_val));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(val_1, bool_val));
 }
 
 void test_double_comparison(void) {
@@ -125,11 +143,11 @@ void test_double_comparison(void) {
   mongory_value *int_val = mongory_value_wrap_i(pool, 1);
   mongory_value *bool_val = mongory_value_wrap_b(pool, true);
 
-  TEST_ASSERT_EQUAL(0, val_1_0->comp(val_1_0, val_1_0_again));
-  TEST_ASSERT_EQUAL(-1, val_1_0->comp(val_1_0, val_1_5));
-  TEST_ASSERT_EQUAL(1, val_1_5->comp(val_1_5, val_1_0));
-  TEST_ASSERT_EQUAL(0, val_1_0->comp(val_1_0, int_val));
-  TEST_ASSERT_EQUAL(mongory_value_compare_fail, val_1_0->comp(val_1_0, bool_val));
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(val_1_0, val_1_0_again));
+  TEST_ASSERT_EQUAL(-1, mongory_value_compare(val_1_0, val_1_5));
+  TEST_ASSERT_EQUAL(1, mongory_value_compare(val_1_5, val_1_0));
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(val_1_0, int_val));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(val_1_0, bool_val));
 }
 
 void test_string_comparison(void) {
@@ -139,10 +157,10 @@ void test_string_comparison(void) {
   mongory_value *str_a_again = mongory_value_wrap_s(pool, "apple");
   mongory_value *int_val = mongory_value_wrap_i(pool, 1);
 
-  TEST_ASSERT_EQUAL(0, str_a->comp(str_a, str_a_again));
-  TEST_ASSERT_EQUAL(-1, str_a->comp(str_a, str_b));
-  TEST_ASSERT_EQUAL(1, str_b->comp(str_b, str_a));
-  TEST_ASSERT_EQUAL(mongory_value_compare_fail, str_a->comp(str_a, int_val));
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(str_a, str_a_again));
+  TEST_ASSERT_EQUAL(-1, mongory_value_compare(str_a, str_b));
+  TEST_ASSERT_EQUAL(1, mongory_value_compare(str_b, str_a));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(str_a, int_val));
 }
 
 void test_array_comparison(void) {
@@ -155,8 +173,8 @@ void test_array_comparison(void) {
   array1->push(array1, mongory_value_wrap_i(pool, 1));
   array2->push(array2, mongory_value_wrap_i(pool, 2));
 
-  TEST_ASSERT_EQUAL(-1, array_val1->comp(array_val1, array_val2));
-  TEST_ASSERT_EQUAL(1, array_val2->comp(array_val2, array_val1));
+  TEST_ASSERT_EQUAL(-1, mongory_value_compare(array_val1, array_val2));
+  TEST_ASSERT_EQUAL(1, mongory_value_compare(array_val2, array_val1));
 }
 
 void test_table_comparison(void) {
@@ -170,8 +188,51 @@ void test_table_comparison(void) {
   table1->set(table1, "a", mongory_value_wrap_i(pool, 1));
   table2->set(table2, "a", mongory_value_wrap_i(pool, 2));
 
-  TEST_ASSERT_EQUAL(mongory_value_compare_fail, table_val1->comp(table_val1, table_val2));
-  TEST_ASSERT_EQUAL(mongory_value_compare_fail, table_val2->comp(table_val2, table_val1));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(table_val1, table_val2));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(table_val2, table_val1));
+
+  // Tables with the same pairs are equal whatever their insertion order.
+  mongory_value *doc1 = json_string_to_mongory_value(pool, "{\"a\": 1, \"b\": {\"c\": [1, \"x\"]}, \"d\": null}");
+  mongory_value *doc2 = json_string_to_mongory_value(pool, "{\"d\": null, \"b\": {\"c\": [1.0, \"x\"]}, \"a\": 1}");
+  mongory_value *doc3 = json_string_to_mongory_value(pool, "{\"a\": 1, \"b\": {\"c\": [1, \"y\"]}, \"d\": null}");
+  mongory_value *doc4 = json_string_to_mongory_value(pool, "{\"a\": 1, \"b\": {\"c\": [1, \"x\"]}, \"e\": null}");
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(doc1, doc2));
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(doc2, doc1));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(doc1, doc3));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(doc1, doc4));
+  TEST_ASSERT_TRUE(mongory_value_equal(doc1, doc2));
+  TEST_ASSERT_FALSE(mongory_value_equal(doc1, table_val1));
+
+  // A NULL stored under a key does not stand for a key the other table lacks.
+  mongory_table *holds_null = mongory_table_new(pool);
+  mongory_table *other_key = mongory_table_new(pool);
+  mongory_table *same_null = mongory_table_new(pool);
+  holds_null->set(holds_null, "x", NULL);
+  other_key->set(other_key, "y", mongory_value_wrap_i(pool, 5));
+  same_null->set(same_null, "x", NULL);
+  mongory_value *holds_null_val = mongory_value_wrap_t(pool, holds_null);
+  mongory_value *other_key_val = mongory_value_wrap_t(pool, other_key);
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(holds_null_val, other_key_val));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(other_key_val, holds_null_val));
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(holds_null_val, mongory_value_wrap_t(pool, same_null)));
+}
+
+void test_value_hash(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  TEST_ASSERT_TRUE(mongory_value_hash(mongory_value_wrap_i(pool, 1)) == mongory_value_hash(mongory_value_wrap_d(pool, 1.0)));
+  TEST_ASSERT_TRUE(mongory_value_hash(mongory_value_wrap_d(pool, 0.0)) == mongory_value_hash(mongory_value_wrap_d(pool, -0.0)));
+  TEST_ASSERT_TRUE(mongory_value_hash(mongory_value_wrap_i(pool, 1)) != mongory_value_hash(mongory_value_wrap_i(pool, 2)));
+  TEST_ASSERT_TRUE(mongory_value_hash(mongory_value_wrap_s(pool, "ab")) ==
+                   mongory_value_hash(mongory_value_wrap_sn(pool, "abc", 2)));
+  TEST_ASSERT_TRUE(mongory_value_hash(NULL) == mongory_value_hash(mongory_value_wrap_n(pool, NULL)));
+
+  mongory_value *doc1 = json_string_to_mongory_value(pool, "{\"a\": 1, \"b\": [true, \"x\", {\"c\": null}]}");
+  mongory_value *doc2 = json_string_to_mongory_value(pool, "{\"b\": [true, \"x\", {\"c\": null}], \"a\": 1.0}");
+  mongory_value *doc3 = json_string_to_mongory_value(pool, "{\"a\": 1, \"b\": [\"x\", true, {\"c\": null}]}");
+  mongory_value *doc4 = json_string_to_mongory_value(pool, "{\"b\": 1, \"a\": [true, \"x\", {\"c\": null}]}");
+  TEST_ASSERT_TRUE(mongory_value_hash(doc1) == mongory_value_hash(doc2));
+  TEST_ASSERT_TRUE(mongory_value_hash(doc1) != mongory_value_hash(doc3)); // Array order matters.
+  TEST_ASSERT_TRUE(mongory_value_hash(doc1) != mongory_value_hash(doc4)); // Keys stay bound to their values.
 }
 
 void test_json_to_value_string(void) {
@@ -233,12 +294,125 @@ void test_value_stringify(void) {
   table->set(table, "courses", mongory_value_wrap_a(pool, array));
 
   mongory_value *value = mongory_value_wrap_t(pool, table);
-  char *value_str = value->to_str(value, pool);
+  char *value_str = mongory_value_to_str(value, pool);
 
-  const char *expected = "{\"age\":30,\"isStudent\":false,\"name\":\"John\",\"courses\":[1,\"two\",true]}";
+  // Pairs are printed in the table's slot order, which is insertion order for
+  // small tables.
+  const char *expected = "{\"name\":\"John\",\"age\":30,\"isStudent\":false,\"courses\":[1,\"two\",true]}";
   TEST_ASSERT_EQUAL_STRING(expected, value_str);
 }
 
+void test_length_prefixed_strings(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  char buffer[] = "status:active";
+  mongory_value *borrowed = mongory_value_wrap_s_borrowed(pool, buffer + 7, 6);
+  TEST_ASSERT_EQUAL_PTR(buffer + 7, borrowed->data.s);
+  TEST_ASSERT_EQUAL(6, borrowed->len);
+
+  mongory_value *copied = mongory_value_wrap_s(pool, "active");
+  TEST_ASSERT_TRUE(copied->data.s != buffer + 7);
+  TEST_ASSERT_EQUAL(6, copied->len);
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(borrowed, copied));
+  TEST_ASSERT_TRUE(mongory_value_equal(borrowed, copied));
+
+  // Lengths make the representation binary-safe.
+  mongory_value *with_nul = mongory_value_wrap_sn(pool, "ab\0c", 4);
+  mongory_value *prefix = mongory_value_wrap_sn(pool, "ab\0d", 3);
+  TEST_ASSERT_EQUAL(4, with_nul->len);
+  TEST_ASSERT_EQUAL('\0', with_nul->data.s[4]);
+  TEST_ASSERT_EQUAL(1, mongory_value_compare(with_nul, prefix));
+  TEST_ASSERT_EQUAL(-1, mongory_value_compare(prefix, with_nul));
+  TEST_ASSERT_FALSE(mongory_value_equal(with_nul, prefix));
+  TEST_ASSERT_EQUAL(-1, mongory_value_compare(mongory_value_wrap_s(pool, "ab"), mongory_value_wrap_s(pool, "abc")));
+
+  mongory_value *null_string = mongory_value_wrap_s(pool, NULL);
+  TEST_ASSERT_NULL(null_string->data.s);
+  TEST_ASSERT_FALSE(mongory_value_equal(null_string, null_string));
+  TEST_ASSERT_FALSE(mongory_value_equal(copied, mongory_value_wrap_i(pool, 6)));
+}
+
+void test_shared_values(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  TEST_ASSERT_EQUAL_PTR(mongory_value_wrap_n_shared(pool, NULL), mongory_value_wrap_n_shared(NULL, NULL));
+  TEST_ASSERT_EQUAL(MONGORY_TYPE_NULL, mongory_value_wrap_n_shared(pool, NULL)->type);
+  TEST_ASSERT_TRUE(mongory_value_wrap_b_shared(pool, true)->data.b);
+  TEST_ASSERT_FALSE(mongory_value_wrap_b_shared(pool, false)->data.b);
+  TEST_ASSERT_EQUAL_PTR(mongory_value_wrap_b_shared(pool, true), mongory_value_wrap_b_shared(NULL, true));
+
+  for (int64_t i = MONGORY_SHARED_INT_MIN; i <= MONGORY_SHARED_INT_MAX; i++) {
+    mongory_value *value = mongory_value_wrap_i_shared(NULL, i);
+    TEST_ASSERT_NOT_NULL(value);
+    TEST_ASSERT_EQUAL(MONGORY_TYPE_INT, value->type);
+    TEST_ASSERT_EQUAL(i, value->data.i);
+  }
+  TEST_ASSERT_EQUAL_PTR(mongory_value_wrap_i_shared(pool, 7), mongory_value_wrap_i_shared(pool, 7));
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(mongory_value_wrap_i_shared(pool, 7), mongory_value_wrap_d(pool, 7.0)));
+  TEST_ASSERT_EQUAL_STRING("-128", mongory_value_to_str(mongory_value_wrap_i_shared(pool, -128), pool));
+
+  // Ints out of range come from the pool.
+  TEST_ASSERT_NULL(mongory_value_wrap_i_shared(NULL, MONGORY_SHARED_INT_MAX + 1));
+  mongory_value *large = mongory_value_wrap_i_shared(pool, 100000);
+  TEST_ASSERT_EQUAL(100000, large->data.i);
+  TEST_ASSERT_TRUE(large != mongory_value_wrap_i_shared(pool, 100000));
+}
+
+void test_datetime_and_binary_values(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *epoch = mongory_value_wrap_datetime(pool, 0);
+  mongory_value *later = mongory_value_wrap_datetime(pool, 1700000000123456789LL);
+  TEST_ASSERT_EQUAL_STRING("Datetime", mongory_type_to_string(epoch));
+  TEST_ASSERT_EQUAL(-1, mongory_value_compare(epoch, later));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_compare(epoch, mongory_value_wrap_i(pool, 0)));
+  TEST_ASSERT_EQUAL_STRING("\"1970-01-01T00:00:00Z\"", mongory_value_to_str(epoch, pool));
+  TEST_ASSERT_EQUAL_STRING("\"2023-11-14T22:13:20.123456789Z\"", mongory_value_to_str(later, pool));
+  TEST_ASSERT_EQUAL_STRING("\"1969-12-31T23:59:59.999999999Z\"",
+                           mongory_value_to_str(mongory_value_wrap_datetime(pool, -1), pool));
+
+  mongory_value *id = json_string_to_mongory_value(pool, "{\"$oid\": \"650f1c2ab3d4e5f607182930\"}");
+  TEST_ASSERT_EQUAL(MONGORY_TYPE_BINARY, id->type);
+  TEST_ASSERT_EQUAL(12, id->len);
+  TEST_ASSERT_EQUAL_STRING("\"650f1c2ab3d4e5f607182930\"", mongory_value_to_str(id, pool));
+  mongory_value *same = mongory_value_wrap_binary(pool, id->data.bin, id->len);
+  mongory_value *shorter = mongory_value_wrap_binary(pool, id->data.bin, 4);
+  TEST_ASSERT_TRUE(mongory_value_equal(id, same));
+  TEST_ASSERT_EQUAL(mongory_value_hash(id), mongory_value_hash(same));
+  TEST_ASSERT_EQUAL(1, mongory_value_compare(id, shorter)); // Shorter binaries sort first.
+  TEST_ASSERT_FALSE(mongory_value_equal(id, mongory_value_wrap_sn(pool, (char *)id->data.bin, id->len)));
+
+  mongory_value *date = json_string_to_mongory_value(pool, "{\"$date\": 1500}");
+  TEST_ASSERT_EQUAL(MONGORY_TYPE_DATETIME, date->type);
+  TEST_ASSERT_EQUAL(1500000000LL, date->data.i);
+}
+
+#ifndef MONGORY_COMPACT_VALUE
+static int always_equal(mongory_value *a, mongory_value *b) {
+  (void)a;
+  (void)b;
+  return 0;
+}
+#endif
+
+void test_value_type_dispatch(void) {
+  mongory_memory_pool *pool = get_test_pool();
+  mongory_value *one = mongory_value_wrap_i(pool, 1);
+  mongory_value *one_and_half = mongory_value_wrap_d(pool, 1.5);
+  TEST_ASSERT_EQUAL(-1, mongory_value_type_compare(one, one_and_half));
+  TEST_ASSERT_EQUAL(1, mongory_value_type_compare(one_and_half, one));
+  TEST_ASSERT_EQUAL(mongory_value_compare_fail, mongory_value_type_compare(one, mongory_value_wrap_s(pool, "1")));
+  TEST_ASSERT_EQUAL_STRING("1.5", mongory_value_type_to_str(one_and_half, pool));
+  TEST_ASSERT_EQUAL_STRING("null", mongory_value_to_str(mongory_value_wrap_n(pool, NULL), pool));
+
+#ifdef MONGORY_COMPACT_VALUE
+  TEST_ASSERT_EQUAL(16, sizeof(mongory_value));
+#else
+  // A bridge may override `comp`; only the type's built-in comparison ignores it.
+  mongory_value *bridged = mongory_value_wrap_i(pool, 2);
+  bridged->comp = always_equal;
+  TEST_ASSERT_EQUAL(0, mongory_value_compare(bridged, one));
+  TEST_ASSERT_EQUAL(1, mongory_value_type_compare(bridged, one));
+#endif
+}
+
 int main(void) {
   UNITY_BEGIN();
   RUN_TEST(test_boolean_value);
@@ -253,6 +427,7 @@ int main(void) {
   RUN_TEST(test_string_comparison);
   RUN_TEST(test_array_comparison);
   RUN_TEST(test_table_comparison);
+  RUN_TEST(test_value_hash);
   RUN_TEST(test_null_value);
   RUN_TEST(test_unsupported_value);
   RUN_TEST(test_json_to_value_string);
@@ -260,5 +435,9 @@ int main(void) {
   RUN_TEST(test_json_to_value_array);
   RUN_TEST(test_json_to_value_object);
   RUN_TEST(test_value_stringify);
+  RUN_TEST(test_datetime_and_binary_values);
+  RUN_TEST(test_value_type_dispatch);
+  RUN_TEST(test_length_prefixed_strings);
+  RUN_TEST(test_shared_values);
   return UNITY_END();
 }